@@ -0,0 +1,90 @@
+"""
+Batched remote commands for faculty units, with results matched by correlation ID.
+
+The unit (faculty-unit/comms/command_rpc.cpp) runs every command in a batch in
+order and publishes one response on the result topic:
+
+    -> consultease/faculty/<id>/commands
+       {"batch_id": "b1", "commands": [{"id": "c1", "command": "set_status", "status": "busy"}]}
+    <- consultease/faculty/<id>/commands/result
+       {"batch_id": "b1", "results": [{"id": "c1", "ok": true, "status": "busy"}]}
+
+COMMAND_BATCH_MAX must match the firmware; extra commands are not run, and the
+response then carries "error": "batch_limit" and "skipped": <count>.
+"""
+
+import itertools
+import json
+import threading
+
+COMMAND_TOPIC_TEMPLATE = "consultease/faculty/{}/commands"
+RESULT_TOPIC_TEMPLATE = "consultease/faculty/{}/commands/result"
+RESULT_TOPIC_FILTER = "consultease/faculty/+/commands/result"
+COMMAND_BATCH_MAX = 8
+
+
+class CommandBatcher:
+    """
+    Builds command batches and matches the unit's responses to them.
+
+    Call send() with a publish function (e.g. MQTTClient.publish) and feed every
+    message from RESULT_TOPIC_FILTER to handle_result(). The callback given to send()
+    receives {command_id: result_dict}; a command the unit never answered is missing.
+    """
+
+    def __init__(self):
+        self._ids = itertools.count(1)
+        self._pending = {}  # batch_id -> (command ids, callback)
+        self._lock = threading.Lock()
+
+    def send(self, publish, faculty_id, commands, callback=None):
+        """
+        Sends up to COMMAND_BATCH_MAX commands as one message.
+
+        Args:
+            publish: Function (topic, payload) that publishes with QoS 1.
+            faculty_id (str): Target unit.
+            commands (list): Dicts with a "command" key plus its arguments; an "id" is
+                added to each one that lacks it.
+        Returns:
+            str: The batch ID.
+        """
+        if len(commands) > COMMAND_BATCH_MAX:
+            raise ValueError(f"At most {COMMAND_BATCH_MAX} commands per batch")
+        batch_id = f"b{next(self._ids)}"
+        batch = []
+        for index, command in enumerate(commands):
+            entry = dict(command)
+            entry.setdefault("id", f"{batch_id}.{index}")
+            batch.append(entry)
+        with self._lock:
+            self._pending[batch_id] = ([entry["id"] for entry in batch], callback)
+        publish(COMMAND_TOPIC_TEMPLATE.format(faculty_id),
+                json.dumps({"batch_id": batch_id, "commands": batch}, separators=(",", ":")))
+        return batch_id
+
+    def handle_result(self, payload):
+        """
+        Matches a result message to its batch and runs the batch's callback.
+
+        Returns:
+            dict: {command_id: result} for a known batch, otherwise None.
+        """
+        try:
+            message = json.loads(payload)
+        except (TypeError, ValueError):
+            return None
+        with self._lock:
+            pending = self._pending.pop(message.get("batch_id"), None)
+        if pending is None:
+            return None
+        _, callback = pending
+        results = {result.get("id"): result for result in message.get("results", [])}
+        if callback is not None:
+            callback(results)
+        return results
+
+    def pending_batches(self):
+        """Batch IDs still waiting for a response."""
+        with self._lock:
+            return list(self._pending)
@@ -0,0 +1,105 @@
+"""
+Minimal heatshrink-compatible LZSS codec for request payloads.
+
+The faculty unit decodes this format (comms/compressed_text.cpp) directly from
+base64, so the window/lookahead sizes below must match HEATSHRINK_WINDOW_BITS
+and HEATSHRINK_LOOKAHEAD_BITS in faculty-unit/config/config.h.
+
+Stream layout (MSB-first bits, zero padded to a whole byte):
+    1 + 8-bit literal
+    0 + (offset - 1) in WINDOW_BITS + (count - 1) in LOOKAHEAD_BITS
+"""
+
+import base64
+
+WINDOW_BITS = 8
+LOOKAHEAD_BITS = 4
+
+# Field name and capability tag used on the wire
+CODEC_TAG = f"hs{WINDOW_BITS}.{LOOKAHEAD_BITS}"
+COMPRESSED_TEXT_FIELD = "request_text_hs"
+
+
+class _BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.acc = 0
+        self.nbits = 0
+
+    def write(self, value, count):
+        self.acc = (self.acc << count) | (value & ((1 << count) - 1))
+        self.nbits += count
+        while self.nbits >= 8:
+            self.nbits -= 8
+            self.out.append((self.acc >> self.nbits) & 0xFF)
+        self.acc &= (1 << self.nbits) - 1
+
+    def finish(self):
+        if self.nbits:
+            self.out.append((self.acc << (8 - self.nbits)) & 0xFF)
+            self.nbits = 0
+            self.acc = 0
+        return bytes(self.out)
+
+
+def encode(data: bytes, window_bits=WINDOW_BITS, lookahead_bits=LOOKAHEAD_BITS) -> bytes:
+    """Greedy LZSS encode. Back-references are only used when shorter than literals."""
+    window = 1 << window_bits
+    max_len = 1 << lookahead_bits
+    # A back-reference costs 1 + W + L bits, a literal 9 bits
+    min_len = (1 + window_bits + lookahead_bits) // 9 + 1
+
+    writer = _BitWriter()
+    pos = 0
+    while pos < len(data):
+        best_len, best_off = 0, 0
+        for start in range(max(0, pos - window), pos):
+            length = 0
+            while (length < max_len and pos + length < len(data)
+                   and data[start + length] == data[pos + length]):
+                length += 1
+            if length > best_len:
+                best_len, best_off = length, pos - start
+        if best_len >= min_len:
+            writer.write(0, 1)
+            writer.write(best_off - 1, window_bits)
+            writer.write(best_len - 1, lookahead_bits)
+            pos += best_len
+        else:
+            writer.write(1, 1)
+            writer.write(data[pos], 8)
+            pos += 1
+    return writer.finish()
+
+
+def decode(stream: bytes, window_bits=WINDOW_BITS, lookahead_bits=LOOKAHEAD_BITS) -> bytes:
+    """Reference decoder, mirrors the firmware implementation."""
+    bits = "".join(f"{b:08b}" for b in stream)
+    out = bytearray()
+    i = 0
+    while i < len(bits):
+        if bits[i] == "1":
+            if i + 9 > len(bits):
+                break
+            out.append(int(bits[i + 1:i + 9], 2))
+            i += 9
+        else:
+            end = i + 1 + window_bits + lookahead_bits
+            if end > len(bits):
+                break
+            offset = int(bits[i + 1:i + 1 + window_bits], 2) + 1
+            count = int(bits[i + 1 + window_bits:end], 2) + 1
+            for _ in range(count):
+                out.append(out[-offset])
+            i = end
+    return bytes(out)
+
+
+def compress_text(text: str):
+    """
+    Returns the base64 heatshrink encoding of text, or None if it would not be
+    smaller than sending the text as-is (short texts rarely benefit).
+    """
+    raw = text.encode("utf-8")
+    packed = base64.b64encode(encode(raw)).decode("ascii")
+    return packed if len(packed) < len(raw) else None
@@ -0,0 +1,183 @@
+"""
+Server-side text rasterization for faculty units.
+
+The unit's built-in font only covers ASCII, and shaping Arabic, Devanagari or CJK
+on the ESP32 would need large fonts and a shaping engine. For units that advertise
+CODEC_TAG, the request text is rendered here with Pillow and sent as a small
+run-length coded bitmap that the unit streams straight into the panel
+(faculty-unit/display/text_bitmap.cpp).
+
+Bitmap layout (BITMAP_FIELD, base64):
+    1 byte bits per pixel (1 or 2), width and height as little-endian uint16,
+    then run bytes in row-major order: the level in the top `bpp` bits and
+    (length - 1) in the rest. Runs may continue onto the next row.
+
+MAX_BYTES, WIDTH and MAX_HEIGHT must match REQUEST_BITMAP_MAX_BYTES, SCREEN_WIDTH and
+the area below REQUEST_TEXT_Y in faculty-unit/config/config.h.
+
+Complex scripts are only shaped correctly when Pillow is built with libraqm.
+
+Usage (payload size and host decode time for a sample text):
+    python text_raster.py --font NotoSansArabic-Regular.ttf "..."
+"""
+
+import base64
+import json
+import os
+import struct
+import time
+
+CODEC_TAG = "rle2"
+BITMAP_FIELD = "request_text_bitmap"
+
+WIDTH = 240
+MAX_HEIGHT = 320 - 40
+MAX_BYTES = 576
+HEADER = struct.Struct("<BHH")
+
+FONT_PATH = os.environ.get("CONSULTEASE_RASTER_FONT", "NotoSans-Regular.ttf")
+FONT_SIZE = 16
+LINE_SPACING = 4
+
+
+def needs_raster(text):
+    """True if the unit's built-in font cannot draw the text."""
+    return any(ord(c) > 126 for c in text)
+
+
+def encode(pixels, width, height, bpp):
+    """
+    Run-length codes a bitmap.
+
+    Args:
+        pixels: Flat sequence of levels (0 .. 2**bpp - 1), row-major, width * height long.
+    Returns:
+        bytes: Header plus runs.
+    """
+    shift = 8 - bpp
+    max_run = 1 << shift
+    out = bytearray(HEADER.pack(bpp, width, height))
+    i, total = 0, width * height
+    while i < total:
+        level = pixels[i]
+        n = 1
+        while i + n < total and n < max_run and pixels[i + n] == level:
+            n += 1
+        out.append((level << shift) | (n - 1))
+        i += n
+    return bytes(out)
+
+
+def decode(data):
+    """Inverse of encode(); returns (pixels, width, height, bpp). Used to check the unit's view."""
+    bpp, width, height = HEADER.unpack_from(data)
+    shift = 8 - bpp
+    pixels = []
+    for b in data[HEADER.size:]:
+        pixels.extend([b >> shift] * ((b & ((1 << shift) - 1)) + 1))
+    if len(pixels) != width * height:
+        raise ValueError("Run total does not match the bitmap size")
+    return pixels, width, height, bpp
+
+
+def _wrap(text, font, width):
+    """Greedy line breaking by measured width; breaks inside words when there are no spaces (CJK)."""
+    lines = []
+    for paragraph in text.split("\n"):
+        line = ""
+        for token in paragraph.split(" ") if " " in paragraph else list(paragraph):
+            joiner = " " if line and " " in paragraph else ""
+            candidate = line + joiner + token
+            if line and font.getlength(candidate) > width:
+                lines.append(line)
+                line = token
+            else:
+                line = candidate
+        lines.append(line)
+    return lines
+
+
+def rasterize(text, bpp=2, font_path=FONT_PATH, font_size=FONT_SIZE, width=WIDTH):
+    """
+    Renders wrapped text white on black and quantizes it to 2**bpp grey levels.
+
+    Returns:
+        tuple: (pixels, width, height), cropped to the last inked row.
+    Raises:
+        ValueError: If the wrapped text is taller than MAX_HEIGHT.
+    """
+    from PIL import Image, ImageDraw, ImageFont, features
+
+    layout = ImageFont.Layout.RAQM if features.check_feature("raqm") else ImageFont.Layout.BASIC
+    font = ImageFont.truetype(font_path, font_size, layout_engine=layout)
+    ascent, descent = font.getmetrics()
+    line_height = ascent + descent + LINE_SPACING
+
+    lines = _wrap(text, font, width)
+    height = line_height * len(lines)
+    if height > MAX_HEIGHT:
+        raise ValueError("Text does not fit the request area")
+    image = Image.new("L", (width, height), 0)
+    draw = ImageDraw.Draw(image)
+    for row, line in enumerate(lines):
+        # Right-to-left scripts are aligned to the right edge
+        direction = "rtl" if layout == ImageFont.Layout.RAQM and _is_rtl(line) else None
+        x = width - font.getlength(line, direction=direction) if direction else 0
+        draw.text((x, row * line_height), line, fill=255, font=font, direction=direction)
+
+    bbox = image.getbbox()
+    height = bbox[3] if bbox else 1
+    image = image.crop((0, 0, width, height))
+    top = (1 << bpp) - 1
+    pixels = [(value * top + 127) // 255 for value in image.getdata()]
+    return pixels, width, height
+
+
+def _is_rtl(line):
+    return any("\u0590" <= c <= "\u08ff" for c in line)  # Hebrew, Arabic, Syriac, Thaana, N'Ko
+
+
+def rasterize_text(text, **kwargs):
+    """
+    Rasterized, encoded and base64-wrapped text for BITMAP_FIELD.
+
+    Tries 2 bits per pixel (antialiased) first, then 1 bit if that is too large.
+
+    Returns:
+        str: The base64 bitmap, or None if it would not fit MAX_BYTES or Pillow/the font is missing.
+    """
+    for bpp in (2, 1):
+        try:
+            pixels, width, height = rasterize(text, bpp=bpp, **kwargs)
+        except (ImportError, OSError, ValueError):
+            return None
+        data = encode(pixels, width, height, bpp)
+        if len(data) <= MAX_BYTES:
+            return base64.b64encode(data).decode("ascii")
+    return None
+
+
+def main():
+    import argparse
+
+    parser = argparse.ArgumentParser(description="Compare rasterized and plain request text payloads.")
+    parser.add_argument("text", help="Request text")
+    parser.add_argument("--font", default=FONT_PATH, help="TrueType/OpenType font covering the script")
+    parser.add_argument("--size", type=int, default=FONT_SIZE, help="Font size in pixels")
+    args = parser.parse_args()
+
+    plain = len(json.dumps(args.text).encode("utf-8"))
+    print(f"request_text JSON: {plain} bytes ({len(args.text.encode('utf-8'))} bytes UTF-8)")
+    for bpp in (1, 2):
+        pixels, width, height = rasterize(args.text, bpp=bpp, font_path=args.font, font_size=args.size)
+        data = encode(pixels, width, height, bpp)
+        start = time.perf_counter()
+        assert decode(data)[0] == pixels
+        decode_us = (time.perf_counter() - start) * 1e6
+        fits = "fits" if len(data) <= MAX_BYTES else "too large"
+        print(f"{bpp}-bit {width}x{height}: {len(data)} bytes, {len(base64.b64encode(data))} as base64 "
+              f"({fits}), raw {width * height * bpp // 8} bytes, host decode {decode_us:.0f} us")
+
+
+if __name__ == "__main__":
+    main()
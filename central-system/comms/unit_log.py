@@ -0,0 +1,123 @@
+"""
+Decoding and collection of the log frames faculty units stream over MQTT.
+
+Units batch their sampled log records (faculty-unit/core/unit_log.cpp) into text
+frames on consultease/faculty/<id>/log:
+
+    1 9c0ffee1 120 84211          <version> <boot id hex> <first seq> <base ms>
+    0 I 5a1f03c2 0 MQTT connected  <ms - base> <D|I|W|E> <site hex> <suppressed> <text>
+    15 W 0b7e44d9 19 Request inbox full, dropping request.
+
+Records in a frame have consecutive sequence numbers. A unit keeps unsent records
+while disconnected and backfills them after reconnecting; records it had to
+overwrite show up as a gap in the sequence. "suppressed" is the number of calls
+from the same call site skipped by sampling since its previous record.
+"""
+
+import logging
+from dataclasses import dataclass
+
+LOG_TOPIC_FILTER = "consultease/faculty/+/log"
+FRAME_VERSION = 1
+
+LEVELS = {"D": logging.DEBUG, "I": logging.INFO, "W": logging.WARNING, "E": logging.ERROR}
+
+
+@dataclass
+class LogRecord:
+    seq: int
+    uptime_ms: int
+    level: int
+    site: str
+    suppressed: int
+    text: str
+
+
+def parse_frame(payload):
+    """
+    Parses one frame.
+
+    Returns:
+        tuple: (boot_id, records), or None if the frame is malformed or of another version.
+    """
+    if isinstance(payload, bytes):
+        payload = payload.decode("utf-8", errors="replace")
+    lines = payload.split("\n")
+    header = lines[0].split(" ")
+    if len(header) != 4 or header[0] != str(FRAME_VERSION):
+        return None
+    try:
+        boot_id, first_seq, base_ms = header[1], int(header[2]), int(header[3])
+        records = []
+        for index, line in enumerate(lines[1:]):
+            offset, level, site, suppressed, text = (line.split(" ", 4) + [""])[:5]
+            records.append(LogRecord(first_seq + index, base_ms + int(offset), LEVELS.get(level, logging.INFO),
+                                     site, int(suppressed), text))
+    except ValueError:
+        return None
+    return boot_id, records
+
+
+class LogCollector:
+    """
+    Tracks each unit's sequence numbers across frames to count records lost to
+    ring overflow and to drop duplicates. A new boot ID restarts the sequence.
+    """
+
+    def __init__(self):
+        self._units = {}  # faculty_id -> [boot_id, next expected seq]
+        self.lost = {}    # faculty_id -> records lost in total
+
+    def handle_frame(self, faculty_id, payload):
+        """
+        Returns:
+            list: New records from the frame, in order ([] for a malformed or repeated frame).
+        """
+        parsed = parse_frame(payload)
+        if parsed is None:
+            return []
+        boot_id, records = parsed
+        if not records:
+            return []
+        unit = self._units.get(faculty_id)
+        if unit is None or unit[0] != boot_id:
+            # First frame seen from this boot: anything before it was lost (or sent before we subscribed)
+            unit = self._units[faculty_id] = [boot_id, records[0].seq]
+        gap = records[0].seq - unit[1]
+        if gap > 0:
+            self.lost[faculty_id] = self.lost.get(faculty_id, 0) + gap
+        fresh = [record for record in records if record.seq >= unit[1]]
+        unit[1] = max(unit[1], records[-1].seq + 1)
+        return fresh
+
+
+def main():
+    import argparse
+    import paho.mqtt.client as mqtt
+
+    parser = argparse.ArgumentParser(description="Print the log records streamed by faculty units.")
+    parser.add_argument("--broker", default="localhost", help="MQTT broker address")
+    parser.add_argument("--port", type=int, default=1883, help="MQTT broker port")
+    parser.add_argument("--faculty", default="+", help="Faculty ID to follow (default: all)")
+    args = parser.parse_args()
+
+    logging.basicConfig(level=logging.DEBUG, format='%(message)s')
+    collector = LogCollector()
+
+    def on_message(client, userdata, msg):
+        faculty_id = msg.topic.split("/")[2]
+        for record in collector.handle_frame(faculty_id, msg.payload):
+            suppressed = f" (+{record.suppressed} suppressed)" if record.suppressed else ""
+            logging.log(record.level, f"{faculty_id} {record.uptime_ms / 1000:10.3f} {record.text}{suppressed}")
+        if collector.lost.get(faculty_id):
+            logging.warning(f"{faculty_id}: {collector.lost[faculty_id]} records lost so far")
+
+    client = mqtt.Client(protocol=mqtt.MQTTv311)
+    client.on_message = on_message
+    client.connect(args.broker, args.port, 60)
+    client.subscribe(LOG_TOPIC_FILTER.replace("+", args.faculty), qos=0)
+    client.loop_forever()
+
+
+if __name__ == "__main__":
+    main()
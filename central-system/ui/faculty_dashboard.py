@@ -35,9 +35,28 @@ except ImportError:
     MQTTClient = None # Allow running without MQTT for testing UI
     logging.warning("Could not import MQTTClient.") # Use logging directly
 
+try:
+    from central_system.comms import heatshrink
+except ImportError:
+    heatshrink = None # Requests are sent uncompressed
+    logging.warning("Could not import heatshrink codec.")
+
+try:
+    from central_system.comms import text_raster
+except ImportError:
+    text_raster = None # Non-ASCII text is sent as text
+    logging.warning("Could not import text rasterizer.")
+
 # Define the MQTT topic structure (as derived from config.h concept)
 MQTT_STATUS_TOPIC_TEMPLATE = "consultease/faculty/{}/status"
 MQTT_REQUEST_TOPIC = "consultease/requests/new" # Topic for new requests
+MQTT_CAPACITY_TOPIC_TEMPLATE = "consultease/faculty/{}/capacity" # Inbox capacity/credit records from units
+MQTT_CAPABILITIES_TOPIC_TEMPLATE = "consultease/faculty/{}/capabilities" # Supported payload codecs per unit
+
+# Request priorities understood by the faculty unit inbox (higher is shown first)
+REQUEST_PRIORITY_WALK_IN = 0
+REQUEST_PRIORITY_APPOINTMENT = 1
+REQUEST_PRIORITY_URGENT = 2
 
 logger = logging.getLogger(__name__)
 
@@ -196,6 +215,11 @@ class FacultyDashboard(QWidget):
         # self.faculty_status = {} # No longer needed, model holds the data
         self.student_id = student_id if student_id else "UNKNOWN_STUDENT_ID" # Store the passed student ID, with a fallback
         self.MAX_NOTIFICATIONS = 50
+        # Request credits per faculty unit (free inbox slots from the last capacity record).
+        # Decremented locally on each publish so we never send more than the unit can hold.
+        self.faculty_credits = {}
+        # Payload codecs each faculty unit advertises (e.g. "hs8.4" for heatshrink request text)
+        self.faculty_codecs = {}
 
         self.setWindowTitle("Faculty Dashboard")
 
@@ -446,6 +470,12 @@ class FacultyDashboard(QWidget):
                            status_topic = MQTT_STATUS_TOPIC_TEMPLATE.format(faculty_id)
                            self.mqtt_client.subscribe(status_topic)
                            logger.debug(f"Subscribed to {status_topic}")
+                           capacity_topic = MQTT_CAPACITY_TOPIC_TEMPLATE.format(faculty_id)
+                           self.mqtt_client.subscribe(capacity_topic)
+                           logger.debug(f"Subscribed to {capacity_topic}")
+                           capabilities_topic = MQTT_CAPABILITIES_TOPIC_TEMPLATE.format(faculty_id)
+                           self.mqtt_client.subscribe(capabilities_topic)
+                           logger.debug(f"Subscribed to {capabilities_topic}")
                       except Exception as e:
                            logger.error(f"Error subscribing to topic {status_topic}: {e}")
 
@@ -466,6 +496,19 @@ class FacultyDashboard(QWidget):
         """Handle incoming MQTT messages, updating the FacultyTableModel."""
         logger.debug(f"MQTT message received: Topic='{topic}', Payload='{payload}'")
 
+        capacity_match = re.match(r"consultease/faculty/([^/]+)/capacity$", topic)
+        if capacity_match:
+            self._handle_capacity_record(capacity_match.group(1), payload)
+            return
+
+        capabilities_match = re.match(r"consultease/faculty/([^/]+)/capabilities$", topic)
+        if capabilities_match:
+            try:
+                self.faculty_codecs[capabilities_match.group(1)] = set(json.loads(payload).get("codecs", []))
+            except (ValueError, AttributeError) as e:
+                logger.warning(f"Ignoring malformed capabilities record from {capabilities_match.group(1)}: {e}")
+            return
+
         match = re.match(r"consultease/faculty/([^/]+)/status", topic)
         if match:
             faculty_id = match.group(1)
@@ -487,6 +530,16 @@ class FacultyDashboard(QWidget):
             # else: # Warning already logged by update_status
             #     logger.warning(f"Received status update for unknown/unmapped faculty ID: {faculty_id}")
 
+    def _handle_capacity_record(self, faculty_id: str, payload: str):
+        """Refresh the request credits for a faculty unit from its capacity record."""
+        try:
+            record = json.loads(payload)
+            self.faculty_credits[faculty_id] = int(record["free"])
+            logger.debug(f"Faculty {faculty_id} capacity: free={record['free']} "
+                         f"depth={record.get('depth')} lag_ms={record.get('lag_ms')}")
+        except (ValueError, KeyError, TypeError) as e:
+            logger.warning(f"Ignoring malformed capacity record from {faculty_id}: {e}")
+
     def add_notification(self, message: str):
         """Adds a timestamped notification message to the list."""
         timestamp = datetime.now().strftime("%H:%M:%S")
@@ -540,6 +593,14 @@ class FacultyDashboard(QWidget):
              logger.error(f"Selected faculty data missing ID at source row: {source_row}")
              return
 
+        # Honour the unit's credits: if its inbox is full, ask the student to retry later
+        # instead of publishing a request the unit would have to drop.
+        if self.faculty_credits.get(selected_faculty_id, 1) <= 0:
+            QMessageBox.warning(self, "Faculty Busy",
+                                f"{selected_faculty_name} has too many pending requests. Please try again shortly.")
+            logger.info(f"Request for {selected_faculty_id} held back: no inbox credits.")
+            return
+
         logger.info(f"Submitting request for faculty: {selected_faculty_name} (ID: {selected_faculty_id})")
 
         timestamp = datetime.now().isoformat()
@@ -550,6 +611,7 @@ class FacultyDashboard(QWidget):
             "student_id": student_id,
             "faculty_id": selected_faculty_id, # Add faculty ID
             "request_text": request_text,
+            "priority": REQUEST_PRIORITY_WALK_IN,
             "timestamp": timestamp
         }
         firebase_data = {
@@ -560,6 +622,27 @@ class FacultyDashboard(QWidget):
             "status": "pending"
         }
 
+        # The unit's font is ASCII only; render other scripts here for units that accept bitmaps
+        unit_codecs = self.faculty_codecs.get(selected_faculty_id, ())
+        bitmap = None
+        if text_raster and text_raster.CODEC_TAG in unit_codecs and text_raster.needs_raster(request_text):
+            bitmap = text_raster.rasterize_text(request_text)
+            if bitmap is None:
+                logger.warning("Request text could not be rasterized; sending it as text.")
+
+        if bitmap is not None:
+            del mqtt_payload["request_text"]
+            mqtt_payload[text_raster.BITMAP_FIELD] = bitmap
+            logger.debug(f"Rasterized request text: {len(request_text.encode('utf-8'))} UTF-8 bytes "
+                         f"-> {len(bitmap)} base64 chars")
+        # Compress the text for units that advertise the codec, when it actually saves airtime
+        elif heatshrink and heatshrink.CODEC_TAG in unit_codecs:
+            packed_text = heatshrink.compress_text(request_text)
+            if packed_text is not None:
+                del mqtt_payload["request_text"]
+                mqtt_payload[heatshrink.COMPRESSED_TEXT_FIELD] = packed_text
+                logger.debug(f"Compressed request text {len(request_text)} -> {len(packed_text)} chars")
+
         # --- Serialize MQTT Payload ---
         try:
             mqtt_payload_json = json.dumps(mqtt_payload)
@@ -574,7 +657,8 @@ class FacultyDashboard(QWidget):
 
         try:
             logger.info(f"Publishing request to MQTT topic: {MQTT_REQUEST_TOPIC}")
-            publish_result = self.mqtt_client.publish(topic=MQTT_REQUEST_TOPIC, payload=mqtt_payload_json)
+            # QoS 1: the broker queues requests for battery units while they deep-sleep
+            publish_result = self.mqtt_client.publish(topic=MQTT_REQUEST_TOPIC, payload=mqtt_payload_json, qos=1)
             if isinstance(publish_result, tuple) and publish_result[0] == 0:
                  mqtt_success = True
                  logger.info(f"MQTT publish successful (mid={publish_result[1]}).")
@@ -583,6 +667,8 @@ class FacultyDashboard(QWidget):
                  logger.info("MQTT publish successful.")
             else:
                  logger.error(f"MQTT publish failed. Result: {publish_result}")
+            if mqtt_success and selected_faculty_id in self.faculty_credits:
+                 self.faculty_credits[selected_faculty_id] -= 1 # Spend a credit until the next capacity record
         except AttributeError:
              logger.error("MQTT client does not have a 'publish' method.", exc_info=True)
              QMessageBox.critical(self, "Error", "MQTT client is not configured correctly (missing publish method).")
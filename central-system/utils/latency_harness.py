@@ -0,0 +1,420 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+ConsultEase Central System
+End-to-end request latency harness: "student presses submit" to "text drawn on the TFT".
+
+Publishes consultation requests carrying a "trace_id" at a fixed rate. Each faculty
+unit answers every traced request it draws on consultease/faculty/<id>/trace with
+its own stage timings (faculty-unit/comms/mqtt_handler.cpp, publish_request_trace()):
+
+    parse_us   MQTT callback entry to queued in the inbox
+    queue_ms   queued to drawing started (includes REQUEST_MIN_DISPLAY_MS of earlier requests)
+    draw_us    DisplayManager::show_request()
+    total_ms   received to drawn
+
+The harness measures publish -> trace round trip on its own clock and estimates
+end-to-end latency as total_ms plus half of the remaining (network and broker) time.
+Requests go to the shared request topic, so every unit draws every request. Fleet
+size is the number of real units found on the broker plus --host-units and
+--simulated units.
+
+Host units (--host-units) are processes of faculty-unit/tools/host_unit.cpp: the
+firmware's own mqtt_handler.cpp, request inbox, event bus and DisplayManager, built
+for the host with PubSubClient over a TCP socket and the panel drawn into a
+framebuffer. They run the unit's pipeline and config.h (REQUEST_MIN_DISPLAY_MS,
+INBOX_CAPACITY), so fleet behaviour and queueing are the firmware's; parse_us and
+draw_us are the host CPU's, and there is no Wi-Fi or SPI in them.
+
+Simulated units are Python models of the inbox and display dwell (SimulatedUnit);
+they never run the firmware. They check the harness, the broker and the
+central-side logic, but their timings measure Python, not the unit.
+
+Usage:
+    python latency_harness.py --broker 192.168.1.10 --rates 0.1,0.2,0.5 --duration 60
+    python latency_harness.py --spawn-broker --simulated 50 --rates 1,5,20 --dwell-ms 0
+    python latency_harness.py --spawn-broker --simulated 5 --rates 20 --dwell-ms 200 --credits
+    python latency_harness.py --spawn-broker --host-units 20 --rates 0.1,1 --duration 30
+"""
+
+import argparse
+import itertools
+import json
+import logging
+import os
+import queue
+import shutil
+import socket
+import statistics
+import subprocess
+import tempfile
+import threading
+import time
+import warnings
+
+logger = logging.getLogger(__name__)
+
+MQTT_REQUEST_TOPIC = "consultease/requests/new"
+TRACE_TOPIC_TEMPLATE = "consultease/faculty/{}/trace"
+TRACE_TOPIC_FILTER = "consultease/faculty/+/trace"
+CAPACITY_TOPIC_TEMPLATE = "consultease/faculty/{}/capacity"
+CAPACITY_TOPIC_FILTER = "consultease/faculty/+/capacity"
+
+# Firmware defaults (faculty-unit/config/config.h), mirrored by simulated units
+INBOX_CAPACITY = 8
+REQUEST_MIN_DISPLAY_MS = 5000
+CAPACITY_PUBLISH_MIN_MS = 500
+
+HOST_UNIT_BINARY = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "faculty-unit", "host_unit")
+
+
+def new_client(client_id=""):
+    import paho.mqtt.client as mqtt
+
+    if hasattr(mqtt, "CallbackAPIVersion"):  # paho-mqtt 2.x keeps the 1.x callback signatures with VERSION1
+        with warnings.catch_warnings():
+            warnings.simplefilter("ignore", DeprecationWarning)
+            return mqtt.Client(mqtt.CallbackAPIVersion.VERSION1, client_id=client_id, protocol=mqtt.MQTTv311)
+    return mqtt.Client(client_id=client_id, protocol=mqtt.MQTTv311)
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def summarize(values, unit):
+    if not values:
+        return "n/a"
+    return (f"p50 {statistics.median(values):.1f}{unit} p95 {percentile(values, 0.95):.1f}{unit} "
+            f"p99 {percentile(values, 0.99):.1f}{unit} max {max(values):.1f}{unit}")
+
+
+class SimulatedUnit:
+    """
+    In-process stand-in for a faculty unit: subscribes to the request topic, queues up
+    to INBOX_CAPACITY requests (rejecting new ones when full, as equal-priority requests
+    are on the unit), shows one every dwell_ms and publishes the same trace record.
+    Like the firmware's publish_capacity(), it publishes a retained capacity record
+    after any push, pop or overflow, at most every CAPACITY_PUBLISH_MIN_MS.
+    """
+
+    def __init__(self, faculty_id, broker, port, dwell_ms, draw_ms):
+        self.faculty_id = faculty_id
+        self.dwell_s = dwell_ms / 1000.0
+        self.draw_s = draw_ms / 1000.0
+        self.inbox = queue.Queue(maxsize=INBOX_CAPACITY)
+        self.dropped = 0                # Requests rejected by a full inbox
+        self.capacity_lock = threading.Lock()
+        self.capacity_changed = True    # Inbox activity since the last capacity record
+        self.capacity_sent_at = 0.0
+        self.lag_ms = 0
+        self.stop = threading.Event()
+        self.client = new_client(f"latency_sim_{faculty_id}")
+        self.client.on_message = self._on_request
+        self.client.connect(broker, port, 60)
+        self.client.subscribe(MQTT_REQUEST_TOPIC, qos=1)
+        self.client.loop_start()
+        self.worker = threading.Thread(target=self._show_requests, daemon=True)
+        self.worker.start()
+
+    def _on_request(self, client, userdata, msg):
+        start = time.monotonic()
+        try:
+            request = json.loads(msg.payload)
+        except ValueError:
+            return
+        trace_id = request.get("trace_id")
+        if not trace_id:
+            return
+        try:
+            self.inbox.put_nowait((trace_id, start, time.monotonic() - start))
+        except queue.Full:
+            self.dropped += 1 # Dropped, like an inbox overflow
+        self.capacity_changed = True
+        self._publish_capacity()
+
+    def _publish_capacity(self):
+        with self.capacity_lock:
+            depth = self.inbox.qsize()
+            now = time.monotonic()
+            if not self.capacity_changed or now - self.capacity_sent_at < CAPACITY_PUBLISH_MIN_MS / 1000.0:
+                return
+            self.capacity_changed, self.capacity_sent_at = False, now
+            record = {"free": INBOX_CAPACITY - depth, "depth": depth, "lag_ms": self.lag_ms}
+        self.client.publish(CAPACITY_TOPIC_TEMPLATE.format(self.faculty_id), json.dumps(record), retain=True)
+
+    def _show_requests(self):
+        while not self.stop.is_set():
+            self._publish_capacity() # Also catches up on a change held back by the minimum interval
+            try:
+                trace_id, received, parse_s = self.inbox.get(timeout=0.05)
+            except queue.Empty:
+                continue
+            self.capacity_changed = True
+            self._publish_capacity()
+            draw_start = time.monotonic()
+            self.lag_ms = int((draw_start - received) * 1000)
+            time.sleep(self.draw_s)
+            done = time.monotonic()
+            trace = {"trace_id": trace_id, "parse_us": int(parse_s * 1e6),
+                     "queue_ms": int((draw_start - received) * 1000), "draw_us": int((done - draw_start) * 1e6),
+                     "total_ms": int((done - received) * 1000)}
+            self.client.publish(TRACE_TOPIC_TEMPLATE.format(self.faculty_id), json.dumps(trace))
+            dwell_end = time.monotonic() + self.dwell_s
+            while not self.stop.wait(min(0.05, max(0.0, dwell_end - time.monotonic()))):
+                if time.monotonic() >= dwell_end:
+                    break
+                self._publish_capacity()
+
+    def close(self):
+        self.stop.set()
+        self.client.publish(CAPACITY_TOPIC_TEMPLATE.format(self.faculty_id), b"", retain=True)  # Clear the record
+        self.client.loop_stop()
+        self.client.disconnect()
+
+
+class HostUnit:
+    """
+    One faculty-unit/tools/host_unit process. It connects, subscribes and publishes its
+    capacity record like a board; on close it clears that record and reports its MQTT
+    counters, and its exit status says whether every publish went out.
+    """
+
+    def __init__(self, faculty_id, binary, broker, port):
+        self.faculty_id = faculty_id
+        self.log = tempfile.TemporaryFile(mode="w+") # Not a pipe: a unit must never block on its warnings
+        self.process = subprocess.Popen([binary, faculty_id, "--broker", broker, "--port", str(port)],
+                                        stdout=self.log, stderr=subprocess.STDOUT)
+
+    def close(self):
+        self.process.terminate()
+        try:
+            self.process.wait(timeout=5)
+        except subprocess.TimeoutExpired:
+            self.process.kill()
+            self.process.wait()
+        self.log.seek(0)
+        lines = self.log.read().strip().splitlines()
+        self.log.close()
+        summary = next((line for line in reversed(lines) if line.startswith(self.faculty_id + ":")), "no summary")
+        if self.process.returncode != 0:
+            logger.warning(f"host unit exited with {self.process.returncode}: {summary}")
+            for line in lines[-10:]:
+                logger.warning(f"  {line}")
+        else:
+            logger.info(f"  {summary}")
+
+
+class TraceCollector:
+    """Matches trace records to publish times, per step."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.published = {}  # trace_id -> monotonic publish time
+        self.records = []    # (faculty_id, rtt_ms, trace dict)
+        self.units = set()   # Faculty IDs with a retained capacity record
+        self.credits = {}    # faculty_id -> free inbox slots, spent locally until the next record
+
+    def on_message(self, client, userdata, msg):
+        now = time.monotonic()
+        parts = msg.topic.split("/")
+        if len(parts) != 4:
+            return
+        faculty_id, kind = parts[2], parts[3]
+        if kind == "capacity":
+            try:
+                free = int(json.loads(msg.payload)["free"])
+            except (ValueError, KeyError, TypeError):
+                return  # Cleared or malformed record
+            with self.lock:
+                self.units.add(faculty_id)
+                self.credits[faculty_id] = free
+            return
+        try:
+            trace = json.loads(msg.payload)
+        except ValueError:
+            return
+        with self.lock:
+            sent = self.published.get(trace.get("trace_id"))
+            if sent is not None:
+                self.records.append((faculty_id, (now - sent) * 1000, trace))
+
+    def spend_credit(self):
+        """
+        Spends one credit of every unit (each one receives every request), the way the
+        dashboard does for the unit it publishes to.
+
+        Returns:
+            bool: False (nothing spent) if some unit has no credits left.
+        """
+        with self.lock:
+            if any(free <= 0 for free in self.credits.values()):
+                return False
+            for faculty_id in self.credits:
+                self.credits[faculty_id] -= 1
+            return True
+
+    def mark_published(self, trace_id):
+        with self.lock:
+            self.published[trace_id] = time.monotonic()
+
+    def take(self):
+        with self.lock:
+            records, self.records = self.records, []
+            self.published.clear()
+            return records
+
+
+def end_to_end_ms(rtt_ms, trace):
+    """Unit time plus half of the rest of the round trip (publish leg ~ trace leg)."""
+    network_ms = max(0.0, rtt_ms - trace["total_ms"])
+    return trace["total_ms"] + network_ms / 2
+
+
+def report_step(rate, fleet, sent, duration, records, held=None, dropped=None, kinds=None):
+    expected = sent * fleet
+    e2e = [end_to_end_ms(rtt, trace) for _, rtt, trace in records]
+    logger.info(f"--- {fleet} units, {rate:g} requests/s: {sent} sent, {len(records)}/{expected} drawn "
+                f"({100.0 * len(records) / expected if expected else 0:.0f}%), "
+                f"{len(records) / duration:.2f} draws/s")
+    if held is not None:
+        logger.info(f"  held back (no credits): {held}")
+    if dropped is not None:
+        logger.info(f"  simulated inbox drops: {dropped}")
+    logger.info(f"  end-to-end ms: {summarize(e2e, '')}")
+    logger.info(f"  round trip ms: {summarize([rtt for _, rtt, _ in records], '')}")
+    logger.info(f"  parse us:      {summarize([t['parse_us'] for _, _, t in records], '')}")
+    logger.info(f"  queue ms:      {summarize([t['queue_ms'] for _, _, t in records], '')}")
+    logger.info(f"  draw us:       {summarize([t['draw_us'] for _, _, t in records], '')}")
+    # Host, simulated and real units' stage times are measured on different machines
+    by_kind = {}
+    for faculty_id, _, trace in records:
+        by_kind.setdefault((kinds or {}).get(faculty_id, "real"), []).append(trace)
+    if len(by_kind) > 1:
+        for kind, traces in sorted(by_kind.items()):
+            logger.info(f"  {kind} units: {len(traces)} drawn, parse us {summarize([t['parse_us'] for t in traces], '')}; "
+                        f"draw us {summarize([t['draw_us'] for t in traces], '')}")
+
+
+def spawn_broker(port):
+    if shutil.which("mosquitto") is None:
+        from mini_broker import MiniBroker
+
+        logger.info("mosquitto not found; using the built-in minimal broker (mini_broker.py)")
+        return MiniBroker(port)
+    process = subprocess.Popen(["mosquitto", "-p", str(port)], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    deadline = time.monotonic() + 5
+    while time.monotonic() < deadline:
+        try:
+            socket.create_connection(("127.0.0.1", port), timeout=0.2).close()
+            return process
+        except OSError:
+            time.sleep(0.1)
+    process.kill()
+    raise RuntimeError("mosquitto did not start")
+
+
+def main():
+    logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(name)s - %(levelname)s - %(message)s')
+    parser = argparse.ArgumentParser(description="Measure request latency from publish to TFT draw.")
+    parser.add_argument("--broker", default="localhost", help="MQTT broker address")
+    parser.add_argument("--port", type=int, default=1883, help="MQTT broker port")
+    parser.add_argument("--spawn-broker", action="store_true",
+                        help="Start a local mosquitto on --port (or the built-in broker without one)")
+    parser.add_argument("--rates", default="0.1,0.2,0.5", help="Comma-separated request rates (per second)")
+    parser.add_argument("--duration", type=float, default=60.0, help="Seconds of load per rate")
+    parser.add_argument("--drain", type=float, default=None,
+                        help="Seconds to wait for queued draws after each step (default: a full inbox)")
+    parser.add_argument("--host-units", type=int, default=0,
+                        help="faculty-unit/tools/host_unit processes to add to the fleet")
+    parser.add_argument("--host-unit-binary", default=HOST_UNIT_BINARY,
+                        help="Built host_unit (see the build line in tools/host_unit.cpp)")
+    parser.add_argument("--simulated", type=int, default=0, help="In-process simulated units to add to the fleet")
+    parser.add_argument("--dwell-ms", type=int, default=REQUEST_MIN_DISPLAY_MS,
+                        help="Simulated units' display time (host units use config.h's)")
+    parser.add_argument("--draw-ms", type=float, default=0.0, help="Simulated units' draw time")
+    parser.add_argument("--text", default="Latency harness request", help="request_text to send")
+    parser.add_argument("--credits", action="store_true",
+                        help="Honour the units' capacity credits like the dashboard: hold back requests "
+                             "while any unit has none (held-back requests are skipped, not retried)")
+    args = parser.parse_args()
+    if args.host_units and not os.access(args.host_unit_binary, os.X_OK):
+        parser.error(f"{args.host_unit_binary} not found; build it with the command in faculty-unit/tools/host_unit.cpp")
+
+    broker_process = spawn_broker(args.port) if args.spawn_broker else None
+    collector = TraceCollector()
+    client = new_client("latency_harness")
+    client.on_message = collector.on_message
+    client.connect(args.broker, args.port, 60)
+    client.subscribe([(TRACE_TOPIC_FILTER, 0), (CAPACITY_TOPIC_FILTER, 0)])
+    client.loop_start()
+    host_units = [HostUnit(f"host_{i:03d}", args.host_unit_binary, args.broker, args.port)
+                  for i in range(args.host_units)]
+    simulated = [SimulatedUnit(f"sim_{i:03d}", args.broker, args.port, args.dwell_ms, args.draw_ms)
+                 for i in range(args.simulated)]
+    kinds = {unit.faculty_id: "host" for unit in host_units}
+    kinds.update({unit.faculty_id: "simulated" for unit in simulated})
+
+    try:
+        # Retained capacity records identify the real units; host units publish theirs once connected
+        deadline = time.monotonic() + 2.0
+        while True:
+            time.sleep(0.2)
+            with collector.lock:
+                host_ready = len(collector.units & {unit.faculty_id for unit in host_units})
+            if time.monotonic() >= deadline and (host_ready == len(host_units) or time.monotonic() >= deadline + 10):
+                break
+        with collector.lock:
+            real_units = len(collector.units - set(kinds))
+        if host_ready < len(host_units):
+            logger.warning(f"Only {host_ready} of {len(host_units)} host units connected")
+        fleet = real_units + host_ready + len(simulated)
+        logger.info(f"Fleet: {real_units} real units, {host_ready} host units, {len(simulated)} simulated")
+        if fleet == 0:
+            logger.error("No units found on the broker; add --host-units or --simulated, or power a unit on.")
+            return
+
+        trace_ids = itertools.count(1)
+        # Host units keep the firmware's display time whatever --dwell-ms says
+        dwell_ms = max(args.dwell_ms, REQUEST_MIN_DISPLAY_MS) if host_units else args.dwell_ms
+        drain = args.drain if args.drain is not None else INBOX_CAPACITY * dwell_ms / 1000.0 + 5
+        for rate in (float(r) for r in args.rates.split(",")):
+            start = time.monotonic()
+            sent = held = 0
+            dropped_before = sum(unit.dropped for unit in simulated)
+            attempts = 0
+            while time.monotonic() - start < args.duration:
+                attempts += 1
+                if args.credits and not collector.spend_credit():
+                    held += 1
+                    time.sleep(max(0.0, start + attempts / rate - time.monotonic()))
+                    continue
+                trace_id = next(trace_ids)
+                # A fresh student per request stays clear of the unit's per-student rate limit
+                payload = json.dumps({"student_id": f"harness-{trace_id}", "request_text": args.text,
+                                      "priority": 0, "trace_id": trace_id})
+                collector.mark_published(trace_id)
+                client.publish(MQTT_REQUEST_TOPIC, payload, qos=1)
+                sent += 1
+                time.sleep(max(0.0, start + attempts / rate - time.monotonic()))
+            time.sleep(drain)
+            dropped = sum(unit.dropped for unit in simulated) - dropped_before if simulated else None
+            report_step(rate, fleet, sent, args.duration + drain, collector.take(),
+                        held if args.credits else None, dropped, kinds)
+    finally:
+        for unit in simulated:
+            unit.close()
+        if host_units:
+            logger.info("Host units:")
+        for unit in host_units:
+            unit.close()
+        client.loop_stop()
+        client.disconnect()
+        if broker_process is not None:
+            broker_process.terminate()
+
+
+if __name__ == "__main__":
+    main()
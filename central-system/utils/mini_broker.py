@@ -0,0 +1,237 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+ConsultEase Central System
+Minimal in-process MQTT 3.1.1 broker for host tests and harnesses.
+
+Used by latency_harness.py --spawn-broker when mosquitto is not installed. It
+supports what the central system and the faculty units use: CONNECT, PUBLISH at
+QoS 0/1, retained messages, SUBSCRIBE/UNSUBSCRIBE with "+" and "#" filters, and
+PINGREQ. There are no persistent sessions, wills or authentication; QoS 1
+deliveries are sent once and never redelivered.
+
+Usage:
+    python mini_broker.py --port 1883
+"""
+
+import argparse
+import logging
+import socket
+import struct
+import threading
+
+logger = logging.getLogger(__name__)
+
+CONNECT, CONNACK, PUBLISH, PUBACK = 1, 2, 3, 4
+SUBSCRIBE, SUBACK, UNSUBSCRIBE, UNSUBACK = 8, 9, 10, 11
+PINGREQ, PINGRESP, DISCONNECT = 12, 13, 14
+
+
+def topic_matches(topic_filter, topic):
+    filter_levels = topic_filter.split("/")
+    topic_levels = topic.split("/")
+    for index, level in enumerate(filter_levels):
+        if level == "#":
+            return True
+        if index >= len(topic_levels) or (level != "+" and level != topic_levels[index]):
+            return False
+    return len(filter_levels) == len(topic_levels)
+
+
+def encode_packet(packet_type, flags, body):
+    header = bytearray([(packet_type << 4) | flags])
+    length = len(body)
+    while True:
+        byte, length = length % 128, length // 128
+        header.append(byte | (0x80 if length else 0))
+        if not length:
+            return bytes(header) + body
+
+
+def encode_string(text):
+    data = text.encode()
+    return struct.pack("!H", len(data)) + data
+
+
+class _Session:
+    def __init__(self, broker, sock):
+        self.broker = broker
+        self.sock = sock
+        self.reader = sock.makefile("rb")
+        self.write_lock = threading.Lock()
+        self.subscriptions = {}  # filter -> granted QoS
+        self.next_packet_id = 1
+        self.client_id = ""
+
+    def send(self, packet_type, flags, body):
+        with self.write_lock:
+            try:
+                self.sock.sendall(encode_packet(packet_type, flags, body))
+            except OSError:
+                pass  # Reader side notices and cleans up
+
+    def deliver(self, topic, payload, qos, retain=False):
+        body = encode_string(topic)
+        if qos:
+            with self.write_lock:
+                packet_id, self.next_packet_id = self.next_packet_id, self.next_packet_id % 65535 + 1
+            body += struct.pack("!H", packet_id)
+        self.send(PUBLISH, (qos << 1) | int(retain), body + payload)
+
+    def _read_packet(self):
+        first = self.reader.read(1)
+        if not first:
+            return None, None, None
+        length, shift = 0, 0
+        while True:
+            byte = self.reader.read(1)
+            if not byte:
+                return None, None, None
+            length |= (byte[0] & 0x7F) << shift
+            shift += 7
+            if not byte[0] & 0x80:
+                break
+        body = self.reader.read(length)
+        if len(body) != length:
+            return None, None, None
+        return first[0] >> 4, first[0] & 0x0F, body
+
+    def run(self):
+        try:
+            while True:
+                packet_type, flags, body = self._read_packet()
+                if packet_type is None or packet_type == DISCONNECT:
+                    break
+                self._handle(packet_type, flags, body)
+        except (OSError, ValueError, struct.error) as e:
+            logger.debug(f"Client {self.client_id or '?'} dropped: {e}")
+        finally:
+            self.broker._remove(self)
+            self.sock.close()
+
+    def _handle(self, packet_type, flags, body):
+        if packet_type == CONNECT:
+            name_len = struct.unpack_from("!H", body, 0)[0]
+            offset = 2 + name_len + 4  # Protocol name, level, connect flags, keep-alive
+            client_id_len = struct.unpack_from("!H", body, offset)[0]
+            self.client_id = body[offset + 2:offset + 2 + client_id_len].decode(errors="replace")
+            self.send(CONNACK, 0, b"\x00\x00")
+        elif packet_type == PUBLISH:
+            qos, retain = (flags >> 1) & 0x03, bool(flags & 0x01)
+            topic_len = struct.unpack_from("!H", body, 0)[0]
+            topic = body[2:2 + topic_len].decode()
+            offset = 2 + topic_len
+            if qos:
+                packet_id = body[offset:offset + 2]
+                offset += 2
+                self.send(PUBACK, 0, packet_id)
+            self.broker.publish(topic, body[offset:], min(qos, 1), retain)
+        elif packet_type == SUBSCRIBE:
+            packet_id, offset, granted, filters = body[:2], 2, bytearray(), []
+            while offset < len(body):
+                filter_len = struct.unpack_from("!H", body, offset)[0]
+                topic_filter = body[offset + 2:offset + 2 + filter_len].decode()
+                qos = min(body[offset + 2 + filter_len] & 0x03, 1)
+                offset += 3 + filter_len
+                granted.append(qos)
+                filters.append((topic_filter, qos))
+            self.broker.subscribe(self, filters)
+            self.send(SUBACK, 0, packet_id + bytes(granted))
+            for topic_filter, qos in filters:
+                for topic, payload in self.broker.retained_matching(topic_filter):
+                    self.deliver(topic, payload, qos, retain=True)
+        elif packet_type == UNSUBSCRIBE:
+            offset = 2
+            with self.broker.lock:
+                while offset < len(body):
+                    filter_len = struct.unpack_from("!H", body, offset)[0]
+                    self.subscriptions.pop(body[offset + 2:offset + 2 + filter_len].decode(), None)
+                    offset += 2 + filter_len
+            self.send(UNSUBACK, 0, body[:2])
+        elif packet_type == PINGREQ:
+            self.send(PINGRESP, 0, b"")
+        # PUBACK from clients needs no action: deliveries are never retried
+
+
+class MiniBroker:
+    """Threaded broker listening on 127.0.0.1:<port> (or host) until terminate()."""
+
+    def __init__(self, port=1883, host="127.0.0.1"):
+        self.lock = threading.Lock()
+        self.sessions = []
+        self.retained = {}
+        self.server = socket.create_server((host, port), reuse_port=False)
+        self.thread = threading.Thread(target=self._accept, daemon=True)
+        self.thread.start()
+
+    def _accept(self):
+        while True:
+            try:
+                sock, _ = self.server.accept()
+            except OSError:
+                return  # terminate() closed the listener
+            sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+            session = _Session(self, sock)
+            with self.lock:
+                self.sessions.append(session)
+            threading.Thread(target=session.run, daemon=True).start()
+
+    def _remove(self, session):
+        with self.lock:
+            if session in self.sessions:
+                self.sessions.remove(session)
+
+    def subscribe(self, session, filters):
+        with self.lock:
+            for topic_filter, qos in filters:
+                session.subscriptions[topic_filter] = qos
+
+    def retained_matching(self, topic_filter):
+        with self.lock:
+            return [(topic, payload) for topic, payload in self.retained.items()
+                    if topic_matches(topic_filter, topic)]
+
+    def publish(self, topic, payload, qos, retain):
+        targets = []
+        with self.lock:
+            if retain:
+                if payload:
+                    self.retained[topic] = payload
+                else:
+                    self.retained.pop(topic, None)
+            for session in self.sessions:
+                granted = [sub_qos for topic_filter, sub_qos in session.subscriptions.items()
+                           if topic_matches(topic_filter, topic)]
+                if granted:
+                    targets.append((session, min(qos, max(granted))))
+        for session, delivery_qos in targets:
+            session.deliver(topic, payload, delivery_qos)
+
+    def terminate(self):
+        self.server.close()
+        with self.lock:
+            sessions = list(self.sessions)
+        for session in sessions:
+            try:
+                session.sock.shutdown(socket.SHUT_RDWR)
+            except OSError:
+                pass
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Minimal MQTT 3.1.1 broker for host tests.")
+    parser.add_argument("--host", default="127.0.0.1", help="Address to listen on")
+    parser.add_argument("--port", type=int, default=1883, help="Port to listen on")
+    args = parser.parse_args()
+    logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(levelname)s - %(message)s')
+    broker = MiniBroker(args.port, args.host)
+    logger.info(f"Listening on {args.host}:{args.port}")
+    try:
+        threading.Event().wait()
+    except KeyboardInterrupt:
+        broker.terminate()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+ConsultEase Central System
+Display asset pipeline: converts images to QOI and pushes them to a faculty unit.
+
+The faculty unit stores uploads in LittleFS and decodes them a scanline at a time
+(faculty-unit/display/qoi_decoder.cpp), so images must fit the panel (240x320).
+
+Usage:
+    python qoi_assets.py --broker 192.168.1.10 --faculty prof_smith \\
+        --name photo --image portrait.jpg --size 200x200
+    python qoi_assets.py --broker 192.168.1.10 --faculty prof_smith \\
+        --name status_present --image present.png --size 20x20
+"""
+
+import argparse
+import logging
+import struct
+
+logger = logging.getLogger(__name__)
+
+MQTT_ASSET_TOPIC_TEMPLATE = "consultease/faculty/{}/asset/{}"
+CHUNK_SIZE = 512 # Data bytes per MQTT message; must fit MQTT_BUFFER_SIZE on the unit
+
+_QOI_OP_INDEX = 0x00
+_QOI_OP_DIFF = 0x40
+_QOI_OP_LUMA = 0x80
+_QOI_OP_RUN = 0xc0
+_QOI_OP_RGB = 0xfe
+_QOI_OP_RGBA = 0xff
+
+
+def encode_qoi(pixels, width, height, channels=4):
+    """
+    Encodes RGBA pixels (an iterable of (r, g, b, a) tuples, row-major) as QOI.
+    Follows the reference encoder from https://qoiformat.org.
+    """
+    out = bytearray(b"qoif")
+    out += struct.pack(">IIBB", width, height, channels, 0)
+
+    index = [(0, 0, 0, 0)] * 64
+    prev = (0, 0, 0, 255)
+    run = 0
+    pixels = list(pixels)
+    last = len(pixels) - 1
+
+    for i, px in enumerate(pixels):
+        if px == prev:
+            run += 1
+            if run == 62 or i == last:
+                out.append(_QOI_OP_RUN | (run - 1))
+                run = 0
+            continue
+
+        if run > 0:
+            out.append(_QOI_OP_RUN | (run - 1))
+            run = 0
+
+        r, g, b, a = px
+        h = (r * 3 + g * 5 + b * 7 + a * 11) % 64
+        if index[h] == px:
+            out.append(_QOI_OP_INDEX | h)
+        else:
+            index[h] = px
+            if a == prev[3]:
+                vr = (r - prev[0] + 128) % 256 - 128
+                vg = (g - prev[1] + 128) % 256 - 128
+                vb = (b - prev[2] + 128) % 256 - 128
+                vg_r = vr - vg
+                vg_b = vb - vg
+                if -3 < vr < 2 and -3 < vg < 2 and -3 < vb < 2:
+                    out.append(_QOI_OP_DIFF | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2))
+                elif -9 < vg_r < 8 and -33 < vg < 32 and -9 < vg_b < 8:
+                    out.append(_QOI_OP_LUMA | (vg + 32))
+                    out.append(((vg_r + 8) << 4) | (vg_b + 8))
+                else:
+                    out += bytes((_QOI_OP_RGB, r, g, b))
+            else:
+                out += bytes((_QOI_OP_RGBA, r, g, b, a))
+        prev = px
+
+    out += b"\x00" * 7 + b"\x01"
+    return bytes(out)
+
+
+def image_to_qoi(path, max_size):
+    """Loads an image with Pillow, fits it inside max_size (w, h) and returns QOI bytes."""
+    from PIL import Image
+
+    with Image.open(path) as img:
+        img = img.convert("RGBA")
+        img.thumbnail(max_size)
+        return encode_qoi(img.getdata(), img.width, img.height)
+
+
+def asset_chunks(data):
+    """Yields upload payloads: big-endian offset, big-endian total size, data."""
+    total = len(data)
+    for offset in range(0, total, CHUNK_SIZE):
+        yield struct.pack(">II", offset, total) + data[offset:offset + CHUNK_SIZE]
+
+
+def push_asset(mqtt_client, faculty_id, name, data):
+    """
+    Publishes an asset to a faculty unit in order. Works with a raw paho client;
+    QoS 1 keeps chunks ordered and delivered.
+    """
+    topic = MQTT_ASSET_TOPIC_TEMPLATE.format(faculty_id, name)
+    for payload in asset_chunks(data):
+        info = mqtt_client.publish(topic, payload, qos=1)
+        info.wait_for_publish()
+    logger.info(f"Pushed asset '{name}' ({len(data)} bytes) to {topic}")
+
+
+def main():
+    logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(name)s - %(levelname)s - %(message)s')
+    parser = argparse.ArgumentParser(description="Convert an image to QOI and push it to a faculty unit.")
+    parser.add_argument("--image", required=True, help="Source image (any format Pillow can read)")
+    parser.add_argument("--name", required=True, help="Asset name, e.g. photo or status_present")
+    parser.add_argument("--size", default="200x200", help="Maximum WxH on the panel")
+    parser.add_argument("--faculty", help="Faculty ID to push to (omit to only convert)")
+    parser.add_argument("--broker", default="localhost", help="MQTT broker address")
+    parser.add_argument("--port", type=int, default=1883, help="MQTT broker port")
+    parser.add_argument("--output", help="Also write the QOI file here")
+    args = parser.parse_args()
+
+    width, height = (int(v) for v in args.size.lower().split("x"))
+    data = image_to_qoi(args.image, (width, height))
+    logger.info(f"Encoded {args.image} as QOI: {len(data)} bytes")
+
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(data)
+
+    if args.faculty:
+        import paho.mqtt.client as mqtt
+
+        client = mqtt.Client(protocol=mqtt.MQTTv311)
+        client.connect(args.broker, args.port, 60)
+        client.loop_start()
+        try:
+            push_asset(client, args.faculty, args.name, data)
+        finally:
+            client.loop_stop()
+            client.disconnect()
+
+
+if __name__ == "__main__":
+    main()
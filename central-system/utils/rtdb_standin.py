@@ -0,0 +1,307 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+ConsultEase Central System
+Local HTTPS stand-in for the Firebase Realtime Database REST API.
+
+Serves GET, PUT and PATCH on "<path>.json" from an in-memory tree over HTTP/1.1
+keep-alive, which is enough for faculty units built with FIREBASE_TEST_MODE 1 and
+DATABASE_URL pointing here (faculty-unit/comms/rtdb_writer.h). Every connection
+logs how many requests it carried, so keep-alive and pipelining are visible, and
+the unit's /metrics (unit_firebase_*) show the write latency it measured.
+
+--bench N writes N values itself and compares three client strategies:
+
+    connect   a new TLS connection per write (what a client does once its idle connection was dropped)
+    reuse     one kept-alive connection, one request at a time
+    pipeline  one connection, --depth requests sent before their responses are read
+
+On loopback there is no network round trip, so --rtt-ms adds one per flight the
+client waits on: three for "connect" (TCP, TLS 1.3, request), one per write for
+"reuse" and one per burst for "pipeline".
+
+Usage:
+    python rtdb_standin.py --port 8443
+    python rtdb_standin.py --bench 200 --depth 4 --rtt-ms 60
+
+A self-signed certificate is generated with the openssl CLI unless --cert/--key are given.
+"""
+
+import argparse
+import json
+import logging
+import os
+import socket
+import ssl
+import statistics
+import subprocess
+import tempfile
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlsplit
+
+logger = logging.getLogger(__name__)
+
+
+class RtdbTree:
+    """In-memory JSON tree addressed by "/"-separated paths."""
+
+    def __init__(self):
+        self._root = {}
+        self._lock = threading.Lock()
+
+    @staticmethod
+    def _keys(path):
+        return [key for key in path.strip("/").split("/") if key]
+
+    def get(self, path, shallow=False):
+        with self._lock:
+            node = self._root
+            for key in self._keys(path):
+                if not isinstance(node, dict) or key not in node:
+                    return None
+                node = node[key]
+            if shallow and isinstance(node, dict):
+                return {key: True for key in node}
+            return node
+
+    def put(self, path, value):
+        keys = self._keys(path)
+        with self._lock:
+            if not keys:
+                self._root = value if isinstance(value, dict) else {}
+                return
+            node = self._root
+            for key in keys[:-1]:
+                if not isinstance(node.get(key), dict):
+                    node[key] = {}
+                node = node[key]
+            if value is None:
+                node.pop(keys[-1], None)
+            else:
+                node[keys[-1]] = value
+
+    def patch(self, path, values):
+        for key, value in values.items():
+            self.put(f"{path.rstrip('/')}/{key}", value)
+
+
+class RtdbHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # Keep-alive and pipelining
+    disable_nagle_algorithm = True  # Headers and body are written separately
+
+    def setup(self):
+        super().setup()
+        self.requests_served = 0
+        logger.debug(f"{self.client_address[0]}:{self.client_address[1]} connected")
+
+    def finish(self):
+        super().finish()
+        logger.info(f"{self.client_address[0]}:{self.client_address[1]} closed after {self.requests_served} requests")
+
+    def log_message(self, format, *args):
+        logger.debug(format % args)
+
+    def _parse(self):
+        url = urlsplit(self.path)
+        if not url.path.endswith(".json"):
+            self._reply(400, {"error": "path must end in .json"})
+            return None, None
+        return url.path[:-len(".json")], parse_qs(url.query)
+
+    def _body(self):
+        length = int(self.headers.get("Content-Length", 0))
+        try:
+            return json.loads(self.rfile.read(length) or b"null")
+        except ValueError:
+            return ...
+
+    def _reply(self, status, value):
+        body = json.dumps(value, separators=(",", ":")).encode()
+        if self.server.delay_s:
+            time.sleep(self.server.delay_s)
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+        self.requests_served += 1
+
+    def do_GET(self):
+        path, query = self._parse()
+        if path is not None:
+            self._reply(200, self.server.tree.get(path, shallow="true" in query.get("shallow", [])))
+
+    def do_PUT(self):
+        path, _ = self._parse()
+        if path is None:
+            return
+        value = self._body()
+        if value is ...:
+            self._reply(400, {"error": "Invalid data; couldn't parse JSON object."})
+            return
+        self.server.tree.put(path, value)
+        self._reply(200, value)
+
+    def do_PATCH(self):
+        path, _ = self._parse()
+        if path is None:
+            return
+        values = self._body()
+        if not isinstance(values, dict):
+            self._reply(400, {"error": "Invalid data; PATCH needs a JSON object."})
+            return
+        self.server.tree.patch(path, values)
+        self._reply(200, values)
+
+
+def self_signed_cert(directory):
+    cert, key = os.path.join(directory, "standin.crt"), os.path.join(directory, "standin.key")
+    subprocess.run(["openssl", "req", "-x509", "-newkey", "ec", "-pkeyopt", "ec_paramgen_curve:prime256v1",
+                    "-nodes", "-keyout", key, "-out", cert, "-days", "30", "-subj", "/CN=rtdb-standin"],
+                   check=True, capture_output=True)
+    return cert, key
+
+
+def start_server(port, cert, key, delay_ms=0):
+    context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    context.load_cert_chain(cert, key)
+    server = ThreadingHTTPServer(("", port), RtdbHandler)
+    server.daemon_threads = True
+    server.socket = context.wrap_socket(server.socket, server_side=True)
+    server.tree = RtdbTree()
+    server.delay_s = delay_ms / 1000
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    return server
+
+
+class BenchClient:
+    """Minimal HTTP/1.1 client over one TLS connection that can pipeline requests."""
+
+    def __init__(self, port):
+        context = ssl.SSLContext(ssl.PROTOCOL_TLS_CLIENT)
+        context.check_hostname = False
+        context.verify_mode = ssl.CERT_NONE
+        raw = socket.create_connection(("127.0.0.1", port))
+        raw.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.sock = context.wrap_socket(raw)
+        self.reader = self.sock.makefile("rb")
+        self.port = port
+
+    def send_put(self, path, value):
+        body = json.dumps(value).encode()
+        self.sock.sendall(f"PUT /{path}.json HTTP/1.1\r\nHost: 127.0.0.1:{self.port}\r\n"
+                          f"Content-Type: application/json\r\nContent-Length: {len(body)}\r\n\r\n".encode() + body)
+
+    def read_response(self):
+        status = int(self.reader.readline().split()[1])
+        length = 0
+        while True:
+            line = self.reader.readline().strip()
+            if not line:
+                break
+            name, _, value = line.partition(b":")
+            if name.lower() == b"content-length":
+                length = int(value)
+        self.reader.read(length)
+        return status
+
+    def close(self):
+        self.reader.close()
+        self.sock.close()
+
+
+def bench(port, writes, depth, rtt_ms=0):
+    """
+    Returns:
+        dict: strategy -> per-write latencies in ms (queued to acknowledged).
+    """
+    results = {}
+    path = "faculty/bench/status"
+
+    def round_trips(count):
+        time.sleep(count * rtt_ms / 1000)
+
+    latencies = []
+    for index in range(writes):
+        start = time.perf_counter()
+        client = BenchClient(port)
+        client.send_put(path, f"connect-{index}")
+        round_trips(3)
+        client.read_response()
+        latencies.append((time.perf_counter() - start) * 1000)
+        client.close()
+    results["connect"] = latencies
+
+    client = BenchClient(port)
+    latencies = []
+    for index in range(writes):
+        start = time.perf_counter()
+        client.send_put(path, f"reuse-{index}")
+        round_trips(1)
+        client.read_response()
+        latencies.append((time.perf_counter() - start) * 1000)
+    results["reuse"] = latencies
+
+    # Writes arrive in bursts of depth; each one's latency runs from the burst start to its response
+    latencies = []
+    for first in range(0, writes, depth):
+        start = time.perf_counter()
+        burst = range(first, min(first + depth, writes))
+        for index in burst:
+            client.send_put(f"{path}{index % depth}", f"pipeline-{index}")
+        round_trips(1)
+        for _ in burst:
+            client.read_response()
+            latencies.append((time.perf_counter() - start) * 1000)
+    results["pipeline"] = latencies
+    client.close()
+    return results
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Local HTTPS stand-in for the Firebase RTDB REST API.")
+    parser.add_argument("--port", type=int, default=8443, help="HTTPS port")
+    parser.add_argument("--cert", help="PEM certificate (default: generate a self-signed one)")
+    parser.add_argument("--key", help="PEM private key for --cert")
+    parser.add_argument("--delay-ms", type=float, default=0, help="Extra server time per request")
+    parser.add_argument("--bench", type=int, metavar="N", help="Run N writes per client strategy and exit")
+    parser.add_argument("--rtt-ms", type=float, default=0, help="Emulated network round trip for --bench")
+    parser.add_argument("--depth", type=int, default=4, help="Pipeline depth for --bench (FIREBASE_PIPELINE_DEPTH)")
+    parser.add_argument("-v", "--verbose", action="store_true", help="Log every request")
+    args = parser.parse_args()
+
+    logging.basicConfig(level=logging.DEBUG if args.verbose else logging.INFO,
+                        format='%(asctime)s - %(levelname)s - %(message)s')
+    if args.bench:
+        logging.getLogger().setLevel(logging.WARNING)  # Per-connection lines would drown the report
+
+    with tempfile.TemporaryDirectory() as directory:
+        cert, key = (args.cert, args.key) if args.cert else self_signed_cert(directory)
+        server = start_server(args.port, cert, key, args.delay_ms)
+
+        if args.bench:
+            results = bench(args.port, args.bench, args.depth, args.rtt_ms)
+            print(f"{'strategy':10} {'writes':>6} {'p50 ms':>8} {'p99 ms':>8} {'mean ms':>8}")
+            for strategy, latencies in results.items():
+                print(f"{strategy:10} {len(latencies):6d} {statistics.median(latencies):8.2f} "
+                      f"{percentile(latencies, 0.99):8.2f} {statistics.fmean(latencies):8.2f}")
+            server.shutdown()
+            return
+
+        logger.info(f"RTDB stand-in on https://0.0.0.0:{args.port} (set DATABASE_URL and FIREBASE_TEST_MODE 1)")
+        try:
+            threading.Event().wait()
+        except KeyboardInterrupt:
+            server.shutdown()
+
+
+if __name__ == "__main__":
+    main()
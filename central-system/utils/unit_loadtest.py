@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+ConsultEase Central System
+Load test for a faculty unit's debug HTTP server (faculty-unit/comms/debug_server.cpp).
+
+Scrapes /metrics from several threads while holding WebSocket connections to /events,
+then reports scrape latency, errors and received events. The unit's own loop latency
+(unit_loop_pass_max_us) and MQTT counters are sampled before and after, so any
+effect of serving clients on the BLE/MQTT loop is visible in the report.
+Only the standard library is used.
+
+Usage:
+    python unit_loadtest.py --host 192.168.1.42 --token <DEBUG_HTTP_EVENTS_TOKEN> --scrapers 8 --websockets 2 --duration 60
+"""
+
+import argparse
+import base64
+import http.client
+import logging
+import os
+import socket
+import statistics
+import threading
+import time
+from urllib.parse import quote
+
+logger = logging.getLogger(__name__)
+
+
+def parse_metrics(text):
+    """Parses Prometheus text into {name: float}, skipping comments."""
+    samples = {}
+    for line in text.splitlines():
+        if not line or line.startswith("#"):
+            continue
+        name, _, value = line.partition(" ")
+        try:
+            samples[name] = float(value)
+        except ValueError:
+            pass
+    return samples
+
+
+def fetch_metrics(host, port, timeout=5.0):
+    conn = http.client.HTTPConnection(host, port, timeout=timeout)
+    try:
+        conn.request("GET", "/metrics")
+        response = conn.getresponse()
+        body = response.read().decode("utf-8", "replace")
+        if response.status != 200:
+            raise IOError(f"HTTP {response.status}")
+        return body
+    finally:
+        conn.close()
+
+
+class Scraper(threading.Thread):
+    """Requests /metrics back to back (or every `interval` seconds) until stopped."""
+
+    def __init__(self, host, port, interval, stop):
+        super().__init__(daemon=True)
+        self.host, self.port, self.interval, self.stop = host, port, interval, stop
+        self.latencies = []
+        self.errors = 0
+
+    def run(self):
+        while not self.stop.is_set():
+            start = time.monotonic()
+            try:
+                fetch_metrics(self.host, self.port)
+                self.latencies.append(time.monotonic() - start)
+            except (OSError, http.client.HTTPException) as e:
+                self.errors += 1
+                logger.debug(f"Scrape failed: {e}")
+            if self.interval > 0:
+                self.stop.wait(self.interval)
+
+
+class EventListener(threading.Thread):
+    """Holds a WebSocket to /events and counts the text frames received."""
+
+    def __init__(self, host, port, token, stop):
+        super().__init__(daemon=True)
+        self.host, self.port, self.token, self.stop = host, port, token, stop
+        self.frames = []
+        self.error = None
+
+    def _handshake(self, sock):
+        key = base64.b64encode(os.urandom(16)).decode()
+        request = (f"GET /events?token={quote(self.token)} HTTP/1.1\r\nHost: {self.host}\r\nUpgrade: websocket\r\n"
+                   f"Connection: Upgrade\r\nSec-WebSocket-Key: {key}\r\nSec-WebSocket-Version: 13\r\n\r\n")
+        sock.sendall(request.encode())
+        response = b""
+        while b"\r\n\r\n" not in response:
+            chunk = sock.recv(1024)
+            if not chunk:
+                raise IOError("Connection closed during handshake")
+            response += chunk
+        status_line = response.split(b"\r\n", 1)[0]
+        if b" 101 " not in status_line:
+            raise IOError(f"Handshake refused: {status_line!r}")
+        return response.split(b"\r\n\r\n", 1)[1]
+
+    def _recv_exact(self, sock, buffer, n):
+        while len(buffer) < n:
+            chunk = sock.recv(4096)
+            if not chunk:
+                raise IOError("Connection closed")
+            buffer += chunk
+        return buffer[:n], buffer[n:]
+
+    def run(self):
+        try:
+            sock = socket.create_connection((self.host, self.port), timeout=5.0)
+            buffer = self._handshake(sock)
+            sock.settimeout(0.5)
+            while not self.stop.is_set():
+                try:
+                    header, buffer = self._recv_exact(sock, buffer, 2)
+                except socket.timeout:
+                    continue
+                opcode, length = header[0] & 0x0f, header[1] & 0x7f
+                if length == 126:
+                    ext, buffer = self._recv_exact(sock, buffer, 2)
+                    length = int.from_bytes(ext, "big")
+                elif length == 127:
+                    ext, buffer = self._recv_exact(sock, buffer, 8)
+                    length = int.from_bytes(ext, "big")
+                payload, buffer = self._recv_exact(sock, buffer, length)
+                if opcode == 0x1:
+                    self.frames.append((time.monotonic(), payload.decode("utf-8", "replace")))
+                elif opcode == 0x8:
+                    raise IOError("Closed by unit")
+            sock.close()
+        except (OSError, IOError) as e:
+            self.error = str(e)
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def main():
+    logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(name)s - %(levelname)s - %(message)s')
+    parser = argparse.ArgumentParser(description="Load-test a faculty unit's debug HTTP server.")
+    parser.add_argument("--host", required=True, help="Faculty unit IP address")
+    parser.add_argument("--port", type=int, default=80, help="DEBUG_HTTP_PORT on the unit")
+    parser.add_argument("--scrapers", type=int, default=4, help="Concurrent /metrics clients")
+    parser.add_argument("--interval", type=float, default=0.0, help="Seconds between scrapes per client (0 = back to back)")
+    parser.add_argument("--websockets", type=int, default=1, help="Concurrent /events listeners")
+    parser.add_argument("--token", default="", help="DEBUG_HTTP_EVENTS_TOKEN on the unit (needed for /events)")
+    parser.add_argument("--duration", type=float, default=30.0, help="Test length in seconds")
+    args = parser.parse_args()
+
+    before = parse_metrics(fetch_metrics(args.host, args.port))
+
+    stop = threading.Event()
+    listeners = [EventListener(args.host, args.port, args.token, stop) for _ in range(args.websockets)]
+    scrapers = [Scraper(args.host, args.port, args.interval, stop) for _ in range(args.scrapers)]
+    for thread in listeners + scrapers:
+        thread.start()
+    time.sleep(args.duration)
+    stop.set()
+    for thread in listeners + scrapers:
+        thread.join(timeout=5.0)
+
+    # The unit re-renders /metrics every DEBUG_HTTP_REFRESH_MS; wait for a fresh one
+    time.sleep(2.5)
+    after = parse_metrics(fetch_metrics(args.host, args.port))
+
+    latencies = [value for scraper in scrapers for value in scraper.latencies]
+    errors = sum(scraper.errors for scraper in scrapers)
+    logger.info(f"Scrapes: {len(latencies)} ok, {errors} failed, {len(latencies) / args.duration:.1f}/s")
+    if latencies:
+        logger.info(f"Scrape latency ms: p50 {statistics.median(latencies) * 1000:.1f}, "
+                    f"p95 {percentile(latencies, 0.95) * 1000:.1f}, p99 {percentile(latencies, 0.99) * 1000:.1f}, "
+                    f"max {max(latencies) * 1000:.1f}")
+    for i, listener in enumerate(listeners):
+        status = f"error: {listener.error}" if listener.error else "ok"
+        logger.info(f"WebSocket {i}: {len(listener.frames)} events ({status})")
+
+    def delta(name):
+        return after.get(name, 0) - before.get(name, 0)
+
+    logger.info(f"Unit loop pass max us: before {before.get('unit_loop_pass_max_us', 0):.0f}, "
+                f"after {after.get('unit_loop_pass_max_us', 0):.0f}")
+    logger.info(f"Unit during test: {delta('unit_ble_scans_total'):.0f} BLE scans, "
+                f"{delta('unit_mqtt_received_total'):.0f} MQTT received, "
+                f"{delta('unit_mqtt_connect_failures_total'):.0f} MQTT connect failures, "
+                f"{delta('unit_ws_frames_dropped_total'):.0f} WebSocket frames dropped, "
+                f"{delta('unit_heap_steady_allocations_total'):.0f} loop-task allocations")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,9 +1,25 @@
 #include "ble_scanner.h"
 #include "faculty-unit/config/config.h" // Include config for constants
 #include <Arduino.h> // Required for millis()
+#include <math.h>    // sqrtf() for the phase window width
+#include <sys/time.h> // gettimeofday() for presence deadlines that survive sleep
+#include "unit_log.h" // Sampled Serial/MQTT logging
+
+static int64_t system_time_us() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec;
+}
 
 // Constructor
-BLEScanner::BLEScanner() : last_seen_ms(0), pBLEScan(nullptr), targetAddress(TARGET_BLE_ADDRESS) {
+BLEScanner::BLEScanner()
+    : last_seen_ms(0), pBLEScan(nullptr), targetAddress(TARGET_BLE_ADDRESS), presence_state{1, 0, false},
+      scan_started_ms(0),
+      scan_period_ms(POWER_MODE == POWER_MODE_BATTERY ? BATTERY_WAKE_INTERVAL_MS : BLE_SCAN_INTERVAL_MS),
+      window_aligned(false), phase_misses(0), radio_on_total_ms(0), presence_deadline_us(0), scan_count(0),
+      hold_until_scan(false),
+      advert_head(0), advert_count(0),
+      advert_mux(portMUX_INITIALIZER_UNLOCKED) {
     // Initialize targetAddress from config constant
 }
 
@@ -11,12 +27,12 @@ BLEScanner::BLEScanner() : last_seen_ms(0), pBLEScan(nullptr), targetAddress(TAR
  * @brief Initializes the BLE stack and scanner object.
  */
 void BLEScanner::setup_ble() {
-    Serial.println("Initializing BLE...");
+    ULOG(ULOG_INFO, "Initializing BLE...");
     BLEDevice::init(""); // Initialize BLE device with an empty name
 
     pBLEScan = BLEDevice::getScan(); // Get the BLE Scan object
     if (!pBLEScan) {
-        Serial.println("Failed to get BLE Scan object");
+        ULOG(ULOG_ERROR, "Failed to get BLE Scan object");
         return; // Handle error appropriately
     }
 
@@ -24,37 +40,134 @@ void BLEScanner::setup_ble() {
     pBLEScan->setActiveScan(true); // Active scan uses more power but gets more info
     pBLEScan->setInterval(100);    // Scan interval in ms
     pBLEScan->setWindow(99);       // Less than or equal to interval
+    // Duplicates are needed: every advert from the target feeds the interval estimate
+    pBLEScan->setAdvertisedDeviceCallbacks(&advert_callbacks, true);
+
+    ULOG(ULOG_INFO, "BLE Scanner Initialized.");
+}
+
+BLEScanner* BLEScanner::instance = nullptr;
 
-    Serial.println("BLE Scanner Initialized.");
+/**
+ * @brief Scan completion callback, runs on the BLE task. Only signals the event;
+ *        results are processed on the loop task by process_results().
+ */
+void BLEScanner::on_scan_complete(BLEScanResults results) {
+    (void)results;
+    if (instance != nullptr) {
+        instance->scan_complete.signal();
+    }
 }
 
 /**
- * @brief Performs a BLE scan for the configured duration.
- *        Updates last_seen_ms if the target beacon is found.
+ * @brief Advertisement callback, runs on the BLE task. Only timestamps target sightings;
+ *        a full ring drops the newest (the estimator tolerates gaps).
+ */
+void BLEScanner::AdvertCallbacks::onResult(BLEAdvertisedDevice advertisedDevice) {
+    BLEScanner* scanner = BLEScanner::instance;
+    if (scanner == nullptr || !advertisedDevice.getAddress().equals(scanner->targetAddress)) {
+        return;
+    }
+    unsigned long now = millis();
+    portENTER_CRITICAL(&scanner->advert_mux);
+    if (scanner->advert_count < ADVERT_RING_SIZE) {
+        scanner->advert_ring[(scanner->advert_head + scanner->advert_count) % ADVERT_RING_SIZE] = now;
+        scanner->advert_count++;
+    }
+    portEXIT_CRITICAL(&scanner->advert_mux);
+}
+
+/**
+ * @brief Starts a BLE scan for the configured duration without blocking.
  * @return true if the scan was initiated successfully, false otherwise.
- *         Note: This implementation returns true if the target was found during the scan,
- *         which might differ slightly from the header comment's intent (initiation success).
- *         Consider adjusting return value if needed, but current logic is functional.
  */
 bool BLEScanner::scan() {
-    Serial.println("Starting BLE scan...");
-    bool foundTarget = false;
+    if (!pBLEScan) {
+        return false;
+    }
+    ULOG(ULOG_DEBUG, "Starting BLE scan...");
+    begin_window(false);
+    return pBLEScan->start(BLE_SCAN_DURATION, on_scan_complete, false);
+}
 
-    // Start scan for the duration specified in config, don't block execution
-    BLEScanResults foundDevices = pBLEScan->start(BLE_SCAN_DURATION, false);
+void BLEScanner::begin_window(bool aligned) {
+    instance = this;
+    unsigned long now = millis();
+    if (scan_started_ms != 0) {
+        scan_period_ms = now - scan_started_ms;
+    }
+    scan_started_ms = now;
+    window_aligned = aligned;
+}
+
+/**
+ * @brief Arrival times random-walk: each advertising event adds 0..BLE_ADV_DELAY_MAX_MS
+ *        of advDelay, so the half-width grows with the square root of the number of
+ *        intervals extrapolated, and doubles per consecutive miss.
+ *        A restored interval comes without a phase (no advert since boot), so the scan
+ *        stays blind until a sighting anchors the prediction again.
+ */
+bool BLEScanner::plan_window(unsigned long earliest_ms, unsigned long* open_ms, unsigned long* window_ms) {
+    float interval = target_estimator.interval_ms();
+    if (!BLE_PHASE_LOCK || interval == 0 || target_estimator.last_advert() == 0 ||
+        phase_misses >= BLE_PHASE_MAX_MISSES) {
+        return false;
+    }
+
+    unsigned long intervals_ahead = 0;
+    unsigned long predicted = target_estimator.predict_arrival(earliest_ms, &intervals_ahead);
+    unsigned long half = (unsigned long)(BLE_PHASE_HALF_WINDOW_MS + sqrtf(intervals_ahead) * BLE_ADV_DELAY_MAX_MS)
+                         << phase_misses;
+    if (half > BLE_SCAN_DURATION * 1000UL / 2) {
+        return false; // Too uncertain to be worth aligning; scan blind
+    }
+
+    if (2 * half >= interval + BLE_ADV_DELAY_MAX_MS) {
+        // Fast beacon: one interval of listening is guaranteed to contain an advert
+        *open_ms = earliest_ms;
+        *window_ms = (unsigned long)interval + BLE_ADV_DELAY_MAX_MS;
+    } else {
+        *open_ms = predicted - half;
+        *window_ms = 2 * half;
+    }
+    return true;
+}
 
-    Serial.print("Scan finished. Devices found: ");
-    Serial.println(foundDevices.getCount());
+/**
+ * @brief Duration 0 scans until stop_window(); no completion callback is involved.
+ */
+bool BLEScanner::start_window() {
+    if (!pBLEScan) {
+        return false;
+    }
+    begin_window(true);
+    return pBLEScan->start(0, nullptr, false);
+}
 
-    for (int i = 0; i < foundDevices.getCount(); i++) {
-        BLEAdvertisedDevice device = foundDevices.getDevice(i);
-        Serial.print("  Device Address: ");
-        Serial.println(device.getAddress().toString().c_str());
+void BLEScanner::stop_window() {
+    if (pBLEScan) {
+        pBLEScan->stop();
+    }
+}
+
+/**
+ * @brief Checks the results of the completed scan for the target beacon.
+ * @return true if the target was found during the scan.
+ */
+bool BLEScanner::process_results() {
+    bool foundTarget = false;
+    BLEScanResults* foundDevices = pBLEScan->getResults();
+
+    ULOG(ULOG_DEBUG, "%s finished. Devices found: %d", window_aligned ? "Aligned window" : "Scan",
+         foundDevices->getCount());
+
+    for (int i = 0; i < foundDevices->getCount(); i++) {
+        // Compare addresses only; formatting every address as a std::string allocates
+        BLEAddress address = foundDevices->getDevice(i).getAddress();
 
         // Check if the found device address matches the target address
-        if (device.getAddress().equals(targetAddress)) {
-            Serial.print("!!! Target Beacon Found: ");
-            Serial.println(device.getAddress().toString().c_str());
+        if (address.equals(targetAddress)) {
+            ULOG(ULOG_DEBUG, "Target Beacon Found: %s", TARGET_BLE_ADDRESS);
             last_seen_ms = millis(); // Update the last seen timestamp
             foundTarget = true;
             break; // Stop searching once the target is found
@@ -62,39 +175,112 @@ bool BLEScanner::scan() {
     }
 
     pBLEScan->clearResults(); // Clear results from memory
-    Serial.println("Scan results cleared.");
+
+    // Drain this window's sightings into the estimator
+    unsigned long window_ms = millis() - scan_started_ms;
+    radio_on_total_ms += window_ms;
+    scan_count++;
+    for (;;) {
+        unsigned long t_ms;
+        portENTER_CRITICAL(&advert_mux);
+        bool have = advert_count > 0;
+        if (have) {
+            t_ms = advert_ring[advert_head];
+            advert_head = (advert_head + 1) % ADVERT_RING_SIZE;
+            advert_count--;
+        }
+        portEXIT_CRITICAL(&advert_mux);
+        if (!have) {
+            break;
+        }
+        target_estimator.on_advert(t_ms);
+        foundTarget = true;
+    }
+    target_estimator.end_window(window_ms, presence_state.present, window_aligned);
+
+    if (window_aligned) {
+        phase_misses = foundTarget ? 0 : phase_misses + 1;
+    } else if (foundTarget) {
+        phase_misses = 0; // Blind scan reacquired the beacon; lock again
+    }
+
+    if (foundTarget) {
+        unsigned long timeout = presence_timeout_ms(window_ms);
+        set_present(true);
+        presence_deadline_us = system_time_us() + (int64_t)timeout * 1000LL;
+        TimerWheel::schedule(presence_timer, timeout, on_presence_timeout, this);
+        ULOG(ULOG_INFO, "Beacon interval %.0f ms, loss %.2f, presence timeout %lu ms",
+             target_estimator.interval_ms(), target_estimator.loss_rate(), timeout);
+    }
+    if (hold_until_scan) {
+        hold_until_scan = false;
+        if (!foundTarget) {
+            set_present(false); // The wake's scan decides; the restored deadline is long gone
+            presence_deadline_us = 0;
+            ULOG(ULOG_INFO, "Beacon not seen in the first scan after wake");
+        }
+    }
 
     return foundTarget;
 }
 
 /**
- * @brief Checks if the target beacon has been seen within the configured timeout.
- *        Handles potential rollover of the millis() counter.
- * @return true if the beacon is considered present, false otherwise.
+ * @brief The timeout must outlast the windows that follow the sighting, not the one that
+ *        made it. Once the interval is learned those are aligned windows with roughly one
+ *        chance each, even when a blind scan just reacquired the beacon.
  */
-bool BLEScanner::is_present() {
-    // Check if the time elapsed since last seen is within the timeout threshold
-    unsigned long current_time = millis();
-    bool present = (current_time - last_seen_ms < PRESENCE_TIMEOUT_MS);
-
-    // Handle potential millis() rollover (overflow)
-    if (last_seen_ms > current_time) {
-        // Rollover occurred, calculate difference correctly
-        // This assumes timeout is less than the rollover period (~50 days)
-        present = ( (0xFFFFFFFF - last_seen_ms) + current_time < PRESENCE_TIMEOUT_MS );
+unsigned long BLEScanner::presence_timeout_ms(unsigned long window_ms) const {
+    float interval = target_estimator.interval_ms();
+    if (BLE_PHASE_LOCK && interval > 0) {
+        return target_estimator.timeout_ms((unsigned long)interval, scan_period_ms, true);
     }
+    return target_estimator.timeout_ms(window_ms, scan_period_ms, false);
+}
 
-    if (!present && last_seen_ms != 0) { // Avoid printing "Unavailable" right at the start
-         Serial.print("Presence timeout check: Current=");
-         Serial.print(current_time);
-         Serial.print(", LastSeen=");
-         Serial.print(last_seen_ms);
-         Serial.print(", Timeout=");
-         Serial.print(PRESENCE_TIMEOUT_MS);
-         Serial.print(", Present=");
-         Serial.println(present);
+/**
+ * @brief Presence timer callback: no sighting for PRESENCE_TIMEOUT_MS.
+ */
+void BLEScanner::on_presence_timeout(void* arg) {
+    BLEScanner* scanner = (BLEScanner*)arg;
+    scanner->set_present(false);
+    ULOG(ULOG_INFO, "Presence timeout: last seen at %lu, now %lu", scanner->last_seen_ms, millis());
+}
+
+/**
+ * @brief On battery the unit sleeps BATTERY_WAKE_INTERVAL_MS between wakes, at least as
+ *        long as any learned timeout, so the saved deadline has always passed on wake.
+ *        Presence is held instead until the wake's first scan (blind, see plan_window())
+ *        has finished, and that scan decides.
+ */
+void BLEScanner::restore_presence(bool was_present, int64_t deadline_us, float interval_ms, float loss_rate) {
+    target_estimator.restore(interval_ms, loss_rate);
+    if (POWER_MODE == POWER_MODE_BATTERY) {
+        set_present(was_present);
+        presence_deadline_us = was_present ? deadline_us : 0;
+        hold_until_scan = was_present;
+        return;
+    }
+    int64_t remaining_us = deadline_us - system_time_us();
+    set_present(was_present && remaining_us > 0);
+    presence_deadline_us = presence_state.present ? deadline_us : 0;
+    if (presence_state.present) {
+        TimerWheel::schedule(presence_timer, (unsigned long)(remaining_us / 1000), on_presence_timeout, this);
     }
+}
 
+/**
+ * @brief Checks if the target beacon has been seen within the configured timeout.
+ * @return true if the beacon is considered present, false otherwise.
+ */
+bool BLEScanner::is_present() {
+    return presence_state.present;
+}
 
-    return present;
-}
\ No newline at end of file
+void BLEScanner::set_present(bool present) {
+    if (present == presence_state.present) {
+        return; // A repeat sighting only extends the deadline
+    }
+    presence_state.present = present;
+    presence_state.changed_ms = millis();
+    presence_state.generation++;
+}
@@ -7,6 +7,20 @@
 #include <BLEScan.h>
 #include <BLEAdvertisedDevice.h>
 #include "faculty-unit/config/config.h" // Include config for constants
+#include "coro_scheduler.h" // CoEvent for scan completion
+#include "timer_wheel.h" // Presence timeout
+#include "presence_estimator.h" // Learned advertising interval and loss rate
+
+/**
+ * @brief Beacon presence as of its last change. The generation is bumped only when
+ *        presence flips, so a consumer that remembers the generation it last handled
+ *        can skip all work with one integer compare.
+ */
+struct PresenceSnapshot {
+    uint32_t generation; ///< Starts at 1, so a consumer starting from 0 handles the initial state.
+    uint32_t changed_ms; ///< millis() of the last change.
+    bool present;
+};
 
 /**
  * @brief Manages BLE scanning to detect the presence of a specific faculty beacon.
@@ -24,26 +38,128 @@ public:
     void setup_ble();
 
     /**
-     * @brief Performs a BLE scan for the configured duration.
-     *        Updates last_seen_ms if the target beacon is found.
+     * @brief Starts a BLE scan for the configured duration without blocking.
+     *        scan_done() is signaled when it finishes; then call process_results().
      * @return true if the scan was initiated successfully, false otherwise.
      */
     bool scan();
 
     /**
-     * @brief Checks if the target beacon has been seen within the configured timeout.
+     * @brief Event signaled (from the BLE task) when a scan started by scan() completes.
+     *        Usage from a coroutine: `co_await bleScanner.scan_done();`
+     */
+    CoEvent& scan_done() { return scan_complete; }
+
+    /**
+     * @brief Plans a short scan window around the target's next predicted advert
+     *        (phase-locked mode). The window widens with each consecutive miss; after
+     *        BLE_PHASE_MAX_MISSES the lock is dropped until a blind scan sees the beacon.
+     *        After restore_presence() it stays blind until the first sighting.
+     * @param earliest_ms Earliest time the window may be centred on.
+     * @param open_ms Receives when to call start_window().
+     * @param window_ms Receives how long to listen before stop_window().
+     * @return false if not phase-locked; use scan() instead.
+     */
+    bool plan_window(unsigned long earliest_ms, unsigned long* open_ms, unsigned long* window_ms);
+
+    /**
+     * @brief Starts listening for a window planned by plan_window(). Call stop_window()
+     *        when it has elapsed, then process_results().
+     */
+    bool start_window();
+    void stop_window();
+
+    /**
+     * @brief Cumulative time the radio has spent scanning, for duty-cycle reporting.
+     */
+    unsigned long radio_on_ms() const { return radio_on_total_ms; }
+
+    /**
+     * @brief Checks the completed scan's results for the target beacon and clears them.
+     *        Feeds the window's sightings to the estimator; a sighting marks the beacon
+     *        present and restarts the presence timer with the learned timeout.
+     * @return true if the target was found.
+     */
+    bool process_results();
+
+    /**
+     * @brief Whether the target beacon has been seen within the presence timeout.
+     *        Cleared by the presence timer, so this is only a flag read.
      * @return true if the beacon is considered present, false otherwise.
      */
     bool is_present();
 
+    /**
+     * @brief Versioned presence state. Updated only by sightings (process_results()), the
+     *        presence timer and restore_presence(), all of which run on the loop task.
+     */
+    const PresenceSnapshot& presence() const { return presence_state; }
+
+    /**
+     * @brief Restores presence and the learned beacon model after a warm restart or deep
+     *        sleep. A beacon that was present stays present until its saved deadline, so
+     *        presence is known immediately instead of after the first scan cycle. On
+     *        battery it stays present until the first scan after the wake has finished.
+     * @param deadline_us System time (gettimeofday, which keeps counting through resets
+     *        and deep sleep) at which the presence timeout expires.
+     */
+    void restore_presence(bool was_present, int64_t deadline_us, float interval_ms, float loss_rate);
+
+    /**
+     * @brief System time at which the current presence expires (see restore_presence()).
+     */
+    int64_t presence_deadline() const { return presence_deadline_us; }
+
+    /**
+     * @brief Number of scans or windows processed since boot.
+     */
+    unsigned long scans_completed() const { return scan_count; }
+
+    /**
+     * @brief Advertising interval / loss estimate for the target beacon.
+     */
+    const PresenceEstimator& estimator() const { return target_estimator; }
+
 private:
     unsigned long last_seen_ms; ///< Timestamp (millis) when the target beacon was last detected.
     BLEScan* pBLEScan;          ///< Pointer to the ESP32 BLE scan object.
     BLEAddress targetAddress;   ///< The MAC address of the target faculty beacon.
-    // Optional: Callback class if using asynchronous scanning
-    // class MyAdvertisedDeviceCallbacks : public BLEAdvertisedDeviceCallbacks {
-    //     void onResult(BLEAdvertisedDevice advertisedDevice) override;
-    // };
+    CoEvent scan_complete;      ///< Signaled by the scan completion callback.
+    PresenceSnapshot presence_state; ///< Set on sighting, cleared when presence_timer fires.
+    WheelTimer presence_timer;  ///< Fires one presence timeout after the last sighting.
+    PresenceEstimator target_estimator;
+    unsigned long scan_started_ms;      ///< Start of the current scan window.
+    unsigned long scan_period_ms;       ///< Measured time between the last two scan starts.
+    bool window_aligned;                ///< Current window was planned by plan_window().
+    uint8_t phase_misses;               ///< Consecutive aligned windows without a sighting.
+    unsigned long radio_on_total_ms;
+    int64_t presence_deadline_us;
+    unsigned long scan_count;
+    bool hold_until_scan;               ///< Restored presence awaiting the wake's first scan (battery).
+
+    void begin_window(bool aligned);
+    void set_present(bool present);
+    unsigned long presence_timeout_ms(unsigned long window_ms) const;
+
+    // Target sighting times, written by the BLE task and drained by process_results()
+    unsigned long advert_ring[ADVERT_RING_SIZE];
+    uint8_t advert_head;
+    uint8_t advert_count;
+    portMUX_TYPE advert_mux;
+
+    static void on_presence_timeout(void* arg);
+
+    static BLEScanner* instance; ///< Scanner receiving the (plain function) completion callback.
+    static void on_scan_complete(BLEScanResults results);
+
+    /**
+     * @brief Receives every advertisement (duplicates included) on the BLE task
+     *        and timestamps those from the target beacon.
+     */
+    class AdvertCallbacks : public BLEAdvertisedDeviceCallbacks {
+        void onResult(BLEAdvertisedDevice advertisedDevice) override;
+    };
+    AdvertCallbacks advert_callbacks;
 };
 
 #endif // BLE_SCANNER_H
\ No newline at end of file
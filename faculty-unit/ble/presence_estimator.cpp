@@ -0,0 +1,128 @@
+#include "presence_estimator.h"
+#include <math.h>
+
+#define ESTIMATOR_ALPHA 0.125f // EWMA weight of a new sample
+#define LOSS_SAMPLE_ADVERTS 8  // Windows expecting fewer adverts get proportionally less weight
+
+PresenceEstimator::PresenceEstimator()
+    : interval(0), loss(0.5f), last_advert_ms(0), window_adverts(0) {
+}
+
+/**
+ * @brief Active scans also deliver scan responses a few ms after each advert;
+ *        gaps under PRESENCE_MIN_ADV_GAP_MS (the BLE minimum interval) are ignored.
+ *        Gaps spanning scan windows are used too, so beacons slower than one window
+ *        are still learned; any multiple of the interval is divided out.
+ */
+void PresenceEstimator::on_advert(unsigned long t_ms) {
+    unsigned long gap = t_ms - last_advert_ms;
+    if (last_advert_ms != 0 && gap < PRESENCE_MIN_ADV_GAP_MS) {
+        return;
+    }
+    if (last_advert_ms != 0 && gap <= PRESENCE_TIMEOUT_MAX_MS) {
+        if (interval == 0) {
+            interval = gap;
+        } else {
+            float multiple = roundf(gap / interval);
+            if (multiple < 1) {
+                interval = gap; // Current estimate was a multiple of the real interval
+            } else {
+                interval += ESTIMATOR_ALPHA * (gap / multiple - interval);
+            }
+        }
+    }
+    last_advert_ms = t_ms;
+    window_adverts++;
+}
+
+/**
+ * @brief An empty window is only counted as loss while the beacon is still considered
+ *        present; after a departure it says nothing about the channel. A window expecting
+ *        one advert (aligned) is a single hit-or-miss sample, so it moves the estimate less;
+ *        at full weight a run of hits drags the loss, and the timeout, far below the truth.
+ */
+void PresenceEstimator::end_window(unsigned long window_ms, bool present, bool aligned) {
+    if (interval > 0 && (window_adverts > 0 || present)) {
+        float expected = expected_adverts(window_ms, aligned);
+        if (expected >= 1) {
+            float received = window_adverts < expected ? window_adverts : expected;
+            float alpha = expected < LOSS_SAMPLE_ADVERTS ? ESTIMATOR_ALPHA * expected / LOSS_SAMPLE_ADVERTS : ESTIMATOR_ALPHA;
+            loss += alpha * ((1 - received / expected) - loss);
+        }
+    }
+    window_adverts = 0;
+}
+
+/**
+ * @brief A window centred on a predicted arrival contains at least one advertising
+ *        instant by construction; a blind window of less than one interval may not.
+ */
+float PresenceEstimator::expected_adverts(unsigned long window_ms, bool aligned) const {
+    float expected = window_ms / interval;
+    if (aligned) {
+        return expected < 1 ? 1 : floorf(expected);
+    }
+    return expected;
+}
+
+float PresenceEstimator::window_miss_probability(unsigned long window_ms, bool aligned) const {
+    if (interval == 0) {
+        return 1;
+    }
+    float expected = expected_adverts(window_ms, aligned);
+    if (expected < 1) {
+        // The window may not contain an advertising instant at all
+        return 1 - expected * (1 - loss);
+    }
+    return powf(loss, floorf(expected));
+}
+
+/**
+ * @brief A present beacon is declared absent only after enough consecutive missed
+ *        windows that the chance of all of them being losses is below the target.
+ *        One extra period covers the phase of the last sighting within its window.
+ */
+unsigned long PresenceEstimator::timeout_ms(unsigned long window_ms, unsigned long period_ms, bool aligned) const {
+    if (interval == 0) {
+        return PRESENCE_TIMEOUT_MS;
+    }
+    float miss = window_miss_probability(window_ms, aligned);
+    float windows = 1;
+    if (miss >= 0.999f) {
+        return PRESENCE_TIMEOUT_MAX_MS;
+    }
+    if (miss > 0) {
+        windows = ceilf(logf(PRESENCE_FALSE_ABSENCE_TARGET) / logf(miss));
+        if (windows < 1) {
+            windows = 1;
+        }
+    }
+
+    float timeout = (windows + 1) * period_ms;
+    if (timeout < PRESENCE_TIMEOUT_MIN_MS) {
+        return PRESENCE_TIMEOUT_MIN_MS;
+    }
+    if (timeout > PRESENCE_TIMEOUT_MAX_MS) {
+        return PRESENCE_TIMEOUT_MAX_MS;
+    }
+    return (unsigned long)timeout;
+}
+
+unsigned long PresenceEstimator::predict_arrival(unsigned long after_ms, unsigned long* intervals_ahead) const {
+    float elapsed = (long)(after_ms - last_advert_ms) > 0 ? (float)(after_ms - last_advert_ms) : 0;
+    float k = ceilf(elapsed / interval);
+    if (k < 1) {
+        k = 1;
+    }
+    if (intervals_ahead != nullptr) {
+        *intervals_ahead = (unsigned long)k;
+    }
+    return last_advert_ms + (unsigned long)(k * interval);
+}
+
+void PresenceEstimator::restore(float interval_ms, float loss_rate) {
+    interval = interval_ms > 0 ? interval_ms : 0;
+    loss = loss_rate >= 0 && loss_rate <= 1 ? loss_rate : 0.5f;
+    last_advert_ms = 0;
+    window_adverts = 0;
+}
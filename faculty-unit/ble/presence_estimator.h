@@ -0,0 +1,77 @@
+#ifndef PRESENCE_ESTIMATOR_H
+#define PRESENCE_ESTIMATOR_H
+
+#include <Arduino.h>
+#include "faculty-unit/config/config.h" // Include config for constants
+
+/**
+ * @brief Online estimate of one beacon's advertising interval and packet-loss rate,
+ *        and the presence timeout they imply.
+ *
+ * Feed it every advertisement seen during a scan window (on_advert()) and close the
+ * window with end_window(). Gaps between adverts are divided by the nearest whole
+ * number of intervals, so missed packets do not inflate the interval estimate.
+ */
+class PresenceEstimator {
+public:
+    PresenceEstimator();
+
+    /**
+     * @brief Records one advertisement received at `t_ms` in the current scan window.
+     */
+    void on_advert(unsigned long t_ms);
+
+    /**
+     * @brief Closes the current scan window and updates the loss estimate from the
+     *        number of adverts received versus the number expected.
+     * @param window_ms How long the radio was listening.
+     * @param present Whether the beacon was still considered present during the window.
+     * @param aligned Whether the window was centred on a predicted arrival (phase-locked).
+     */
+    void end_window(unsigned long window_ms, bool present, bool aligned = false);
+
+    /**
+     * @brief Presence timeout giving a false-absence probability of at most
+     *        PRESENCE_FALSE_ABSENCE_TARGET, clamped to
+     *        [PRESENCE_TIMEOUT_MIN_MS, PRESENCE_TIMEOUT_MAX_MS].
+     *        Returns PRESENCE_TIMEOUT_MS until an interval has been learned.
+     * @param window_ms Scan window length.
+     * @param period_ms Time between scan window starts.
+     * @param aligned Whether windows are centred on predicted arrivals (phase-locked).
+     */
+    unsigned long timeout_ms(unsigned long window_ms, unsigned long period_ms, bool aligned = false) const;
+
+    /**
+     * @brief Probability that a whole scan window of `window_ms` sees no advert
+     *        from a beacon that is present.
+     */
+    float window_miss_probability(unsigned long window_ms, bool aligned = false) const;
+
+    /**
+     * @brief First predicted advertising instant after `after_ms`, extrapolated from the
+     *        last advert by whole intervals. Only meaningful once an interval is learned.
+     * @param intervals_ahead Receives how many intervals were extrapolated (may be nullptr).
+     */
+    unsigned long predict_arrival(unsigned long after_ms, unsigned long* intervals_ahead) const;
+
+    /**
+     * @brief Reloads a previously learned interval and loss rate (e.g. after a warm restart).
+     *        The advertising phase is not kept (last_advert() is 0), so the next sighting
+     *        re-establishes it; predict_arrival() is meaningless until then.
+     */
+    void restore(float interval_ms, float loss_rate);
+
+    float interval_ms() const { return interval; } ///< 0 until learned.
+    float loss_rate() const { return loss; }
+    unsigned long last_advert() const { return last_advert_ms; }
+
+private:
+    float expected_adverts(unsigned long window_ms, bool aligned) const;
+
+    float interval;                 ///< EWMA advertising interval (ms), 0 = unknown.
+    float loss;                     ///< EWMA fraction of adverts not received.
+    unsigned long last_advert_ms;   ///< Previous advert (0 = none yet).
+    uint16_t window_adverts;        ///< Adverts counted in the current window.
+};
+
+#endif // PRESENCE_ESTIMATOR_H
@@ -0,0 +1,63 @@
+#include "status_advertiser.h"
+#include "status_datagram.h" // status_code_from_name(), the codes the multicast datagram uses
+#include <BLEDevice.h>
+#include <esp_gap_ble_api.h>
+
+#define ADV_PAYLOAD_LEN 15
+
+static uint32_t facultyHash = 0;
+static uint8_t lastState = 0xFF;  // Impossible value forces the first write
+static uint8_t lastDepth = 0xFF;
+static uint8_t changeCounter = 0;
+static bool advertising = false;
+
+bool StatusAdvertiser::begin() {
+    if (!BLEDevice::getInitialized()) {
+        Serial.println("Status advertiser: BLE not initialized.");
+        return false;
+    }
+
+    // FNV-1a, so phones can match a unit without the full ID on air
+    facultyHash = 2166136261u;
+    for (const char* p = FACULTY_ID; *p != '\0'; p++) {
+        facultyHash = (facultyHash ^ (uint8_t)*p) * 16777619u;
+    }
+
+    esp_ble_adv_params_t params = {};
+    params.adv_int_min = BLE_STATUS_ADV_INTERVAL_MS * 1000 / 625; // 0.625 ms units
+    params.adv_int_max = params.adv_int_min;
+    params.adv_type = ADV_TYPE_NONCONN_IND;
+    params.own_addr_type = BLE_ADDR_TYPE_PUBLIC;
+    params.channel_map = ADV_CHNL_ALL;
+    params.adv_filter_policy = ADV_FILTER_ALLOW_SCAN_ANY_CON_ANY;
+
+    update(false, "", 0); // Data must be set before advertising starts
+    advertising = esp_ble_gap_start_advertising(&params) == ESP_OK;
+    Serial.println(advertising ? "Status advertiser started." : "Status advertiser failed to start.");
+    return advertising;
+}
+
+/**
+ * @brief Raw advertisement data avoids the heap-allocating BLEAdvertisementData helpers;
+ *        the controller accepts new data while already advertising.
+ */
+void StatusAdvertiser::update(bool present, const char* status, uint16_t inbox_depth) {
+    uint8_t state = (present ? 1 : 0) | (status_code_from_name(status) << 1);
+    uint8_t depth = inbox_depth > 0xFE ? 0xFE : inbox_depth;
+    if (state == lastState && depth == lastDepth) {
+        return;
+    }
+    lastState = state;
+    lastDepth = depth;
+    changeCounter++;
+
+    uint8_t payload[ADV_PAYLOAD_LEN] = {
+        0x02, ESP_BLE_AD_TYPE_FLAG, ESP_BLE_ADV_FLAG_GEN_DISC | ESP_BLE_ADV_FLAG_BREDR_NOT_SPT,
+        ADV_PAYLOAD_LEN - 4, ESP_BLE_AD_MANUFACTURER_SPECIFIC_TYPE,
+        (uint8_t)(BLE_STATUS_COMPANY_ID & 0xFF), (uint8_t)(BLE_STATUS_COMPANY_ID >> 8),
+        BLE_STATUS_FORMAT_VERSION,
+        (uint8_t)facultyHash, (uint8_t)(facultyHash >> 8), (uint8_t)(facultyHash >> 16), (uint8_t)(facultyHash >> 24),
+        state, depth, changeCounter,
+    };
+    esp_ble_gap_config_adv_data_raw(payload, sizeof(payload));
+}
@@ -0,0 +1,36 @@
+#ifndef STATUS_ADVERTISER_H
+#define STATUS_ADVERTISER_H
+
+#include <Arduino.h>
+#include "faculty-unit/config/config.h" // Include config for constants
+
+/**
+ * @brief Broadcasts the unit's status in a non-connectable BLE advertisement so nearby
+ *        phones can read it without going through the broker.
+ *
+ * Payload (manufacturer-specific data, little-endian company ID BLE_STATUS_COMPANY_ID):
+ *   [0]    format version (BLE_STATUS_FORMAT_VERSION)
+ *   [1..4] FNV-1a hash of FACULTY_ID, little-endian
+ *   [5]    bit 0 = beacon present, bits 1-2 = manual status (StatusCode, as in the multicast datagram)
+ *   [6]    pending requests (inbox depth)
+ *   [7]    change counter, incremented on every update
+ *
+ * Shares the BLE stack BLEScanner initializes; the controller interleaves advertising
+ * with scanning.
+ */
+class StatusAdvertiser {
+public:
+    /**
+     * @brief Starts advertising. Call after BLEScanner::setup_ble().
+     * @return false if the BLE stack is not initialized.
+     */
+    static bool begin();
+
+    /**
+     * @brief Rewrites the advertisement data if any field changed. Cheap when nothing did,
+     *        so it can be called every loop pass.
+     */
+    static void update(bool present, const char* status, uint16_t inbox_depth);
+};
+
+#endif // STATUS_ADVERTISER_H
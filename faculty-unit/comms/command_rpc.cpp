@@ -0,0 +1,112 @@
+#include "command_rpc.h"
+#include "mqtt_handler.h"  // Publishes the results
+#include "message_arena.h" // Payload copy and parse pool
+#include "unit_log.h"      // Sampled Serial/MQTT logging
+
+static const CommandEntry* commandTable = nullptr;
+static size_t commandCount = 0;
+static char resultTopic[100];
+
+static StaticJsonDocument<JSON_COMMAND_RESULT_DOC_SIZE> resultDoc;
+static char resultPayload[COMMAND_RESULT_LEN];
+
+static unsigned long succeeded = 0;
+static unsigned long failed = 0;
+
+static const CommandEntry* find_command(const char* name) {
+    uint32_t hash = command_hash(name);
+    for (size_t i = 0; i < commandCount; i++) {
+        if (commandTable[i].hash == hash) {
+            // One comparison to reject a colliding unknown name
+            return strcmp(commandTable[i].name, name) == 0 ? &commandTable[i] : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Runs one command and fills in its result entry.
+ */
+static void run_command(JsonObjectConst command, JsonObject result) {
+    result["id"] = command["id"];
+
+    const char* error = nullptr;
+    const char* name = command["command"];
+    const CommandEntry* entry = name != nullptr ? find_command(name) : nullptr;
+    if (name == nullptr) {
+        error = "missing_command";
+    } else if (entry == nullptr) {
+        error = "unknown_command";
+    } else {
+        error = entry->handler(command, result);
+    }
+
+    result["ok"] = error == nullptr;
+    if (error != nullptr) {
+        result["error"] = error;
+        failed++;
+    } else {
+        succeeded++;
+    }
+}
+
+void CommandRpc::begin(const char* faculty_id, const CommandEntry* table, size_t count) {
+    commandTable = table;
+    commandCount = count;
+    snprintf(resultTopic, sizeof(resultTopic), MQTT_COMMAND_RESULT_TOPIC_TEMPLATE, faculty_id);
+}
+
+void CommandRpc::handle(const byte* payload, unsigned int length) {
+    // Parsed in place from an arena copy; strings in the results point into it
+    char* message = MessageArena::copy_string(payload, length);
+    if (message == nullptr) {
+        return; // Overflow already reported by the arena
+    }
+    BasicJsonDocument<MessageArenaAllocator> doc(JSON_COMMAND_DOC_SIZE);
+    DeserializationError error = deserializeJson(doc, message);
+
+    resultDoc.clear();
+    JsonArray results = resultDoc.createNestedArray("results");
+
+    if (error) {
+        ULOG(ULOG_WARN, "Command batch: deserializeJson() failed: %s", error.c_str());
+        resultDoc["error"] = "parse_error";
+    } else {
+        resultDoc["batch_id"] = doc["batch_id"];
+        JsonArrayConst commands = doc["commands"];
+        if (!commands.isNull()) {
+            // Commands past the limit are not run and get no entry of their own, so the
+            // result document stays sized for COMMAND_BATCH_MAX however long the batch is
+            size_t index = 0;
+            for (JsonObjectConst command : commands) {
+                if (index++ < COMMAND_BATCH_MAX) {
+                    run_command(command, results.createNestedObject());
+                }
+            }
+            if (index > COMMAND_BATCH_MAX) {
+                resultDoc["skipped"] = index - COMMAND_BATCH_MAX;
+                resultDoc["error"] = "batch_limit";
+                failed += index - COMMAND_BATCH_MAX;
+            }
+        } else {
+            run_command(doc.as<JsonObjectConst>(), results.createNestedObject()); // Single legacy command
+        }
+    }
+
+    if (resultDoc.overflowed() || measureJson(resultDoc) >= sizeof(resultPayload)) {
+        // Too many or too large results; the commands ran, report that much
+        resultDoc.clear();
+        resultDoc["batch_id"] = doc["batch_id"];
+        resultDoc["error"] = "result_overflow";
+    }
+    serializeJson(resultDoc, resultPayload, sizeof(resultPayload));
+    publish_message(resultTopic, resultPayload, false);
+}
+
+unsigned long CommandRpc::succeeded_count() {
+    return succeeded;
+}
+
+unsigned long CommandRpc::failed_count() {
+    return failed;
+}
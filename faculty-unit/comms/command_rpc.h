@@ -0,0 +1,80 @@
+#ifndef COMMAND_RPC_H
+#define COMMAND_RPC_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "config.h"
+
+/**
+ * @brief Runs one command. `args` is the command object itself; `result` is this
+ *        command's entry in the response and may be given extra fields.
+ * @return nullptr on success, otherwise a short error code such as "invalid_status".
+ */
+typedef const char* (*COMMAND_HANDLER_SIGNATURE)(JsonObjectConst args, JsonObject result);
+
+/**
+ * @brief FNV-1a hash of a command name, evaluated at compile time for the dispatch table.
+ */
+constexpr uint32_t command_hash(const char* name, uint32_t hash = 2166136261UL) {
+    return *name == '\0' ? hash : command_hash(name + 1, (hash ^ (uint8_t)*name) * 16777619UL);
+}
+
+/**
+ * @brief One dispatch table row. The name's hash is computed when the table is built,
+ *        so a lookup hashes the incoming name once and compares integers.
+ */
+struct CommandEntry {
+    const char* name;
+    uint32_t hash;
+    COMMAND_HANDLER_SIGNATURE handler;
+
+    constexpr CommandEntry(const char* command_name, COMMAND_HANDLER_SIGNATURE command_handler)
+        : name(command_name), hash(command_hash(command_name)), handler(command_handler) {}
+};
+
+/**
+ * @brief For static_assert next to a dispatch table: no two commands share a hash.
+ */
+template <size_t N>
+constexpr bool command_hashes_unique(const CommandEntry (&table)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = i + 1; j < N; j++) {
+            if (table[i].hash == table[j].hash) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Static command RPC channel on MQTT_COMMAND_TOPIC_TEMPLATE.
+ *
+ * A message carries a batch, {"batch_id": "b1", "commands": [{"id": "c1",
+ * "command": "set_status", "status": "busy"}, ...]}, and one response is published
+ * to MQTT_COMMAND_RESULT_TOPIC_TEMPLATE: {"batch_id": "b1", "results": [{"id": "c1",
+ * "ok": true, ...}, ...]}, in command order. A bare {"command": ...} object is treated
+ * as a batch of one. Commands past COMMAND_BATCH_MAX are not run; the response then
+ * carries "error": "batch_limit" and "skipped": <count> instead of entries for them.
+ */
+class CommandRpc {
+public:
+    /**
+     * @brief Sets the dispatch table (usually a constexpr array) and the reply topic.
+     */
+    static void begin(const char* faculty_id, const CommandEntry* table, size_t count);
+
+    /**
+     * @brief Parses a command message, runs every command in order and publishes the
+     *        batched results. Call from the MQTT callback, inside a MessageArena scope.
+     */
+    static void handle(const byte* payload, unsigned int length);
+
+    /**
+     * @brief Commands run successfully / rejected since boot.
+     */
+    static unsigned long succeeded_count();
+    static unsigned long failed_count();
+};
+
+#endif // COMMAND_RPC_H
@@ -0,0 +1,139 @@
+#include "compressed_text.h"
+
+namespace {
+
+/**
+ * @brief Pulls bits MSB-first out of a base64 string without decoding it up front.
+ */
+class Base64BitReader {
+public:
+    explicit Base64BitReader(const char* src) : p(src), acc(0), nbits(0), bad(false) {}
+
+    /**
+     * @brief Reads `count` bits (count <= 16).
+     * @return true if enough bits were available.
+     */
+    bool read(uint8_t count, uint16_t& value) {
+        while (nbits < count) {
+            int v = sextet();
+            if (v < 0) {
+                return false;
+            }
+            acc = (acc << 6) | (uint32_t)v;
+            nbits += 6;
+        }
+        nbits -= count;
+        value = (acc >> nbits) & ((1u << count) - 1);
+        return true;
+    }
+
+    bool malformed() const { return bad; }
+
+private:
+    int sextet() {
+        char c = *p;
+        if (c == '\0' || c == '=') {
+            return -1;
+        }
+        p++;
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+') return 62;
+        if (c == '/') return 63;
+        bad = true;
+        return -1;
+    }
+
+    const char* p;
+    uint32_t acc;  ///< Bit accumulator.
+    uint8_t nbits; ///< Unread bits in acc.
+    bool bad;
+};
+
+} // namespace
+
+/**
+ * @brief Heatshrink stream layout: tag bit 1 + 8-bit literal, or tag bit 0 +
+ *        (offset - 1) in WINDOW bits + (count - 1) in LOOKAHEAD bits.
+ *        Trailing bits that cannot form a whole token are the encoder's padding.
+ *        Decoding stops at the first byte that does not fit; the rest of the stream is not read.
+ */
+bool decode_heatshrink_base64(const char* b64, char* out, size_t out_size, size_t* out_len, bool* truncated) {
+    if (b64 == nullptr || out == nullptr || out_size == 0) {
+        return false;
+    }
+
+    Base64BitReader reader(b64);
+    size_t len = 0;
+    const size_t limit = out_size - 1; // Leave room for the terminator
+    bool cut = false;
+    uint16_t tag, value, count;
+
+    while (!cut && reader.read(1, tag)) {
+        if (tag) {
+            if (!reader.read(8, value)) {
+                break;
+            }
+            if (len >= limit) {
+                cut = true;
+                break;
+            }
+            out[len++] = (char)value;
+        } else {
+            if (!reader.read(HEATSHRINK_WINDOW_BITS, value) ||
+                !reader.read(HEATSHRINK_LOOKAHEAD_BITS, count)) {
+                break;
+            }
+            size_t offset = (size_t)value + 1;
+            size_t n = (size_t)count + 1;
+            if (offset > len) {
+                return false;
+            }
+            if (len + n > limit) {
+                n = limit - len;
+                cut = true;
+            }
+            // Byte-by-byte so overlapping references (offset < n) repeat correctly
+            for (size_t i = 0; i < n; i++, len++) {
+                out[len] = out[len - offset];
+            }
+        }
+    }
+
+    if (reader.malformed()) {
+        return false;
+    }
+    out[len] = '\0';
+    if (out_len != nullptr) {
+        *out_len = len;
+    }
+    if (truncated != nullptr) {
+        *truncated = cut;
+    }
+    return true;
+}
+
+bool decode_base64(const char* b64, uint8_t* out, size_t out_size, size_t* out_len) {
+    if (b64 == nullptr || out == nullptr) {
+        return false;
+    }
+
+    Base64BitReader reader(b64);
+    size_t len = 0;
+    uint16_t value;
+    while (reader.read(8, value)) {
+        if (len >= out_size) {
+            return false;
+        }
+        out[len++] = (uint8_t)value;
+    }
+
+    if (reader.malformed()) {
+        return false;
+    }
+    if (out_len != nullptr) {
+        *out_len = len;
+    }
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef COMPRESSED_TEXT_H
+#define COMPRESSED_TEXT_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @brief Decodes a base64-wrapped heatshrink (LZSS) stream into a text buffer.
+ *
+ * Base64 characters are consumed a few bits at a time and fed straight into the
+ * LZSS state machine, so no intermediate binary buffer is needed. Back-references
+ * are resolved against the output buffer itself, which therefore doubles as the
+ * decompression window. Window/lookahead sizes are HEATSHRINK_WINDOW_BITS and
+ * HEATSHRINK_LOOKAHEAD_BITS and must match the central system's encoder.
+ *
+ * @param b64 Null-terminated base64 string (standard alphabet, '=' padding optional).
+ * Text longer than out_size - 1 is cut off there, the way plain request_text is
+ * truncated when it is copied into the inbox.
+ *
+ * @param out Destination buffer; always null-terminated on success.
+ * @param out_size Size of out in bytes, including the terminator.
+ * @param out_len Receives the decoded length (may be nullptr).
+ * @param truncated Set to whether the text was cut off (may be nullptr).
+ * @return true on success (including truncation), false if the input is malformed.
+ */
+bool decode_heatshrink_base64(const char* b64, char* out, size_t out_size, size_t* out_len,
+                              bool* truncated = nullptr);
+
+/**
+ * @brief Decodes plain base64 into a byte buffer, using the same streaming reader.
+ * @param out_len Receives the decoded length (may be nullptr).
+ * @return false if the input is malformed or does not fit in out_size bytes.
+ */
+bool decode_base64(const char* b64, uint8_t* out, size_t out_size, size_t* out_len);
+
+#endif // COMPRESSED_TEXT_H
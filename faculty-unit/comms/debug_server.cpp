@@ -0,0 +1,334 @@
+#include "debug_server.h"
+#include "timer_wheel.h"   // Metrics refresh timer
+#include "unit_log.h"      // Sampled Serial/MQTT logging
+#include <esp_http_server.h>
+#include <lwip/sockets.h> // close() in the session close hook
+#include <ArduinoJson.h>   // WebSocket event frames
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+struct WsFrame {
+    char text[DEBUG_WS_FRAME_LEN];
+    size_t len;
+    volatile bool busy; ///< Set by the loop task when queued, cleared by the server task once sent
+};
+
+static httpd_handle_t server = nullptr;
+static METRICS_RENDER_SIGNATURE renderMetrics = nullptr;
+
+// Latest /metrics text, swapped in under metricsMux. The loop task renders into
+// renderBuffer and the server task copies out into sendBuffer, so neither holds
+// the lock for more than a memcpy.
+static char renderBuffer[DEBUG_HTTP_METRICS_LEN];
+static char metricsText[DEBUG_HTTP_METRICS_LEN];
+static char sendBuffer[DEBUG_HTTP_METRICS_LEN];
+static size_t metricsLen = 0;
+static portMUX_TYPE metricsMux = portMUX_INITIALIZER_UNLOCKED;
+static WheelTimer refreshTimer; // Active until the next render is due
+
+// The event stream exists only with a token configured
+static const bool eventsEnabled = sizeof(DEBUG_HTTP_EVENTS_TOKEN) > 1;
+static char eventsSession; // Its address tags the sockets that passed the token check
+
+static WsFrame frames[DEBUG_WS_FRAME_SLOTS];
+static QueueHandle_t pushQueue = nullptr; // Slot indices waiting for the server task
+static StaticJsonDocument<DEBUG_WS_FRAME_LEN> eventDoc;
+
+// Loop latency since the last render
+static unsigned long passMaxUs = 0;
+static unsigned long passSumUs = 0;
+static unsigned long passCount = 0;
+static unsigned long passTotal = 0;
+
+// Written by the server task, read by the loop task when rendering
+static volatile unsigned long scrapes = 0;
+static volatile unsigned long openSockets = 0;
+static volatile unsigned long wsClients = 0;
+static volatile unsigned long wsFramesSent = 0;
+static volatile unsigned long wsSendFailures = 0;
+static unsigned long wsFramesDropped = 0; // Loop task only
+
+void MetricsWriter::append(const char* type, const char* name, const char* value) {
+    int n = snprintf(buf + len, cap - len, "# TYPE %s %s\n%s %s\n", name, type, name, value);
+    if (n < 0 || (size_t)n >= cap - len) {
+        buf[len] = '\0'; // Drop the partial sample
+        overflow++;
+        return;
+    }
+    len += n;
+}
+
+void MetricsWriter::gauge(const char* name, double value) {
+    char text[24];
+    snprintf(text, sizeof(text), "%.6g", value);
+    append("gauge", name, text);
+}
+
+void MetricsWriter::counter(const char* name, unsigned long value) {
+    char text[12];
+    snprintf(text, sizeof(text), "%lu", value);
+    append("counter", name, text);
+}
+
+static esp_err_t metrics_handler(httpd_req_t* req) {
+    portENTER_CRITICAL(&metricsMux);
+    size_t len = metricsLen;
+    memcpy(sendBuffer, metricsText, len);
+    portEXIT_CRITICAL(&metricsMux);
+
+    scrapes = scrapes + 1;
+    httpd_resp_set_type(req, "text/plain; version=0.0.4");
+    return httpd_resp_send(req, sendBuffer, len);
+}
+
+/**
+ * @brief Compares every byte, so the time taken does not reveal how much of a guess matched.
+ */
+static bool events_token_valid(httpd_req_t* req) {
+    char query[96];
+    char token[sizeof(DEBUG_HTTP_EVENTS_TOKEN)];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK ||
+        httpd_query_key_value(query, "token", token, sizeof(token)) != ESP_OK) {
+        return false; // Missing, or longer than the token (truncated)
+    }
+    const char* expected = DEBUG_HTTP_EVENTS_TOKEN;
+    if (strlen(token) != strlen(expected)) {
+        return false;
+    }
+    uint8_t diff = 0;
+    for (size_t i = 0; expected[i] != '\0'; i++) {
+        diff |= token[i] ^ expected[i];
+    }
+    return diff == 0;
+}
+
+static void keep_session_ctx(void*) {
+    // eventsSession is static; nothing to free
+}
+
+/**
+ * @brief WebSocket endpoint. A handshake without the right ?token= is closed at once,
+ *        and only sockets tagged here receive frames. The stream is one-way; anything a
+ *        client sends is read and discarded (control frames are answered by the server itself).
+ */
+static esp_err_t events_handler(httpd_req_t* req) {
+    if (req->method == HTTP_GET) {
+        if (!events_token_valid(req)) {
+            return ESP_FAIL; // Closes the socket
+        }
+        req->sess_ctx = &eventsSession;
+        req->free_ctx = keep_session_ctx;
+        return ESP_OK; // Handshake complete
+    }
+    uint8_t discard[64];
+    httpd_ws_frame_t frame = {};
+    esp_err_t err = httpd_ws_recv_frame(req, &frame, 0); // Reads the header only
+    if (err != ESP_OK || frame.len > sizeof(discard)) {
+        return ESP_FAIL; // Closes the socket
+    }
+    frame.payload = discard;
+    return frame.len > 0 ? httpd_ws_recv_frame(req, &frame, frame.len) : ESP_OK;
+}
+
+static esp_err_t on_open(httpd_handle_t, int) {
+    openSockets = openSockets + 1;
+    return ESP_OK;
+}
+
+static void on_close(httpd_handle_t, int fd) {
+    openSockets = openSockets - 1;
+    close(fd);
+}
+
+/**
+ * @brief Runs on the server task (httpd_queue_work): sends one frame to every
+ *        WebSocket client, then frees its slot. A client that cannot take the frame
+ *        within DEBUG_HTTP_SEND_TIMEOUT_S is closed.
+ */
+static void broadcast_work(void* arg) {
+    WsFrame& slot = frames[(uintptr_t)arg];
+    int fds[DEBUG_HTTP_MAX_CLIENTS];
+    size_t count = DEBUG_HTTP_MAX_CLIENTS;
+    unsigned long clients = 0;
+
+    if (httpd_get_client_list(server, &count, fds) == ESP_OK) {
+        httpd_ws_frame_t frame = {};
+        frame.type = HTTPD_WS_TYPE_TEXT;
+        frame.final = true;
+        frame.payload = (uint8_t*)slot.text;
+        frame.len = slot.len;
+        for (size_t i = 0; i < count; i++) {
+            if (httpd_ws_get_fd_info(server, fds[i]) != HTTPD_WS_CLIENT_WEBSOCKET ||
+                httpd_sess_get_ctx(server, fds[i]) != &eventsSession) {
+                continue;
+            }
+            clients++;
+            if (httpd_ws_send_frame_async(server, fds[i], &frame) == ESP_OK) {
+                wsFramesSent = wsFramesSent + 1;
+            } else {
+                wsSendFailures = wsSendFailures + 1;
+                httpd_sess_trigger_close(server, fds[i]);
+            }
+        }
+    }
+    wsClients = clients;
+    slot.busy = false;
+}
+
+/**
+ * @brief Hands queued frames to the server task. httpd_queue_work() talks to the
+ *        server over a socket, which allocates inside lwIP; doing it here keeps
+ *        those allocations off the loop task.
+ */
+static void push_task(void*) {
+    for (;;) {
+        uint8_t index;
+        if (xQueueReceive(pushQueue, &index, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        if (httpd_queue_work(server, broadcast_work, (void*)(uintptr_t)index) != ESP_OK) {
+            frames[index].busy = false;
+        }
+    }
+}
+
+/**
+ * @brief Serializes eventDoc into a free frame slot and queues it. Loop task only.
+ */
+static void push_event_doc() {
+    for (uint8_t i = 0; i < DEBUG_WS_FRAME_SLOTS; i++) {
+        WsFrame& slot = frames[i];
+        if (slot.busy) {
+            continue;
+        }
+        slot.len = serializeJson(eventDoc, slot.text, sizeof(slot.text));
+        slot.busy = true;
+        if (xQueueSend(pushQueue, &i, 0) != pdTRUE) {
+            slot.busy = false;
+            wsFramesDropped++;
+        }
+        return;
+    }
+    wsFramesDropped++; // Every slot still in flight (slow clients)
+}
+
+static void on_event(const Event& event) {
+    eventDoc.clear();
+    eventDoc["ms"] = millis();
+    switch (event.type) {
+    case EVENT_PRESENCE_CHANGED:
+        eventDoc["type"] = "presence";
+        eventDoc["present"] = event.presence.present;
+        break;
+    case EVENT_STATUS_CHANGED:
+        eventDoc["type"] = "status";
+        eventDoc["status"] = (const char*)event.status.status;
+        break;
+    case EVENT_REQUEST_SHOW:
+        eventDoc["type"] = "request"; // Timing only: the stream is not the place for student data
+        eventDoc["priority"] = event.request.priority;
+        eventDoc["queued_ms"] = millis() - event.request.received_ms;
+        break;
+    default:
+        return;
+    }
+    push_event_doc();
+}
+
+static void render() {
+    MetricsWriter out(renderBuffer, sizeof(renderBuffer));
+    out.gauge("unit_uptime_seconds", millis() / 1000.0);
+    out.counter("unit_loop_passes_total", passTotal);
+    out.gauge("unit_loop_pass_max_us", passMaxUs);
+    out.gauge("unit_loop_pass_avg_us", passCount > 0 ? (double)passSumUs / passCount : 0);
+    out.gauge("unit_http_open_sockets", openSockets);
+    out.counter("unit_http_scrapes_total", scrapes);
+    out.gauge("unit_ws_clients", wsClients);
+    out.counter("unit_ws_frames_sent_total", wsFramesSent);
+    out.counter("unit_ws_frames_dropped_total", wsFramesDropped);
+    out.counter("unit_ws_send_failures_total", wsSendFailures);
+    if (renderMetrics != nullptr) {
+        renderMetrics(out);
+    }
+    if (out.overflowed() > 0) {
+        ULOG(ULOG_WARN, "Metrics: samples dropped, raise DEBUG_HTTP_METRICS_LEN: %lu", out.overflowed());
+    }
+
+    portENTER_CRITICAL(&metricsMux);
+    memcpy(metricsText, renderBuffer, out.length());
+    metricsLen = out.length();
+    portEXIT_CRITICAL(&metricsMux);
+
+    passMaxUs = 0;
+    passSumUs = 0;
+    passCount = 0;
+}
+
+bool DebugServer::begin(METRICS_RENDER_SIGNATURE render_fn) {
+    renderMetrics = render_fn;
+
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = DEBUG_HTTP_PORT;
+    config.max_open_sockets = DEBUG_HTTP_MAX_CLIENTS;
+    config.lru_purge_enable = true;        // A new client evicts the least recently used one
+    config.core_id = 0;                    // Away from the loop task on core 1
+    config.task_priority = tskIDLE_PRIORITY + 1;
+    config.send_wait_timeout = DEBUG_HTTP_SEND_TIMEOUT_S;
+    config.recv_wait_timeout = DEBUG_HTTP_SEND_TIMEOUT_S;
+    config.max_uri_handlers = 2;
+    config.open_fn = on_open;
+    config.close_fn = on_close;
+
+    if (httpd_start(&server, &config) != ESP_OK) {
+        Serial.println(F("Debug HTTP server failed to start."));
+        server = nullptr;
+        return false;
+    }
+
+    httpd_uri_t metrics = {};
+    metrics.uri = "/metrics";
+    metrics.method = HTTP_GET;
+    metrics.handler = metrics_handler;
+    httpd_register_uri_handler(server, &metrics);
+
+    if (eventsEnabled) {
+        httpd_uri_t events = {};
+        events.uri = "/events";
+        events.method = HTTP_GET;
+        events.handler = events_handler;
+        events.is_websocket = true;
+        httpd_register_uri_handler(server, &events);
+
+        pushQueue = xQueueCreate(DEBUG_WS_FRAME_SLOTS, sizeof(uint8_t));
+        xTaskCreatePinnedToCore(push_task, "ws_push", 3072, nullptr, tskIDLE_PRIORITY + 1, nullptr, 0);
+
+        EventBus::subscribe(EVENT_PRESENCE_CHANGED, EVENT_TASK_LOOP, on_event);
+        EventBus::subscribe(EVENT_STATUS_CHANGED, EVENT_TASK_LOOP, on_event);
+        EventBus::subscribe(EVENT_REQUEST_SHOW, EVENT_TASK_LOOP, on_event);
+    }
+
+    render();
+    TimerWheel::schedule(refreshTimer, DEBUG_HTTP_REFRESH_MS, nullptr, nullptr);
+
+    Serial.print(F("Debug HTTP server on port "));
+    Serial.println(DEBUG_HTTP_PORT);
+    return true;
+}
+
+void DebugServer::service() {
+    if (server == nullptr || refreshTimer.active()) {
+        return;
+    }
+    TimerWheel::schedule(refreshTimer, DEBUG_HTTP_REFRESH_MS, nullptr, nullptr);
+    render();
+}
+
+void DebugServer::record_loop_pass(unsigned long busy_us) {
+    passTotal++;
+    passCount++;
+    passSumUs += busy_us;
+    if (busy_us > passMaxUs) {
+        passMaxUs = busy_us;
+    }
+}
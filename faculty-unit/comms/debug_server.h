@@ -0,0 +1,71 @@
+#ifndef DEBUG_SERVER_H
+#define DEBUG_SERVER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "event_bus.h" // Events pushed to WebSocket clients
+
+/**
+ * @brief Appends Prometheus text-format samples to a fixed buffer. Samples that do
+ *        not fit are dropped and counted, never truncated mid-line.
+ */
+class MetricsWriter {
+public:
+    MetricsWriter(char* buffer, size_t size) : buf(buffer), cap(size), len(0), overflow(0) { buf[0] = '\0'; }
+
+    void gauge(const char* name, double value);
+    void counter(const char* name, unsigned long value);
+
+    size_t length() const { return len; }
+    unsigned long overflowed() const { return overflow; }
+
+private:
+    void append(const char* type, const char* name, const char* value);
+
+    char* buf;
+    size_t cap;
+    size_t len;
+    unsigned long overflow;
+};
+
+typedef void (*METRICS_RENDER_SIGNATURE)(MetricsWriter& out);
+
+/**
+ * @brief Static debug HTTP server (ESP-IDF esp_http_server) on DEBUG_HTTP_PORT.
+ *
+ * GET /metrics returns Prometheus text. The loop task renders it into a preallocated
+ * buffer every DEBUG_HTTP_REFRESH_MS; the server task only copies the latest render,
+ * so a scrape never reads module state or waits for the loop.
+ *
+ * GET /events?token=DEBUG_HTTP_EVENTS_TOKEN upgrades to a WebSocket that receives one
+ * JSON text frame per presence, status and request event (requests carry priority and
+ * timing, never the student). Without a configured token there is no /events. Frames
+ * come from DEBUG_WS_FRAME_SLOTS preallocated slots; when all are in flight new events
+ * are dropped and counted rather than queued.
+ *
+ * The server runs on core 0 at the lowest priority, below the BLE, Wi-Fi and lwIP
+ * tasks, and accepts at most DEBUG_HTTP_MAX_CLIENTS sockets, closing the least
+ * recently used one when full.
+ */
+class DebugServer {
+public:
+    /**
+     * @brief Starts the server and subscribes to the pushed events. Call from setup()
+     *        after Wi-Fi and the event bus are up.
+     * @param render Fills in the firmware metrics; called on the loop task.
+     * @return false if the server could not start.
+     */
+    static bool begin(METRICS_RENDER_SIGNATURE render);
+
+    /**
+     * @brief Re-renders /metrics when DEBUG_HTTP_REFRESH_MS has passed. Call from loop().
+     */
+    static void service();
+
+    /**
+     * @brief Records the busy time of one loop() pass, reported as loop latency.
+     */
+    static void record_loop_pass(unsigned long busy_us);
+};
+
+#endif // DEBUG_SERVER_H
@@ -3,7 +3,17 @@
 #include <WiFi.h> // Needed for WiFi.macAddress()
 #include <string.h> // For strncpy
 #include <ArduinoJson.h> // For JSON parsing
-#include "display_manager.h" // For calling display functions
+#include "asset_store.h"     // QOI asset uploads
+#include "event_bus.h"       // Hands due requests to the display
+#include "rate_limiter.h"    // Per-student request throttling
+#include "request_inbox.h"   // Pending request queue
+#include "compressed_text.h" // Heatshrink request text decoding
+#include "request_bitmaps.h" // Pre-rasterized request text
+#include "message_arena.h"   // Per-message scratch memory
+#include "timer_wheel.h"     // Dwell, coalescing and poll timers
+#include "warm_restart.h"    // Pending requests survive resets
+#include "directory_board.h"  // Hallway board status table
+#include "unit_log.h"         // Sampled Serial/MQTT logging
 
 // Global WiFi and MQTT client instances
 WiFiClient espClient;
@@ -18,14 +28,70 @@ MQTT_CALLBACK_SIGNATURE mqttCallback = NULL;
 // Buffer for constructing MQTT topics
 char topicBuffer[100]; // Adjust size as needed
 
+// Asset upload topic with the trailing '+' removed, for prefix matching in the callback
+char assetTopicPrefix[100] = "";
+
+// Token-bucket limiter applied to inbound requests before they reach the display
+RequestRateLimiter requestLimiter;
+unsigned long lastPublishedDropped = 0;  // Dropped count at the last stats publish
+WheelTimer statsHoldTimer;               // Active for REQUEST_STATS_PUBLISH_MS after a stats publish
+
+// Requests waiting to be rendered, and the capacity record derived from them
+RequestInbox requestInbox;
+WheelTimer dwellTimer;                   // Active while the current request is within REQUEST_MIN_DISPLAY_MS
+unsigned long renderLagMs = 0;           // Queueing delay of the most recently drawn request
+bool capacityChanged = true;             // Inbox pushed, popped or full since the last capacity publish
+WheelTimer capacityHoldTimer;            // Active for CAPACITY_PUBLISH_MIN_MS after a capacity publish
+WheelTimer capacityHeartbeatTimer;       // Fires CAPACITY_HEARTBEAT_MS after a capacity publish
+bool capacityHeartbeatDue = false;       // Set by capacityHeartbeatTimer
+InboxRequest shownRequest = {};          // Request last handed to the display, kept for warm restarts
+bool requestShown = false;               // shownRequest is on screen
+
+// Keeps the loop waking every MQTT_POLL_MS so PubSubClient is serviced
+WheelTimer mqttPollTimer;
+
+// Unique client ID, built once in setup_mqtt() so reconnects do not allocate
+char clientId[sizeof(MQTT_CLIENT_ID_BASE) + 12];
+
+unsigned long connectedSinceMs = 0; // millis() of the last successful connect
+MqttStats mqttStats = {};
+
 /**
  * @brief Generates a unique MQTT client ID based on the ESP32's MAC address.
- * @return A String containing the unique client ID.
+ * @param out Buffer receiving MQTT_CLIENT_ID_BASE followed by the MAC in hex, without colons.
+ * @param out_size Size of out in bytes.
+ */
+void generateClientId(char* out, size_t out_size) {
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    snprintf(out, out_size, "%s%02X%02X%02X%02X%02X%02X", MQTT_CLIENT_ID_BASE,
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+/**
+ * @brief RequestBitmaps reclaim check: a bitmap stays while it is queued or on screen.
+ */
+static bool bitmap_in_use(uint8_t id) {
+    return (requestShown && id == shownRequest.bitmap) || requestInbox.holds_bitmap(id);
+}
+
+/**
+ * @brief If `topic` is a faculty status topic (MQTT_STATUS_TOPIC_TEMPLATE), points
+ *        `id` at its faculty ID level and returns the ID's length; otherwise 0.
  */
-String generateClientId() {
-    String mac = WiFi.macAddress();
-    mac.replace(":", ""); // Remove colons from MAC address
-    return String(MQTT_CLIENT_ID_BASE) + mac;
+size_t status_topic_faculty(const char* topic, const char** id) {
+    const char* placeholder = strstr(MQTT_STATUS_TOPIC_TEMPLATE, "%s");
+    size_t prefix_len = placeholder - MQTT_STATUS_TOPIC_TEMPLATE;
+    const char* suffix = placeholder + 2;
+    if (strncmp(topic, MQTT_STATUS_TOPIC_TEMPLATE, prefix_len) != 0) {
+        return 0;
+    }
+    const char* end = strchr(topic + prefix_len, '/');
+    if (end == nullptr || strcmp(end, suffix) != 0) {
+        return 0;
+    }
+    *id = topic + prefix_len;
+    return end - *id;
 }
 
 /**
@@ -37,64 +103,276 @@ String generateClientId() {
  * @param length The length of the payload.
  */
 void internalMqttCallback(char* topic, byte* payload, unsigned int length) {
-    Serial.print("Message arrived [");
-    Serial.print(topic);
-    Serial.print("] ");
-    // Print payload
-    for (int i = 0; i < length; i++) {
-        Serial.print((char)payload[i]);
+    unsigned long arrived_us = micros(); // Start of a traced request's parse stage
+    // Everything allocated while handling this message is released when it returns
+    MessageArena::Scope arena_scope;
+    mqttStats.received++;
+
+#if UNIT_ROLE == UNIT_ROLE_DIRECTORY
+    // Every retained status arrives at once on connect; table updates only, no echo
+    const char* status_id = nullptr;
+    size_t status_id_len = status_topic_faculty(topic, &status_id);
+    if (status_id_len > 0) {
+        DirectoryBoard::ingest(status_id, status_id_len, payload, length);
+        return;
+    }
+#endif
+
+    // Asset uploads are binary chunks; store them without echoing the payload
+    size_t asset_prefix_len = strlen(assetTopicPrefix);
+    if (asset_prefix_len > 0 && strncmp(topic, assetTopicPrefix, asset_prefix_len) == 0) {
+        AssetStore::write_chunk(topic + asset_prefix_len, payload, length);
+        return;
     }
-    Serial.println();
+
+    ULOG(ULOG_DEBUG, "Message arrived [%s] %.*s", topic, (int)length, (const char*)payload);
 
     // Check if the message is for the general consultation request topic.
     // This topic is handled directly by the handler to update the display.
     if (strcmp(topic, MQTT_REQUEST_TOPIC) == 0) {
         // --- Handle Consultation Request ---
-        Serial.println("Received new consultation request.");
 
-        // Allocate a StaticJsonDocument.
-        // Adjust size if necessary based on expected payload size.
-        StaticJsonDocument<256> doc; // Increased size slightly for safety
+        // JSON document pool comes from the message arena (budget from config.h)
+        BasicJsonDocument<MessageArenaAllocator> doc(JSON_REQUEST_DOC_SIZE);
 
         // Deserialize the JSON document
         DeserializationError error = deserializeJson(doc, payload, length);
 
         // Test if parsing succeeded.
         if (error) {
-            Serial.print(F("deserializeJson() failed: "));
-            Serial.println(error.f_str());
+            ULOG(ULOG_WARN, "Request: deserializeJson() failed: %s", error.c_str());
             return; // Exit if JSON is invalid
         }
 
         // Extract values
         const char* student_id = doc["student_id"];
         const char* request_text = doc["request_text"];
+        uint8_t priority = doc["priority"] | 0; // Optional: 0 = walk-in, higher is more urgent
+        uint32_t trace_id = doc["trace_id"] | 0; // Optional: set by the latency harness
         // const char* request_id = doc["request_id"]; // Optional: if needed later for ACKs
 
+        // Compressed text is only sent to units that advertise HEATSHRINK_CODEC_TAG
+        const char* packed_text = doc["request_text_hs"];
+        if (request_text == nullptr && packed_text != nullptr) {
+            char* decodedText = (char*)MessageArena::allocate(INBOX_TEXT_LEN); // Sized for the inbox entry
+            size_t decoded_len = 0;
+            bool truncated = false;
+            unsigned long decode_start = micros();
+            if (decodedText == nullptr ||
+                !decode_heatshrink_base64(packed_text, decodedText, INBOX_TEXT_LEN, &decoded_len, &truncated)) {
+                ULOG(ULOG_WARN, "Failed to decode 'request_text_hs'.");
+                return;
+            }
+            ULOG(ULOG_DEBUG, "Decoded request text: %u -> %u bytes in %lu us%s",
+                 (unsigned)strlen(packed_text), (unsigned)decoded_len, micros() - decode_start,
+                 truncated ? " (truncated, like plain text)" : "");
+            request_text = decodedText;
+        }
+
+        // Rasterized text is only sent to units that advertise TEXT_BITMAP_CODEC_TAG
+        const char* bitmap_b64 = doc["request_text_bitmap"];
+        if (request_text == nullptr && bitmap_b64 != nullptr) {
+            request_text = REQUEST_BITMAP_ALT_TEXT; // Shown if the bitmap is lost (e.g. a warm restart)
+        }
+
         // Basic validation
         if (student_id == nullptr || request_text == nullptr) {
-            Serial.println(F("Missing 'student_id' or 'request_text' in JSON payload."));
+            ULOG(ULOG_WARN, "Missing 'student_id' or 'request_text' in JSON payload.");
             return; // Exit if required fields are missing
         }
 
-        Serial.print("Student ID: ");
-        Serial.println(student_id);
-        Serial.print("Request Text: ");
-        Serial.println(request_text);
+        // Drop the request before rendering if this student is over their rate
+        if (!requestLimiter.allow(student_id, millis())) {
+            ULOG(ULOG_WARN, "Rate limit exceeded, dropping request from: %s", student_id);
+            return;
+        }
+
+        ULOG(ULOG_INFO, "Request from %s (priority %u)", student_id, (unsigned)priority);
+        ULOG(ULOG_DEBUG, "Request text: %s", request_text);
 
-        // Call the static display manager function to show the request
-        DisplayManager::show_request(student_id, request_text);
+        uint8_t bitmap = 0;
+        if (bitmap_b64 != nullptr) {
+            bitmap = RequestBitmaps::store_base64(bitmap_b64, bitmap_in_use);
+            if (bitmap == 0) {
+                ULOG(ULOG_WARN, "Could not store 'request_text_bitmap', falling back to text.");
+            }
+        }
+
+        // Queue the request; it is drawn from mqtt_handler_loop() in priority order once the screen is free
+        unsigned long parse_us = micros() - arrived_us;
+        if (!requestInbox.push(student_id, request_text, priority, millis(), bitmap, trace_id,
+                               parse_us > 0xFFFF ? 0xFFFF : parse_us)) {
+            ULOG(ULOG_WARN, "Request inbox full, dropping request.");
+        }
+        capacityChanged = true;
+        WarmRestart::mark_dirty();
 
     } else {
         // --- Handle other topics via user callback ---
         // Call the user-provided callback if it's set and the topic is not the request topic
         if (mqttCallback != NULL) {
-            Serial.println("Passing message to user callback.");
+            ULOG(ULOG_DEBUG, "Passing message to user callback.");
             mqttCallback(topic, payload, length);
         }
     }
 }
 
+/**
+ * @brief Publishes the accepted/dropped request counters when new drops have occurred,
+ *        at most once every REQUEST_STATS_PUBLISH_MS. When the hold timer expires the
+ *        loop wakes and any drops held back meanwhile are published.
+ */
+void publish_request_stats() {
+    unsigned long totalDropped = requestLimiter.dropped_count() + requestInbox.overflow_count();
+    if (totalDropped == lastPublishedDropped || statsHoldTimer.active()) {
+        return;
+    }
+
+    char payload[160];
+    snprintf(payload, sizeof(payload),
+             "{\"accepted\":%lu,\"dropped\":%lu,\"overflow\":%lu,\"arena_hwm\":%u,\"arena_overflow\":%lu}",
+             requestLimiter.accepted_count(), requestLimiter.dropped_count(),
+             requestInbox.overflow_count(), (unsigned)MessageArena::high_water_mark(),
+             MessageArena::overflow_count());
+    snprintf(topicBuffer, sizeof(topicBuffer), MQTT_REQUEST_STATS_TOPIC_TEMPLATE, facultyId);
+    publish_message(topicBuffer, payload, false);
+
+    lastPublishedDropped = totalDropped;
+    TimerWheel::schedule(statsHoldTimer, REQUEST_STATS_PUBLISH_MS, nullptr, nullptr);
+}
+
+/**
+ * @brief Publishes EVENT_REQUEST_SHOW for the next queued request once the current
+ *        one has been on screen for at least REQUEST_MIN_DISPLAY_MS.
+ */
+void service_request_inbox() {
+    if (dwellTimer.active()) {
+        return; // Current request is still within its display time
+    }
+
+    if (requestInbox.depth() == 0) {
+        return;
+    }
+
+    // Pop straight into a bus record; if the pool is exhausted the request stays queued
+    Event* event = EventBus::acquire(EVENT_REQUEST_SHOW);
+    if (event == nullptr) {
+        return;
+    }
+    requestInbox.pop(event->request);
+    capacityChanged = true;
+    shownRequest = event->request;
+    requestShown = true;
+    WarmRestart::mark_dirty();
+    renderLagMs = millis() - event->request.received_ms;
+    TimerWheel::schedule(dwellTimer, REQUEST_MIN_DISPLAY_MS, nullptr, nullptr); // Expiry just wakes the loop
+    EventBus::publish(event);
+}
+
+/**
+ * @brief Publishes the retained capacity/credit record ({"free","depth","lag_ms"}) so the
+ *        central system can pace requests. Sent after any push, pop or overflow, even if the
+ *        depth is back where it was (the central side spent credits in between and only a new
+ *        record returns them), rate-limited to CAPACITY_PUBLISH_MIN_MS, and as a heartbeat
+ *        every CAPACITY_HEARTBEAT_MS.
+ */
+static void on_capacity_heartbeat(void*) {
+    capacityHeartbeatDue = true;
+}
+
+void publish_capacity() {
+    if (capacityHoldTimer.active() || !(capacityChanged || capacityHeartbeatDue)) {
+        return;
+    }
+    if (!client.connected()) {
+        return;
+    }
+
+    char payload[64];
+    snprintf(payload, sizeof(payload), "{\"free\":%u,\"depth\":%u,\"lag_ms\":%lu}",
+             requestInbox.free_slots(), requestInbox.depth(), renderLagMs);
+    snprintf(topicBuffer, sizeof(topicBuffer), MQTT_CAPACITY_TOPIC_TEMPLATE, facultyId);
+    publish_message(topicBuffer, payload, true);
+
+    capacityChanged = false;
+    capacityHeartbeatDue = false;
+    TimerWheel::schedule(capacityHoldTimer, CAPACITY_PUBLISH_MIN_MS, nullptr, nullptr);
+    TimerWheel::schedule(capacityHeartbeatTimer, CAPACITY_HEARTBEAT_MS, on_capacity_heartbeat, nullptr);
+}
+
+const MqttStats& mqtt_stats() {
+    return mqttStats;
+}
+
+unsigned long mqtt_connected_ms() {
+    return client.connected() ? millis() - connectedSinceMs : 0;
+}
+
+/**
+ * @brief Stages are measured on the unit's clock only; the harness pairs them with its
+ *        own publish-to-trace round trip to estimate the network legs.
+ */
+void publish_request_trace(const InboxRequest& request, unsigned long draw_start_ms, unsigned long draw_us) {
+    if (request.trace_id == 0) {
+        return;
+    }
+    char payload[128];
+    snprintf(payload, sizeof(payload),
+             "{\"trace_id\":%lu,\"parse_us\":%u,\"queue_ms\":%lu,\"draw_us\":%lu,\"total_ms\":%lu}",
+             (unsigned long)request.trace_id, request.parse_us, draw_start_ms - request.received_ms, draw_us,
+             millis() - request.received_ms);
+    snprintf(topicBuffer, sizeof(topicBuffer), MQTT_TRACE_TOPIC_TEMPLATE, facultyId);
+    publish_message(topicBuffer, payload, false);
+}
+
+uint16_t pending_request_count() {
+    return requestInbox.depth();
+}
+
+uint8_t snapshot_pending_requests(InboxRequest* out, uint8_t max) {
+    return requestInbox.snapshot(out, max);
+}
+
+/**
+ * @brief Arrival times do not survive the reset, so restored requests count as received now.
+ *        Bitmaps do not survive either (see RequestBitmaps); trace IDs do, so a traced request
+ *        still reports its trace once drawn.
+ */
+void restore_pending_requests(const InboxRequest* requests, uint8_t count) {
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < count; i++) {
+        requestInbox.push(requests[i].student_id, requests[i].request_text, requests[i].priority, now, 0,
+                          requests[i].trace_id, requests[i].parse_us);
+    }
+}
+
+bool snapshot_shown_request(InboxRequest& out) {
+    if (requestShown) {
+        out = shownRequest;
+    }
+    return requestShown;
+}
+
+/**
+ * @brief The request gets a fresh REQUEST_MIN_DISPLAY_MS before the next one replaces it;
+ *        its trace was published when it was first drawn.
+ */
+void restore_shown_request(const InboxRequest& request) {
+    shownRequest = request;
+    shownRequest.bitmap = 0;
+    requestShown = true;
+    TimerWheel::schedule(dwellTimer, REQUEST_MIN_DISPLAY_MS, nullptr, nullptr);
+}
+
+/**
+ * @brief Publishes the retained capability record so the central system knows
+ *        which optional payload encodings this unit accepts.
+ */
+void publish_capabilities() {
+    snprintf(topicBuffer, sizeof(topicBuffer), MQTT_CAPABILITIES_TOPIC_TEMPLATE, facultyId);
+    publish_message(topicBuffer, "{\"codecs\":[\"" HEATSHRINK_CODEC_TAG "\",\"" TEXT_BITMAP_CODEC_TAG "\"]}", true);
+}
+
 /**
  * @brief Sets the unique faculty ID for this unit.
  *        This ID is used to construct faculty-specific MQTT topics.
@@ -103,8 +381,7 @@ void internalMqttCallback(char* topic, byte* payload, unsigned int length) {
 void set_faculty_id(const char* id) {
     strncpy(facultyId, id, sizeof(facultyId) - 1);
     facultyId[sizeof(facultyId) - 1] = '\0'; // Ensure null termination
-    Serial.print("Faculty ID set to: ");
-    Serial.println(facultyId);
+    ULOG(ULOG_INFO, "Faculty ID set to: %s", facultyId);
 }
 
 /**
@@ -125,9 +402,7 @@ void setup_wifi() {
     }
 
     Serial.println("");
-    Serial.println("WiFi connected");
-    Serial.print("IP address: ");
-    Serial.println(WiFi.localIP());
+    ULOG(ULOG_INFO, "WiFi connected, IP address: %s", WiFi.localIP().toString().c_str());
 }
 
 /**
@@ -139,57 +414,94 @@ void setup_mqtt(MQTT_CALLBACK_SIGNATURE callback) {
     mqttCallback = callback; // Store the user's callback function
     client.setServer(MQTT_BROKER, MQTT_PORT); // Set broker address and port
     client.setCallback(internalMqttCallback); // Register the internal callback wrapper
-    Serial.println("MQTT Server and Callback configured.");
-}
-
-/**
- * @brief Attempts to connect to the MQTT broker. If connection fails,
- *        it waits for MQTT_RECONNECT_DELAY and tries again.
- *        Subscribes to the necessary topics upon successful connection.
- */
-void reconnect_mqtt() {
-    // Loop until we're reconnected
-    while (!client.connected()) {
-        Serial.print("Attempting MQTT connection...");
-        String clientId = generateClientId();
-        Serial.print(" (Client ID: ");
-        Serial.print(clientId);
-        Serial.print(")");
-
-        // Attempt to connect
-        if (client.connect(clientId.c_str())) {
-            Serial.println(" connected");
-
-            // Subscribe to general request topic
-            if (client.subscribe(MQTT_REQUEST_TOPIC)) {
-                Serial.print("Subscribed to: ");
-                Serial.println(MQTT_REQUEST_TOPIC);
-            } else {
-                Serial.print("Failed to subscribe to: ");
-                Serial.println(MQTT_REQUEST_TOPIC);
-            }
+    client.setBufferSize(MQTT_BUFFER_SIZE);   // Room for asset chunks and longer requests
+    generateClientId(clientId, sizeof(clientId));
+    ULOG(ULOG_INFO, "MQTT Server and Callback configured.");
+}
+
+/**
+ * @brief Makes one attempt to connect to the MQTT broker and, on success,
+ *        subscribes to the necessary topics.
+ * @return true if connected.
+ */
+bool connect_mqtt() {
+
+    // The battery build sleeps between cycles: a persistent session with QoS 1 requests
+    // lets the broker hold requests published while the unit was asleep
+    bool persistent = POWER_MODE == POWER_MODE_BATTERY;
 
-            // Add subscriptions to faculty-specific topics if needed
-            // Example: Subscribe to a topic specific to this faculty unit
-            // snprintf(topicBuffer, sizeof(topicBuffer), "consultease/faculty/%s/commands", facultyId);
-            // if (client.subscribe(topicBuffer)) {
-            //     Serial.print("Subscribed to: ");
-            //     Serial.println(topicBuffer);
-            // } else {
-            //     Serial.print("Failed to subscribe to: ");
-            //     Serial.println(topicBuffer);
-            // }
+    // Attempt to connect
+    if (client.connect(clientId, nullptr, nullptr, nullptr, 0, false, nullptr, !persistent)) {
+        ULOG(ULOG_INFO, "MQTT connected (Client ID: %s)", clientId);
+        connectedSinceMs = millis();
+        mqttStats.connects++;
 
+#if UNIT_ROLE == UNIT_ROLE_DIRECTORY
+        // The hallway board only follows status topics; it takes no requests or assets
+        if (client.subscribe(DIRECTORY_STATUS_TOPIC)) {
+            ULOG(ULOG_INFO, "Subscribed to: %s", DIRECTORY_STATUS_TOPIC);
         } else {
-            Serial.print(" failed, rc=");
-            Serial.print(client.state());
-            Serial.println(" try again in 5 seconds");
-            // Wait 5 seconds before retrying
-            delay(MQTT_RECONNECT_DELAY);
+            ULOG(ULOG_ERROR, "Failed to subscribe to: %s", DIRECTORY_STATUS_TOPIC);
         }
+        return true;
+#endif
+
+        // Subscribe to general request topic
+        if (client.subscribe(MQTT_REQUEST_TOPIC, persistent ? 1 : 0)) {
+            ULOG(ULOG_INFO, "Subscribed to: %s", MQTT_REQUEST_TOPIC);
+        } else {
+            ULOG(ULOG_ERROR, "Failed to subscribe to: %s", MQTT_REQUEST_TOPIC);
+        }
+
+        // Subscribe to this unit's asset uploads
+        snprintf(topicBuffer, sizeof(topicBuffer), MQTT_ASSET_TOPIC_TEMPLATE, facultyId);
+        if (client.subscribe(topicBuffer)) {
+            ULOG(ULOG_INFO, "Subscribed to: %s", topicBuffer);
+            strncpy(assetTopicPrefix, topicBuffer, sizeof(assetTopicPrefix) - 1);
+            assetTopicPrefix[strlen(assetTopicPrefix) - 1] = '\0'; // Drop the '+' wildcard
+        } else {
+            ULOG(ULOG_ERROR, "Failed to subscribe to: %s", topicBuffer);
+        }
+
+        publish_capabilities(); // Advertise supported payload codecs
+
+        // Remote command batches, passed to the user callback (CommandRpc)
+        snprintf(topicBuffer, sizeof(topicBuffer), MQTT_COMMAND_TOPIC_TEMPLATE, facultyId);
+        if (client.subscribe(topicBuffer, persistent ? 1 : 0)) {
+            ULOG(ULOG_INFO, "Subscribed to: %s", topicBuffer);
+        } else {
+            ULOG(ULOG_ERROR, "Failed to subscribe to: %s", topicBuffer);
+        }
+
+        return true;
     }
+
+    ULOG(ULOG_WARN, "MQTT connection failed, rc=%d", client.state());
+    mqttStats.connect_failures++;
+    return false;
 }
 
+/**
+ * @brief Coroutine that keeps the MQTT connection up. Checks the connection every
+ *        MQTT_CONNECTION_CHECK_MS and, when it is down, retries with exponential backoff
+ *        from MQTT_RECONNECT_DELAY up to MQTT_RECONNECT_MAX_DELAY without blocking the loop.
+ */
+CoTask mqtt_reconnect_flow() {
+    unsigned long backoff = MQTT_RECONNECT_DELAY;
+    for (;;) {
+        if (client.connected() || connect_mqtt()) {
+            backoff = MQTT_RECONNECT_DELAY;
+            co_await sleep_for(MQTT_CONNECTION_CHECK_MS);
+            continue;
+        }
+
+        ULOG(ULOG_INFO, "MQTT reconnect in %lu ms", backoff);
+        co_await sleep_for(backoff);
+        backoff = backoff * 2 > MQTT_RECONNECT_MAX_DELAY ? MQTT_RECONNECT_MAX_DELAY : backoff * 2;
+    }
+}
+
+
 /**
  * @brief Maintains the MQTT connection and processes incoming/outgoing messages.
  *        Checks connection status and attempts reconnection if necessary.
@@ -197,10 +509,23 @@ void reconnect_mqtt() {
  *        Should be called repeatedly in the main Arduino loop.
  */
 void mqtt_handler_loop() {
-    if (!client.connected()) {
-        reconnect_mqtt(); // Attempt to reconnect if disconnected
+    // Reconnection is handled by mqtt_reconnect_flow() on the coroutine scheduler
+    // PubSubClient handles one packet per loop() call; keep going while more are buffered
+    // so a burst (e.g. retained messages on connect) is not spread over MQTT_POLL_MS passes
+    for (uint8_t i = 0; i < MQTT_DRAIN_MAX && client.connected(); i++) {
+        client.loop(); // Allow the MQTT client to process incoming messages and maintain connection
+        if (espClient.available() == 0) {
+            break;
+        }
     }
-    client.loop(); // Allow the MQTT client to process incoming messages and maintain connection
+    if (!mqttPollTimer.active()) {
+        TimerWheel::schedule(mqttPollTimer, MQTT_POLL_MS, nullptr, nullptr);
+    }
+#if UNIT_ROLE == UNIT_ROLE_FACULTY
+    service_request_inbox(); // Draw the next pending request, if due
+    publish_capacity();      // Report free inbox slots for central-side pacing
+    publish_request_stats(); // Report dropped requests, if any
+#endif
 }
 
 /**
@@ -211,14 +536,36 @@ void mqtt_handler_loop() {
  */
 void publish_message(const char* topic, const char* payload, boolean retained) {
     if (client.connected()) {
-        Serial.print("Publishing to [");
-        Serial.print(topic);
-        Serial.print("]: ");
-        Serial.println(payload);
-        if (!client.publish(topic, payload, retained)) {
-             Serial.println("MQTT Publish failed!");
+        ULOG(ULOG_DEBUG, "Publishing to [%s]: %s", topic, payload);
+        if (client.publish(topic, payload, retained)) {
+            mqttStats.published++;
+        } else {
+             ULOG(ULOG_WARN, "MQTT Publish failed!");
+             mqttStats.publish_failures++;
         }
     } else {
-        Serial.println("MQTT Client not connected. Cannot publish.");
+        ULOG(ULOG_WARN, "MQTT Client not connected. Cannot publish.");
+        mqttStats.publish_failures++;
+    }
+}
+
+bool log_sink_ready() {
+    return client.connected();
+}
+
+/**
+ * @brief UnitLog frame sink. Not echoed to Serial or logged, so a failing publish cannot feed itself.
+ */
+bool publish_log_frame(const char* frame) {
+    if (!client.connected()) {
+        return false; // Kept in the log ring and backfilled after reconnect
+    }
+    char topic[100];
+    snprintf(topic, sizeof(topic), MQTT_LOG_TOPIC_TEMPLATE, facultyId);
+    if (!client.publish(topic, frame, false)) {
+        mqttStats.publish_failures++;
+        return false;
     }
+    mqttStats.published++;
+    return true;
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <Arduino.h> // Include base Arduino definitions (for byte, boolean, etc.)
 #include <WiFi.h>
 #include <PubSubClient.h>
+#include "coro_scheduler.h" // CoTask for the reconnect flow
+#include "request_inbox.h"  // InboxRequest for warm-restart snapshots
 
 // Define the function signature for the MQTT message callback
 // Parameters: topic, payload (byte array), length of payload
@@ -29,11 +31,11 @@ void setup_wifi();
 void setup_mqtt(MQTT_CALLBACK_SIGNATURE callback);
 
 /**
- * @brief Attempts to connect/reconnect to the MQTT broker.
+ * @brief Coroutine that connects/reconnects to the MQTT broker with exponential backoff.
  * Handles subscription logic upon successful connection.
- * Should be called internally when a connection is lost.
+ * Spawn once on the CoScheduler after setup_mqtt().
  */
-void reconnect_mqtt();
+CoTask mqtt_reconnect_flow();
 
 /**
  * @brief Maintains the MQTT connection and processes incoming messages.
@@ -41,6 +43,65 @@ void reconnect_mqtt();
  */
 void mqtt_handler_loop();
 
+/**
+ * @brief Connection and traffic counters since boot, for the metrics endpoint.
+ */
+struct MqttStats {
+    unsigned long received;         ///< Messages delivered by the broker.
+    unsigned long published;        ///< Messages handed to the client successfully.
+    unsigned long publish_failures; ///< Publishes refused (disconnected or buffer too small).
+    unsigned long connects;         ///< Successful connections.
+    unsigned long connect_failures; ///< Failed connection attempts.
+};
+
+/**
+ * @brief Returns the MQTT counters.
+ */
+const MqttStats& mqtt_stats();
+
+/**
+ * @brief How long the current MQTT connection has been up.
+ * @return Milliseconds since connecting, or 0 while disconnected.
+ */
+unsigned long mqtt_connected_ms();
+
+/**
+ * @brief Publishes a traced request's stage timings to MQTT_TRACE_TOPIC_TEMPLATE once it
+ *        is drawn: {"trace_id", "parse_us", "queue_ms", "draw_us", "total_ms"}. Untraced
+ *        requests (trace_id 0) publish nothing.
+ * @param draw_start_ms millis() when drawing began.
+ * @param draw_us Time DisplayManager::show_request() took.
+ */
+void publish_request_trace(const InboxRequest& request, unsigned long draw_start_ms, unsigned long draw_us);
+
+/**
+ * @brief Number of requests waiting to be shown.
+ */
+uint16_t pending_request_count();
+
+/**
+ * @brief Copies the pending requests, highest rank first, for a warm-restart snapshot.
+ * @return Number of requests copied.
+ */
+uint8_t snapshot_pending_requests(InboxRequest* out, uint8_t max);
+
+/**
+ * @brief Re-queues requests from a warm-restart snapshot. Call from setup().
+ */
+void restore_pending_requests(const InboxRequest* requests, uint8_t count);
+
+/**
+ * @brief Copies the request on screen (already popped from the inbox) for a warm-restart snapshot.
+ * @return false if no request has been shown.
+ */
+bool snapshot_shown_request(InboxRequest& out);
+
+/**
+ * @brief Marks a request from a warm-restart snapshot as on screen again. Call from setup(),
+ *        after drawing it.
+ */
+void restore_shown_request(const InboxRequest& request);
+
 /**
  * @brief Publishes a message to the specified MQTT topic.
  * @param topic The MQTT topic to publish to.
@@ -49,5 +110,16 @@ void mqtt_handler_loop();
  */
 void publish_message(const char* topic, const char* payload, boolean retained = false);
 
+/**
+ * @brief Publishes a UnitLog frame to MQTT_LOG_TOPIC_TEMPLATE (pass to UnitLog::begin()).
+ * @return false if not connected or the publish failed; the frame is retried later.
+ */
+bool publish_log_frame(const char* frame);
+
+/**
+ * @brief UnitLog readiness check: true while connected (pass to UnitLog::begin()).
+ */
+bool log_sink_ready();
+
 
 #endif // MQTT_HANDLER_H
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "rate_limiter.h"
+
+// Constructor
+RequestRateLimiter::RequestRateLimiter() : accepted(0), dropped(0) {
+    memset(buckets, 0, sizeof(buckets));
+}
+
+/**
+ * @brief 32-bit FNV-1a hash of the student ID. Zero is reserved for empty slots.
+ */
+uint32_t RequestRateLimiter::hash_id(const char* student_id) {
+    uint32_t h = 2166136261u;
+    for (const char* p = student_id; *p != '\0'; p++) {
+        h ^= (uint8_t)*p;
+        h *= 16777619u;
+    }
+    return h == 0 ? 1 : h;
+}
+
+/**
+ * @brief Returns the bucket for a key, claiming an empty slot or recycling the
+ *        least recently used one if the key is not yet tracked.
+ */
+RequestRateLimiter::Bucket* RequestRateLimiter::find_or_claim(uint32_t key, unsigned long now_ms) {
+    Bucket* victim = &buckets[0];
+    for (int i = 0; i < REQUEST_RATE_TABLE_SIZE; i++) {
+        Bucket* b = &buckets[i];
+        if (b->key == key) {
+            return b;
+        }
+        if (b->key == 0) {
+            victim = b; // Prefer an empty slot
+        } else if (victim->key != 0 && (now_ms - b->last_used_ms) > (now_ms - victim->last_used_ms)) {
+            victim = b;
+        }
+    }
+
+    // New student: start with a full bucket
+    victim->key = key;
+    victim->tokens = REQUEST_RATE_BURST;
+    victim->last_refill_ms = now_ms;
+    victim->last_used_ms = now_ms;
+    return victim;
+}
+
+/**
+ * @brief Refills the student's bucket for elapsed time and consumes one token.
+ *        Unsigned subtraction keeps the arithmetic correct across millis() rollover.
+ */
+bool RequestRateLimiter::allow(const char* student_id, unsigned long now_ms) {
+    Bucket* b = find_or_claim(hash_id(student_id), now_ms);
+
+    unsigned long refill = (now_ms - b->last_refill_ms) / REQUEST_RATE_REFILL_MS;
+    if (refill > 0) {
+        unsigned long tokens = b->tokens + refill;
+        b->tokens = tokens > REQUEST_RATE_BURST ? REQUEST_RATE_BURST : (uint8_t)tokens;
+        b->last_refill_ms += refill * REQUEST_RATE_REFILL_MS;
+    }
+    b->last_used_ms = now_ms;
+
+    if (b->tokens == 0) {
+        dropped++;
+        return false;
+    }
+    b->tokens--;
+    accepted++;
+    return true;
+}
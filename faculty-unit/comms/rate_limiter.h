@@ -0,0 +1,43 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @brief Token-bucket limiter for inbound consultation requests, keyed by a hash of student_id.
+ *        Uses a fixed-size table (REQUEST_RATE_TABLE_SIZE) so it never allocates; when the table
+ *        is full the least recently used bucket is recycled.
+ */
+class RequestRateLimiter {
+public:
+    RequestRateLimiter();
+
+    /**
+     * @brief Consumes one token from the student's bucket.
+     * @param student_id The student ID from the request payload.
+     * @param now_ms Current time in millis().
+     * @return true if the request may be processed, false if it should be dropped.
+     */
+    bool allow(const char* student_id, unsigned long now_ms);
+
+    unsigned long accepted_count() const { return accepted; }
+    unsigned long dropped_count() const { return dropped; }
+
+private:
+    struct Bucket {
+        uint32_t key;                 ///< FNV-1a hash of student_id (0 = empty slot).
+        uint8_t tokens;               ///< Tokens currently available.
+        unsigned long last_refill_ms; ///< Time the last token was credited.
+        unsigned long last_used_ms;   ///< Time of the last request, used for eviction.
+    };
+
+    static uint32_t hash_id(const char* student_id);
+    Bucket* find_or_claim(uint32_t key, unsigned long now_ms);
+
+    Bucket buckets[REQUEST_RATE_TABLE_SIZE];
+    unsigned long accepted;
+    unsigned long dropped;
+};
+
+#endif // RATE_LIMITER_H
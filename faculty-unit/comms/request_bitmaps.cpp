@@ -0,0 +1,46 @@
+#include "request_bitmaps.h"
+#include "compressed_text.h" // decode_base64()
+#include "unit_log.h"        // Sampled Serial/MQTT logging
+
+static uint8_t slots[REQUEST_BITMAP_SLOTS][REQUEST_BITMAP_MAX_BYTES];
+static size_t lengths[REQUEST_BITMAP_SLOTS]; // 0 = slot free
+
+static int find_free() {
+    for (uint8_t i = 0; i < REQUEST_BITMAP_SLOTS; i++) {
+        if (lengths[i] == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+uint8_t RequestBitmaps::store_base64(const char* b64, BITMAP_IN_USE_SIGNATURE in_use) {
+    int slot = find_free();
+    if (slot < 0) {
+        for (uint8_t i = 0; i < REQUEST_BITMAP_SLOTS; i++) {
+            if (!in_use(i + 1)) {
+                lengths[i] = 0;
+            }
+        }
+        slot = find_free();
+        if (slot < 0) {
+            ULOG(ULOG_WARN, "Request bitmap pool exhausted.");
+            return 0;
+        }
+    }
+
+    size_t len = 0;
+    if (!decode_base64(b64, slots[slot], REQUEST_BITMAP_MAX_BYTES, &len) || len == 0) {
+        return 0;
+    }
+    lengths[slot] = len;
+    return slot + 1;
+}
+
+const uint8_t* RequestBitmaps::data(uint8_t id, size_t* len) {
+    if (id == 0 || id > REQUEST_BITMAP_SLOTS || lengths[id - 1] == 0) {
+        return nullptr;
+    }
+    *len = lengths[id - 1];
+    return slots[id - 1];
+}
@@ -0,0 +1,41 @@
+#ifndef REQUEST_BITMAPS_H
+#define REQUEST_BITMAPS_H
+
+#include <Arduino.h>
+#include "config.h"
+
+static_assert(REQUEST_BITMAP_SLOTS <= 255, "Bitmap IDs are uint8_t (1..REQUEST_BITMAP_SLOTS), so INBOX_CAPACITY must be at most 253");
+
+/**
+ * @brief Returns true while something still refers to the bitmap with this ID
+ *        (a pending inbox entry or the request on screen).
+ */
+typedef bool (*BITMAP_IN_USE_SIGNATURE)(uint8_t id);
+
+/**
+ * @brief Static pool of pre-rasterized request text bitmaps, REQUEST_BITMAP_SLOTS
+ *        buffers of REQUEST_BITMAP_MAX_BYTES each.
+ *
+ * Inbox entries refer to a bitmap by its one-based ID (0 = no bitmap), so the heap
+ * and the event bus keep moving small records. Slots are never freed explicitly:
+ * when none is free, every slot the in-use callback no longer claims is reclaimed.
+ * This covers evicted and rejected requests without hooks in the inbox.
+ */
+class RequestBitmaps {
+public:
+    /**
+     * @brief Decodes a base64 bitmap into a free slot.
+     * @param b64 Null-terminated base64 string.
+     * @param in_use Called for each slot when the pool is full.
+     * @return The bitmap ID, or 0 if the input is malformed, too large or no slot is free.
+     */
+    static uint8_t store_base64(const char* b64, BITMAP_IN_USE_SIGNATURE in_use);
+
+    /**
+     * @brief Bitmap bytes for an ID, or nullptr for 0 or an unused slot.
+     * @param len Receives the length in bytes.
+     */
+    static const uint8_t* data(uint8_t id, size_t* len);
+};
+
+#endif // REQUEST_BITMAPS_H
@@ -0,0 +1,167 @@
+#include "request_inbox.h"
+
+// Constructor
+RequestInbox::RequestInbox() : count(0), free_top(INBOX_CAPACITY), next_seq(0), overflows(0) {
+    for (uint16_t i = 0; i < INBOX_CAPACITY; i++) {
+        free_list[i] = INBOX_CAPACITY - 1 - i;
+    }
+}
+
+/**
+ * @brief True if slot a should be shown before slot b.
+ *        Sequence numbers are compared by signed difference so wraparound is harmless.
+ */
+bool RequestInbox::outranks(uint16_t a, uint16_t b) const {
+    if (slots[a].priority != slots[b].priority) {
+        return slots[a].priority > slots[b].priority;
+    }
+    return (int32_t)(slots[a].seq - slots[b].seq) < 0;
+}
+
+/**
+ * @brief Heap order: a before b in the max-heap (lowest_first false) or the min-heap (true).
+ */
+bool RequestInbox::before(uint16_t a, uint16_t b, bool lowest_first) const {
+    return lowest_first ? outranks(b, a) : outranks(a, b);
+}
+
+void RequestInbox::sift_up(uint16_t* h, uint16_t* where, bool lowest_first, uint16_t pos) {
+    uint16_t item = h[pos];
+    while (pos > 0) {
+        uint16_t parent = (pos - 1) / 2;
+        if (!before(item, h[parent], lowest_first)) {
+            break;
+        }
+        h[pos] = h[parent];
+        where[h[pos]] = pos;
+        pos = parent;
+    }
+    h[pos] = item;
+    where[item] = pos;
+}
+
+void RequestInbox::sift_down(uint16_t* h, uint16_t* where, bool lowest_first, uint16_t pos) {
+    uint16_t item = h[pos];
+    while (true) {
+        uint16_t child = 2 * pos + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && before(h[child + 1], h[child], lowest_first)) {
+            child++;
+        }
+        if (!before(h[child], item, lowest_first)) {
+            break;
+        }
+        h[pos] = h[child];
+        where[h[pos]] = pos;
+        pos = child;
+    }
+    h[pos] = item;
+    where[item] = pos;
+}
+
+/**
+ * @brief Removes the entry at pos from one heap. count must already be decremented.
+ */
+void RequestInbox::heap_remove(uint16_t* h, uint16_t* where, bool lowest_first, uint16_t pos) {
+    if (pos == count) {
+        return;
+    }
+    uint16_t moved = h[count];
+    h[pos] = moved;
+    where[moved] = pos;
+    sift_down(h, where, lowest_first, pos);
+    sift_up(h, where, lowest_first, where[moved]);
+}
+
+/**
+ * @brief Removes a stored slot from both heaps and returns it to the free list.
+ */
+void RequestInbox::remove_slot(uint16_t idx) {
+    uint16_t high = heap_pos[idx];
+    uint16_t low = low_pos[idx];
+    count--;
+    heap_remove(heap, heap_pos, false, high);
+    heap_remove(low_heap, low_pos, true, low);
+    free_list[free_top++] = idx;
+}
+
+/**
+ * @brief Inserts a request, evicting the lowest-ranked one (top of low_heap) if the inbox is full.
+ *        Over-long strings are truncated.
+ */
+bool RequestInbox::push(const char* student_id, const char* request_text, uint8_t priority, unsigned long now_ms,
+                        uint8_t bitmap, uint32_t trace_id, uint16_t parse_us) {
+    if (count == INBOX_CAPACITY) {
+        uint16_t lowest = low_heap[0];
+        overflows++;
+        // The incoming request is newer than everything stored, so it loses priority ties
+        if (priority <= slots[lowest].priority) {
+            return false;
+        }
+        remove_slot(lowest);
+    }
+
+    uint16_t idx = free_list[--free_top];
+    InboxRequest& slot = slots[idx];
+    strncpy(slot.student_id, student_id, sizeof(slot.student_id) - 1);
+    slot.student_id[sizeof(slot.student_id) - 1] = '\0';
+    strncpy(slot.request_text, request_text, sizeof(slot.request_text) - 1);
+    slot.request_text[sizeof(slot.request_text) - 1] = '\0';
+    slot.received_ms = now_ms;
+    slot.priority = priority;
+    slot.bitmap = bitmap;
+    slot.trace_id = trace_id;
+    slot.parse_us = parse_us;
+    slot.seq = next_seq++;
+
+    heap[count] = idx;
+    low_heap[count] = idx;
+    count++;
+    sift_up(heap, heap_pos, false, count - 1);
+    sift_up(low_heap, low_pos, true, count - 1);
+    return true;
+}
+
+/**
+ * @brief Removes the request at the top of the heap.
+ */
+bool RequestInbox::pop(InboxRequest& out) {
+    if (count == 0) {
+        return false;
+    }
+    out = slots[heap[0]];
+    remove_slot(heap[0]);
+    return true;
+}
+
+bool RequestInbox::holds_bitmap(uint8_t bitmap) const {
+    for (uint16_t i = 0; i < count; i++) {
+        if (slots[heap[i]].bitmap == bitmap) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Heap order is not rank order, so the copy is insertion-sorted (n <= INBOX_CAPACITY).
+ */
+uint16_t RequestInbox::snapshot(InboxRequest* out, uint16_t max) const {
+    uint16_t order[INBOX_CAPACITY];
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t j = i;
+        while (j > 0 && outranks(heap[i], order[j - 1])) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = heap[i];
+    }
+
+    uint16_t n = count < max ? count : max;
+    for (uint16_t i = 0; i < n; i++) {
+        out[i] = slots[order[i]];
+    }
+    return n;
+}
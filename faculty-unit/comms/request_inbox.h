@@ -0,0 +1,88 @@
+#ifndef REQUEST_INBOX_H
+#define REQUEST_INBOX_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @brief A consultation request waiting to be shown on the display.
+ *        Strings are copied into fixed buffers so the entry outlives the MQTT payload.
+ */
+struct InboxRequest {
+    char student_id[INBOX_STUDENT_ID_LEN];
+    char request_text[INBOX_TEXT_LEN];
+    unsigned long received_ms; ///< millis() when the request arrived.
+    uint8_t priority;          ///< Higher is more urgent (0 = walk-in).
+    uint8_t bitmap;            ///< RequestBitmaps ID of the pre-rasterized text (0 = draw request_text).
+    uint32_t seq;              ///< Arrival sequence number, breaks priority ties (older first).
+    uint32_t trace_id;         ///< The request's "trace_id", echoed in its latency trace (0 = untraced).
+    uint16_t parse_us;         ///< MQTT callback entry to queued, for the latency trace.
+};
+
+/**
+ * @brief Fixed-capacity priority inbox of pending consultation requests.
+ *        Two binary heaps of slot indices over the same slots: a max-heap by priority, then
+ *        arrival order, for pop(), and a min-heap for finding the request to evict when
+ *        full. Each slot records its position in both, so push, pop and eviction are all
+ *        O(log n) and only small indices move. When full, the lowest-priority (and among
+ *        equals, newest) request is evicted.
+ */
+class RequestInbox {
+public:
+    RequestInbox();
+
+    /**
+     * @brief Copies a request into the inbox.
+     *        If the inbox is full, the lowest-priority request is evicted to make room;
+     *        if the new request itself is the lowest, it is rejected instead.
+     * @param bitmap RequestBitmaps ID of the rasterized text, 0 if there is none.
+     * @param trace_id Latency trace ID, 0 if the request is not traced.
+     * @param parse_us Time spent receiving and parsing the request.
+     * @return true if stored, false if rejected. Evictions and rejections count as overflows.
+     */
+    bool push(const char* student_id, const char* request_text, uint8_t priority, unsigned long now_ms,
+              uint8_t bitmap = 0, uint32_t trace_id = 0, uint16_t parse_us = 0);
+
+    /**
+     * @brief Removes the highest-priority (oldest among equals) request.
+     * @param out Receives the request.
+     * @return true if a request was removed, false if the inbox is empty.
+     */
+    bool pop(InboxRequest& out);
+
+    /**
+     * @brief Copies the pending requests in the order pop() would return them.
+     * @return Number of requests copied (at most max).
+     */
+    uint16_t snapshot(InboxRequest* out, uint16_t max) const;
+
+    /**
+     * @brief True if a pending request refers to this RequestBitmaps ID.
+     */
+    bool holds_bitmap(uint8_t bitmap) const;
+
+    uint16_t depth() const { return count; }
+    uint16_t free_slots() const { return INBOX_CAPACITY - count; }
+    unsigned long overflow_count() const { return overflows; }
+
+private:
+    bool outranks(uint16_t a, uint16_t b) const;
+    bool before(uint16_t a, uint16_t b, bool lowest_first) const;
+    void sift_up(uint16_t* h, uint16_t* where, bool lowest_first, uint16_t pos);
+    void sift_down(uint16_t* h, uint16_t* where, bool lowest_first, uint16_t pos);
+    void heap_remove(uint16_t* h, uint16_t* where, bool lowest_first, uint16_t pos);
+    void remove_slot(uint16_t idx);
+
+    InboxRequest slots[INBOX_CAPACITY];
+    uint16_t heap[INBOX_CAPACITY];      ///< Slot indices, highest-ranked first (max-heap).
+    uint16_t low_heap[INBOX_CAPACITY];  ///< The same slot indices, lowest-ranked first (min-heap).
+    uint16_t heap_pos[INBOX_CAPACITY];  ///< Position of each stored slot in heap.
+    uint16_t low_pos[INBOX_CAPACITY];   ///< Position of each stored slot in low_heap.
+    uint16_t free_list[INBOX_CAPACITY]; ///< Stack of unused slot indices.
+    uint16_t count;                     ///< Number of stored requests.
+    uint16_t free_top;                  ///< Number of entries in free_list.
+    uint32_t next_seq;
+    unsigned long overflows;
+};
+
+#endif // REQUEST_INBOX_H
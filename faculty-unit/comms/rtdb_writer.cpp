@@ -0,0 +1,457 @@
+#include "rtdb_writer.h"
+#include <WiFiClientSecure.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <ctype.h>
+#include "unit_log.h" // Sampled Serial/MQTT logging
+
+enum SlotState : uint8_t { SLOT_FREE, SLOT_QUEUED, SLOT_IN_FLIGHT };
+enum WriteOutcome : uint8_t { WRITE_OK, WRITE_RETRY, WRITE_REJECTED };
+
+struct WriteSlot {
+    char path[FIREBASE_PATH_LEN];
+    char body[FIREBASE_VALUE_LEN]; // JSON value
+    uint32_t seq;                  // Send order
+    unsigned long queued_us;
+    uint8_t attempts;
+    SlotState state;               // In-flight slots belong to the writer task and are not touched by put()
+};
+
+// Shared between put() (loop task) and the writer task, guarded by lock
+static WriteSlot slots[FIREBASE_WRITE_SLOTS];
+static uint32_t nextSeq = 1;
+static RtdbWriterStats writerStats = {};
+static StaticSemaphore_t lockBuffer;
+static SemaphoreHandle_t lock = nullptr;
+static TaskHandle_t writerTask = nullptr;
+
+static char host[64];
+static uint16_t port = 443;
+static char pingPath[FIREBASE_PATH_LEN];
+static RtdbTokenProvider tokenProvider = nullptr;
+
+// Writer task only
+static WiFiClientSecure tls;
+static char requestToken[FIREBASE_AUTH_LEN] = "";
+static char requestBuffer[FIREBASE_PATH_LEN + FIREBASE_VALUE_LEN + FIREBASE_AUTH_LEN + 192];
+static char lineBuffer[128];
+static unsigned long lastActivityMs = 0;
+
+static bool parse_url(const char* url) {
+    if (strncmp(url, "https://", 8) != 0) {
+        return false;
+    }
+    const char* start = url + 8;
+    size_t len = strcspn(start, ":/");
+    if (len == 0 || len >= sizeof(host)) {
+        return false;
+    }
+    memcpy(host, start, len);
+    host[len] = '\0';
+    port = start[len] == ':' ? atoi(start + len + 1) : 443;
+    return port != 0;
+}
+
+/**
+ * @brief Brings requestToken up to date from the provider. Any wait for a sign-in or
+ *        refresh happens here, on the writer task, never on the loop.
+ * @return false while there is no token.
+ */
+static bool refresh_token() {
+    if (tokenProvider == nullptr) {
+        return true;
+    }
+    if (!tokenProvider(requestToken, sizeof(requestToken))) {
+        requestToken[0] = '\0';
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Claims up to FIREBASE_PIPELINE_DEPTH queued writes, oldest first.
+ * @return Number of slot indices written to batch.
+ */
+static int claim_batch(int* batch) {
+    int count = 0;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    while (count < FIREBASE_PIPELINE_DEPTH) {
+        int oldest = -1;
+        for (int i = 0; i < FIREBASE_WRITE_SLOTS; i++) {
+            if (slots[i].state == SLOT_QUEUED && (oldest < 0 || (int32_t)(slots[i].seq - slots[oldest].seq) < 0)) {
+                oldest = i;
+            }
+        }
+        if (oldest < 0) {
+            break;
+        }
+        slots[oldest].state = SLOT_IN_FLIGHT;
+        batch[count++] = oldest;
+    }
+    xSemaphoreGive(lock);
+    return count;
+}
+
+static bool has_queued() {
+    bool queued = false;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (int i = 0; i < FIREBASE_WRITE_SLOTS && !queued; i++) {
+        queued = slots[i].state == SLOT_QUEUED;
+    }
+    xSemaphoreGive(lock);
+    return queued;
+}
+
+/**
+ * @brief Completes or requeues an in-flight write. A retry is dropped once a newer value
+ *        for the same path is queued: resending the old one could only be overwritten.
+ */
+static void finish(int index, WriteOutcome outcome) {
+    WriteSlot& slot = slots[index];
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (outcome == WRITE_OK) {
+        unsigned long latency = micros() - slot.queued_us;
+        writerStats.writes++;
+        writerStats.last_write_us = latency;
+        if (latency > writerStats.max_write_us) {
+            writerStats.max_write_us = latency;
+        }
+        slot.state = SLOT_FREE;
+    } else if (outcome == WRITE_REJECTED || slot.attempts + 1 >= FIREBASE_WRITE_RETRIES) {
+        writerStats.failures++;
+        slot.state = SLOT_FREE;
+    } else {
+        bool newer = false;
+        for (int i = 0; i < FIREBASE_WRITE_SLOTS && !newer; i++) {
+            newer = i != index && slots[i].state != SLOT_FREE && strcmp(slots[i].path, slot.path) == 0;
+        }
+        if (newer) {
+            writerStats.superseded++;
+            slot.state = SLOT_FREE;
+        } else {
+            writerStats.retries++;
+            slot.attempts++;
+            slot.state = SLOT_QUEUED;
+        }
+    }
+    xSemaphoreGive(lock);
+}
+
+static bool ensure_connected() {
+    if (tls.connected()) {
+        return true;
+    }
+    tls.stop();
+    unsigned long start = millis();
+    if (!tls.connect(host, port, FIREBASE_IO_TIMEOUT_MS)) {
+        ULOG(ULOG_WARN, "RTDB: connect to %s:%u failed", host, (unsigned)port);
+        return false;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    writerStats.connects++;
+    writerStats.last_connect_ms = millis() - start;
+    xSemaphoreGive(lock);
+    lastActivityMs = millis();
+    return true;
+}
+
+/**
+ * @brief Writes one request in a single call (one TLS record) without waiting for the response.
+ */
+static bool send_request(const char* method, const char* path, const char* query, const char* body) {
+    if (path[0] == '/') {
+        path++;
+    }
+    bool auth = requestToken[0] != '\0';
+    int len = snprintf(requestBuffer, sizeof(requestBuffer),
+                       "%s /%s.json?%s%s%s%s HTTP/1.1\r\nHost: %s:%u\r\nConnection: keep-alive\r\n"
+                       "Content-Type: application/json\r\nContent-Length: %u\r\n\r\n%s",
+                       method, path, query, auth && query[0] != '\0' ? "&" : "", auth ? "auth=" : "",
+                       requestToken, host, (unsigned)port, (unsigned)strlen(body), body);
+    if (len < 0 || (size_t)len >= sizeof(requestBuffer)) {
+        return false;
+    }
+    return tls.write((const uint8_t*)requestBuffer, len) == (size_t)len;
+}
+
+/**
+ * @brief Reads one line (without CRLF) before the deadline; longer lines are truncated.
+ * @return The line length, or -1 on timeout or disconnect.
+ */
+static int read_line(unsigned long deadline) {
+    size_t len = 0;
+    while ((long)(deadline - millis()) > 0) {
+        int c = tls.read();
+        if (c < 0) {
+            if (!tls.connected()) {
+                return -1;
+            }
+            vTaskDelay(1);
+            continue;
+        }
+        if (c == '\n') {
+            if (len > 0 && lineBuffer[len - 1] == '\r') {
+                len--;
+            }
+            lineBuffer[len] = '\0';
+            return len;
+        }
+        if (len + 1 < sizeof(lineBuffer)) {
+            lineBuffer[len++] = c;
+        }
+    }
+    return -1;
+}
+
+static bool skip_bytes(long count, unsigned long deadline) {
+    while (count > 0 && (long)(deadline - millis()) > 0) {
+        int n = tls.read((uint8_t*)requestBuffer, count < (long)sizeof(requestBuffer) ? count : sizeof(requestBuffer));
+        if (n > 0) {
+            count -= n;
+        } else if (!tls.connected()) {
+            return false;
+        } else {
+            vTaskDelay(1);
+        }
+    }
+    return count == 0;
+}
+
+/**
+ * @brief Reads one response and discards its body (Content-Length, chunked or to close).
+ * @param keep_alive Cleared if the server closes the connection after this response.
+ * @return The HTTP status, or -1 on a broken connection or timeout.
+ */
+static int read_response(bool* keep_alive) {
+    unsigned long deadline = millis() + FIREBASE_IO_TIMEOUT_MS;
+    int status = 0;
+    if (read_line(deadline) < 0 || sscanf(lineBuffer, "HTTP/1.%*d %d", &status) != 1) {
+        return -1;
+    }
+
+    long content_length = -1;
+    bool chunked = false;
+    *keep_alive = true;
+    for (;;) {
+        int len = read_line(deadline);
+        if (len < 0) {
+            return -1;
+        }
+        if (len == 0) {
+            break;
+        }
+        for (char* c = lineBuffer; *c != '\0'; c++) {
+            *c = tolower((unsigned char)*c);
+        }
+        if (strncmp(lineBuffer, "content-length:", 15) == 0) {
+            content_length = atol(lineBuffer + 15);
+        } else if (strncmp(lineBuffer, "transfer-encoding:", 18) == 0 && strstr(lineBuffer, "chunked") != nullptr) {
+            chunked = true;
+        } else if (strncmp(lineBuffer, "connection:", 11) == 0 && strstr(lineBuffer, "close") != nullptr) {
+            *keep_alive = false;
+        }
+    }
+
+    if (chunked) {
+        for (;;) {
+            if (read_line(deadline) < 0) {
+                return -1;
+            }
+            long size = strtol(lineBuffer, nullptr, 16);
+            if (size == 0) {
+                int len;
+                while ((len = read_line(deadline)) > 0) {
+                } // Trailers
+                return len < 0 ? -1 : status;
+            }
+            if (!skip_bytes(size + 2, deadline)) { // Chunk data and its CRLF
+                return -1;
+            }
+        }
+    }
+    if (content_length >= 0) {
+        return skip_bytes(content_length, deadline) ? status : -1;
+    }
+    *keep_alive = false; // Body runs to connection close
+    while (tls.connected() && (long)(deadline - millis()) > 0) {
+        skip_bytes(sizeof(requestBuffer), deadline);
+    }
+    return status;
+}
+
+/**
+ * @brief Cheap shallow GET that keeps an idle connection from being closed by the server or a NAT.
+ */
+static void ping() {
+    if (refresh_token()) {
+        bool keep_alive = false;
+        if (!send_request("GET", pingPath, "shallow=true", "") || read_response(&keep_alive) < 0 || !keep_alive) {
+            tls.stop(); // Reconnected by the next write
+        }
+        xSemaphoreTake(lock, portMAX_DELAY);
+        writerStats.pings++;
+        xSemaphoreGive(lock);
+    }
+    lastActivityMs = millis();
+}
+
+static void writer_task(void*) {
+    int batch[FIREBASE_PIPELINE_DEPTH];
+    unsigned long backoff = FIREBASE_RETRY_BACKOFF_MS;
+    for (;;) {
+        if (!has_queued()) {
+            TickType_t wait = portMAX_DELAY;
+            if (tls.connected()) {
+                unsigned long idle = millis() - lastActivityMs;
+                wait = pdMS_TO_TICKS(idle < FIREBASE_KEEPALIVE_MS ? FIREBASE_KEEPALIVE_MS - idle : 0);
+            }
+            ulTaskNotifyTake(pdTRUE, wait);
+        }
+
+        if (has_queued() && !refresh_token()) {
+            vTaskDelay(pdMS_TO_TICKS(FIREBASE_RETRY_BACKOFF_MS)); // Not signed in yet; the writes stay queued
+            continue;
+        }
+
+        int count = claim_batch(batch);
+        if (count == 0) {
+            if (tls.connected() && millis() - lastActivityMs >= FIREBASE_KEEPALIVE_MS) {
+                ping();
+            }
+            continue;
+        }
+
+        bool retry = false;
+        int done = 0;
+        if (ensure_connected()) {
+            // Pipelined: every request goes out before the first response is read
+            int sent = 0;
+            while (sent < count && send_request("PUT", slots[batch[sent]].path, "", slots[batch[sent]].body)) {
+                sent++;
+            }
+            bool keep_alive = true;
+            while (done < sent && keep_alive) {
+                int status = read_response(&keep_alive);
+                if (status < 0) {
+                    break;
+                }
+                WriteOutcome outcome = status >= 200 && status < 300          ? WRITE_OK
+                                       : status >= 500 || status == 429       ? WRITE_RETRY
+                                                                               : WRITE_REJECTED;
+                if (outcome != WRITE_OK) {
+                    ULOG(ULOG_WARN, "RTDB: PUT /%s returned %d", slots[batch[done]].path, status);
+                }
+                retry |= outcome == WRITE_RETRY;
+                finish(batch[done++], outcome);
+            }
+            if (done < count || !keep_alive) {
+                tls.stop(); // Unanswered requests are resent on a fresh connection
+            }
+            lastActivityMs = millis();
+        }
+        for (int i = done; i < count; i++) {
+            finish(batch[i], WRITE_RETRY);
+            retry = true;
+        }
+
+        if (retry) {
+            vTaskDelay(pdMS_TO_TICKS(backoff));
+            backoff = backoff * 2 > FIREBASE_RETRY_MAX_BACKOFF_MS ? FIREBASE_RETRY_MAX_BACKOFF_MS : backoff * 2;
+        } else {
+            backoff = FIREBASE_RETRY_BACKOFF_MS;
+        }
+    }
+}
+
+bool RtdbWriter::begin(const char* database_url, const char* ping_path) {
+    if (!parse_url(database_url) || strlen(ping_path) >= sizeof(pingPath)) {
+        ULOG(ULOG_ERROR, "RTDB: bad database URL or ping path");
+        return false;
+    }
+    strcpy(pingPath, ping_path);
+#ifdef FIREBASE_ROOT_CA
+    tls.setCACert(FIREBASE_ROOT_CA);
+#else
+    tls.setInsecure(); // Same as the Firebase client without a certificate configured
+#endif
+    tls.setHandshakeTimeout(FIREBASE_IO_TIMEOUT_MS / 1000);
+
+    lock = xSemaphoreCreateMutexStatic(&lockBuffer);
+    if (xTaskCreatePinnedToCore(writer_task, "rtdb_writer", FIREBASE_WRITER_STACK, nullptr, tskIDLE_PRIORITY + 1,
+                                &writerTask, 0) != pdPASS) {
+        ULOG(ULOG_ERROR, "RTDB: writer task failed to start");
+        return false;
+    }
+    ULOG(ULOG_INFO, "RTDB writer for %s:%u started", host, (unsigned)port);
+    return true;
+}
+
+void RtdbWriter::set_token_provider(RtdbTokenProvider provider) {
+    tokenProvider = provider;
+}
+
+bool RtdbWriter::put(const char* path, const char* json_value) {
+    if (lock == nullptr || strlen(path) >= FIREBASE_PATH_LEN || strlen(json_value) >= FIREBASE_VALUE_LEN) {
+        return false;
+    }
+    WriteSlot* slot = nullptr;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (int i = 0; i < FIREBASE_WRITE_SLOTS && slot == nullptr; i++) {
+        if (slots[i].state == SLOT_QUEUED && strcmp(slots[i].path, path) == 0) {
+            slot = &slots[i]; // Not sent yet; the newer value replaces it
+            writerStats.superseded++;
+        }
+    }
+    for (int i = 0; i < FIREBASE_WRITE_SLOTS && slot == nullptr; i++) {
+        if (slots[i].state == SLOT_FREE) {
+            slot = &slots[i];
+        }
+    }
+    if (slot != nullptr) {
+        strcpy(slot->path, path);
+        strcpy(slot->body, json_value);
+        slot->seq = nextSeq++;
+        slot->queued_us = micros();
+        slot->attempts = 0;
+        slot->state = SLOT_QUEUED;
+    }
+    xSemaphoreGive(lock);
+
+    if (slot == nullptr) {
+        ULOG(ULOG_WARN, "RTDB: write queue full, dropping write to %s", path);
+        return false;
+    }
+    xTaskNotifyGive(writerTask);
+    return true;
+}
+
+bool RtdbWriter::put_string(const char* path, const char* value) {
+    char json[FIREBASE_VALUE_LEN];
+    size_t len = 0;
+    json[len++] = '"';
+    for (const char* c = value; *c != '\0'; c++) {
+        if (len + 3 >= sizeof(json)) {
+            return false;
+        }
+        if (*c == '"' || *c == '\\') {
+            json[len++] = '\\';
+        }
+        if ((unsigned char)*c >= 0x20) {
+            json[len++] = *c;
+        }
+    }
+    json[len++] = '"';
+    json[len] = '\0';
+    return put(path, json);
+}
+
+RtdbWriterStats RtdbWriter::stats() {
+    RtdbWriterStats copy = {};
+    if (lock != nullptr) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        copy = writerStats;
+        xSemaphoreGive(lock);
+    }
+    return copy;
+}
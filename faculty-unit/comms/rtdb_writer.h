@@ -0,0 +1,76 @@
+#ifndef RTDB_WRITER_H
+#define RTDB_WRITER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @brief Write counters and latencies. Latency runs from put() to the server's response.
+ */
+struct RtdbWriterStats {
+    unsigned long writes;         ///< Acknowledged with a 2xx status.
+    unsigned long failures;       ///< Rejected (4xx) or given up after FIREBASE_WRITE_RETRIES.
+    unsigned long retries;        ///< Resends after an I/O error, 5xx or 429.
+    unsigned long superseded;     ///< Queued writes replaced by a newer value for the same path.
+    unsigned long connects;       ///< TLS handshakes.
+    unsigned long pings;          ///< Keep-alive requests on an idle connection.
+    unsigned long last_write_us;
+    unsigned long max_write_us;
+    unsigned long last_connect_ms; ///< Duration of the last handshake.
+};
+
+/**
+ * @brief Fetches the ID token appended as ?auth=. Runs on the writer task, so it may block
+ *        (e.g. while the token is refreshed). `out` still holds the token it returned last
+ *        time and may be left unchanged when that one is still valid.
+ * @return false while no token is available; queued writes wait until there is one.
+ */
+typedef bool (*RtdbTokenProvider)(char* out, size_t out_size);
+
+/**
+ * @brief Firebase Realtime Database REST writes over one persistent HTTPS connection.
+ *
+ * put() only queues (FIREBASE_WRITE_SLOTS); a writer task on core 0 sends the queue over a
+ * kept-alive HTTP/1.1 connection, up to FIREBASE_PIPELINE_DEPTH requests back to back
+ * before reading their responses in order. While idle, a small GET every
+ * FIREBASE_KEEPALIVE_MS keeps the connection (and NAT mapping) open, so a status change
+ * normally pays one round trip instead of a TLS handshake.
+ *
+ * A PUT replaces the value at its path, so resending one after a lost response is
+ * idempotent. Writes are retried with backoff on I/O errors, 5xx and 429; a queued write
+ * is replaced by a newer value for the same path, and a failed write is not retried once
+ * a newer one for its path is queued, so a retry can never overwrite a later value.
+ *
+ * One connection only: each TLS session costs about 40 KB of heap.
+ */
+class RtdbWriter {
+public:
+    /**
+     * @brief Starts the writer task.
+     * @param database_url e.g. "https://project.firebaseio.com" or "https://192.168.1.10:8443" (a stand-in).
+     * @param ping_path Database path read by keep-alive pings (shallow), e.g. the unit's status path.
+     * @return false if the URL could not be parsed or the task could not start.
+     */
+    static bool begin(const char* database_url, const char* ping_path);
+
+    /**
+     * @brief Sets the token provider, asked before every batch and ping. Without one,
+     *        requests carry no auth (databases that need none). Call before the first put().
+     */
+    static void set_token_provider(RtdbTokenProvider provider);
+
+    /**
+     * @brief Queues a JSON value for PUT at path. Never blocks on the network.
+     * @return false if the queue is full or the value or path is too long.
+     */
+    static bool put(const char* path, const char* json_value);
+
+    /**
+     * @brief put() with a string value, quoted and escaped.
+     */
+    static bool put_string(const char* path, const char* value);
+
+    static RtdbWriterStats stats();
+};
+
+#endif // RTDB_WRITER_H
@@ -0,0 +1,70 @@
+#include "status_datagram.h"
+#include <string.h>
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+size_t status_datagram_encode(const StatusDatagram& in, uint8_t* out, size_t out_size) {
+    size_t id_len = strnlen(in.faculty_id, sizeof(in.faculty_id));
+    if (id_len >= sizeof(in.faculty_id) || STATUS_DATAGRAM_HEADER_LEN + id_len > out_size) {
+        return 0;
+    }
+    out[0] = 'C';
+    out[1] = 'S';
+    out[2] = STATUS_DATAGRAM_VERSION;
+    out[3] = (in.present ? 1 : 0) | ((in.status & 0x03) << 1);
+    put_u16(out + 4, in.epoch);
+    put_u32(out + 6, in.seq);
+    put_u32(out + 10, in.sent_us);
+    out[14] = in.depth;
+    out[15] = (uint8_t)id_len;
+    memcpy(out + STATUS_DATAGRAM_HEADER_LEN, in.faculty_id, id_len);
+    return STATUS_DATAGRAM_HEADER_LEN + id_len;
+}
+
+bool status_datagram_decode(const uint8_t* in, size_t len, StatusDatagram& out) {
+    if (len < STATUS_DATAGRAM_HEADER_LEN || in[0] != 'C' || in[1] != 'S' || in[2] != STATUS_DATAGRAM_VERSION) {
+        return false;
+    }
+    size_t id_len = in[15];
+    if (id_len == 0 || id_len >= sizeof(out.faculty_id) || STATUS_DATAGRAM_HEADER_LEN + id_len != len) {
+        return false;
+    }
+    out.present = in[3] & 0x01;
+    out.status = (in[3] >> 1) & 0x03;
+    out.epoch = get_u16(in + 4);
+    out.seq = get_u32(in + 6);
+    out.sent_us = get_u32(in + 10);
+    out.depth = in[14];
+    memcpy(out.faculty_id, in + STATUS_DATAGRAM_HEADER_LEN, id_len);
+    out.faculty_id[id_len] = '\0';
+    return true;
+}
+
+uint8_t status_code_from_name(const char* status) {
+    if (strcmp(status, "available") == 0) {
+        return STATUS_CODE_AVAILABLE;
+    }
+    if (strcmp(status, "busy") == 0) {
+        return STATUS_CODE_BUSY;
+    }
+    if (strcmp(status, "away") == 0) {
+        return STATUS_CODE_AWAY;
+    }
+    return STATUS_CODE_UNKNOWN;
+}
@@ -0,0 +1,65 @@
+#ifndef STATUS_DATAGRAM_H
+#define STATUS_DATAGRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @brief Manual status codes, the same values StatusAdvertiser puts on air.
+ */
+enum StatusCode : uint8_t {
+    STATUS_CODE_UNKNOWN = 0,
+    STATUS_CODE_AVAILABLE,
+    STATUS_CODE_BUSY,
+    STATUS_CODE_AWAY
+};
+
+/**
+ * @brief One decoded status datagram.
+ */
+struct StatusDatagram {
+    uint16_t epoch;   ///< Random per sender boot; a new epoch restarts the sequence.
+    uint32_t seq;     ///< Incremented for every datagram the sender emits.
+    uint32_t sent_us; ///< Sender's micros() at send time (only comparable on one clock).
+    bool present;     ///< Faculty beacon in range.
+    uint8_t status;   ///< StatusCode
+    uint8_t depth;    ///< Pending requests (inbox depth, capped at 255).
+    char faculty_id[STATUS_DATAGRAM_ID_LEN];
+};
+
+/**
+ * Wire layout (little-endian), STATUS_DATAGRAM_HEADER_LEN bytes plus the ID:
+ *   [0..1]   'C' 'S'
+ *   [2]      STATUS_DATAGRAM_VERSION
+ *   [3]      bit 0 = present, bits 1-2 = StatusCode
+ *   [4..5]   epoch
+ *   [6..9]   seq
+ *   [10..13] sent_us
+ *   [14]     depth
+ *   [15]     faculty ID length, followed by the ID (not terminated)
+ *
+ * Plain C++ without Arduino dependencies, so the same codec builds into the unit's
+ * emitter and into receivers on other hosts.
+ */
+#define STATUS_DATAGRAM_HEADER_LEN 16
+#define STATUS_DATAGRAM_MAX_LEN (STATUS_DATAGRAM_HEADER_LEN + STATUS_DATAGRAM_ID_LEN - 1)
+
+/**
+ * @brief Serializes a datagram.
+ * @return Bytes written, or 0 if out_size is too small or the ID too long.
+ */
+size_t status_datagram_encode(const StatusDatagram& in, uint8_t* out, size_t out_size);
+
+/**
+ * @brief Parses a datagram; faculty_id is null-terminated on success.
+ * @return false for foreign traffic, another version or a truncated datagram.
+ */
+bool status_datagram_decode(const uint8_t* in, size_t len, StatusDatagram& out);
+
+/**
+ * @brief Maps "available" / "busy" / "away" to a StatusCode (anything else is unknown).
+ */
+uint8_t status_code_from_name(const char* status);
+
+#endif // STATUS_DATAGRAM_H
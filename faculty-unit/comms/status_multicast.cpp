@@ -0,0 +1,68 @@
+#include "status_multicast.h"
+#include "status_datagram.h" // Wire format shared with StatusReceiver
+#include "timer_wheel.h"     // Heartbeat
+#include <WiFi.h>
+#include <lwip/sockets.h>
+
+static StatusDatagram current = {};
+static int sock = -1;
+static sockaddr_in groupAddr = {};
+static WheelTimer heartbeatTimer; // Active until the next unchanged resend is due
+static bool sentOnce = false;
+static unsigned long sent = 0;
+static unsigned long failed = 0;
+
+static bool open_socket() {
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        return false;
+    }
+    uint8_t ttl = STATUS_MULTICAST_TTL;
+    setsockopt(sock, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    groupAddr.sin_family = AF_INET;
+    groupAddr.sin_port = htons(STATUS_MULTICAST_PORT);
+    groupAddr.sin_addr.s_addr = inet_addr(STATUS_MULTICAST_GROUP);
+    return true;
+}
+
+void StatusMulticast::begin(const char* faculty_id) {
+    strncpy(current.faculty_id, faculty_id, sizeof(current.faculty_id) - 1);
+    current.epoch = (uint16_t)esp_random();
+    current.seq = 0;
+}
+
+void StatusMulticast::update(bool present, const char* status, uint16_t inbox_depth) {
+    uint8_t code = status_code_from_name(status);
+    uint8_t depth = inbox_depth > 0xFF ? 0xFF : inbox_depth;
+    bool changed = !sentOnce || present != current.present || code != current.status || depth != current.depth;
+    if (!changed && heartbeatTimer.active()) {
+        return;
+    }
+    if (WiFi.status() != WL_CONNECTED || (sock < 0 && !open_socket())) {
+        return; // Sent once connected; receivers only ever see the latest state
+    }
+
+    current.present = present;
+    current.status = code;
+    current.depth = depth;
+    current.seq++;
+    current.sent_us = micros();
+
+    uint8_t buf[STATUS_DATAGRAM_MAX_LEN];
+    size_t len = status_datagram_encode(current, buf, sizeof(buf));
+    if (len > 0 && sendto(sock, buf, len, MSG_DONTWAIT, (sockaddr*)&groupAddr, sizeof(groupAddr)) == (ssize_t)len) {
+        sent++;
+    } else {
+        failed++; // Not retried; the heartbeat resends
+    }
+    sentOnce = true;
+    TimerWheel::schedule(heartbeatTimer, STATUS_MULTICAST_HEARTBEAT_MS, nullptr, nullptr);
+}
+
+unsigned long StatusMulticast::sent_count() {
+    return sent;
+}
+
+unsigned long StatusMulticast::failed_count() {
+    return failed;
+}
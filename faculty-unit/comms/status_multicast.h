@@ -0,0 +1,34 @@
+#ifndef STATUS_MULTICAST_H
+#define STATUS_MULTICAST_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @brief Sends the unit's status as a StatusDatagram to STATUS_MULTICAST_GROUP, so
+ *        displays and kiosks on the same subnet see changes without the broker hop.
+ *
+ * A datagram goes out whenever presence, manual status or inbox depth changes, and
+ * again every STATUS_MULTICAST_HEARTBEAT_MS. Receivers (StatusReceiver) use the
+ * sequence number to drop duplicates and count losses. Delivery is best effort: MQTT
+ * stays the source of truth.
+ */
+class StatusMulticast {
+public:
+    /**
+     * @brief Picks a random epoch for this boot. The socket is opened on the first
+     *        update() with WiFi connected.
+     */
+    static void begin(const char* faculty_id);
+
+    /**
+     * @brief Sends a datagram if a field changed or the heartbeat is due. Cheap when
+     *        nothing changed, so it can be called every loop pass.
+     */
+    static void update(bool present, const char* status, uint16_t inbox_depth);
+
+    static unsigned long sent_count();
+    static unsigned long failed_count();
+};
+
+#endif // STATUS_MULTICAST_H
@@ -0,0 +1,110 @@
+#include "status_receiver.h"
+#include <string.h>
+#ifdef ARDUINO
+#include <lwip/sockets.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+static uint32_t hash_id(const char* id) {
+    uint32_t h = 2166136261u;
+    for (const char* p = id; *p != '\0'; p++) {
+        h = (h ^ (uint8_t)*p) * 16777619u;
+    }
+    return h;
+}
+
+StatusReceiver::StatusReceiver() : sender_count(0), sock(-1), counters() {}
+
+bool StatusReceiver::begin(const char* group, uint16_t port, const char* interface_ip) {
+    end();
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        return false;
+    }
+
+    int reuse = 1; // Several consumers on one host share the port
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    ip_mreq mreq = {};
+    mreq.imr_multiaddr.s_addr = inet_addr(group);
+    mreq.imr_interface.s_addr = interface_ip != nullptr ? inet_addr(interface_ip) : htonl(INADDR_ANY);
+
+    if (bind(sock, (sockaddr*)&addr, sizeof(addr)) < 0 ||
+        setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+        end();
+        return false;
+    }
+    return true;
+}
+
+void StatusReceiver::end() {
+    if (sock >= 0) {
+        close(sock);
+        sock = -1;
+    }
+}
+
+bool StatusReceiver::accept(const StatusDatagram& datagram) {
+    uint32_t key = hash_id(datagram.faculty_id);
+    Sender* sender = nullptr;
+    for (uint16_t i = 0; i < sender_count; i++) {
+        if (senders[i].key == key) {
+            sender = &senders[i];
+            break;
+        }
+    }
+
+    if (sender == nullptr) {
+        if (sender_count < STATUS_RECEIVER_MAX_SENDERS) {
+            senders[sender_count++] = {key, datagram.epoch, datagram.seq};
+        }
+        return true; // An untracked sender (table full) is passed through unfiltered
+    }
+    if (sender->epoch != datagram.epoch) {
+        counters.restarts++;
+        sender->epoch = datagram.epoch;
+        sender->seq = datagram.seq;
+        return true;
+    }
+
+    // Signed difference, so wraparound is harmless
+    int32_t ahead = (int32_t)(datagram.seq - sender->seq);
+    if (ahead <= 0) {
+        counters.stale++;
+        return false;
+    }
+    counters.lost += ahead - 1;
+    sender->seq = datagram.seq;
+    return true;
+}
+
+bool StatusReceiver::poll(StatusDatagram& out) {
+    if (sock < 0) {
+        return false;
+    }
+    uint8_t buf[STATUS_DATAGRAM_MAX_LEN + 1]; // One spare byte exposes oversized datagrams
+    for (;;) {
+        ssize_t len = recv(sock, buf, sizeof(buf), MSG_DONTWAIT);
+        if (len < 0) {
+            return false; // EWOULDBLOCK: drained
+        }
+        counters.received++;
+        if (!status_datagram_decode(buf, (size_t)len, out)) {
+            counters.malformed++;
+            continue;
+        }
+        if (accept(out)) {
+            counters.accepted++;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef STATUS_RECEIVER_H
+#define STATUS_RECEIVER_H
+
+#include "status_datagram.h"
+
+/**
+ * @brief Counters since begin(). A sender's first datagram and its restarts are not losses.
+ */
+struct StatusReceiverStats {
+    unsigned long received;   ///< Datagrams read from the socket.
+    unsigned long accepted;   ///< Returned by poll().
+    unsigned long stale;      ///< Duplicates and reordered datagrams older than one already accepted.
+    unsigned long lost;       ///< Sequence numbers skipped between accepted datagrams.
+    unsigned long malformed;  ///< Foreign traffic or another version on the port.
+    unsigned long restarts;   ///< Senders seen with a new epoch.
+};
+
+/**
+ * @brief Joins STATUS_MULTICAST_GROUP and returns each unit's status datagrams in
+ *        sequence order, dropping duplicates and reordered stale ones.
+ *
+ * Sequence state is kept per sender (FNV-1a hash of the faculty ID) in a fixed table
+ * of STATUS_RECEIVER_MAX_SENDERS, so nothing is allocated after begin(). Uses BSD
+ * sockets only: the same code runs on a directory board (lwIP) and on a host.
+ */
+class StatusReceiver {
+public:
+    StatusReceiver();
+
+    /**
+     * @brief Opens a non-blocking UDP socket on `port` and joins `group`.
+     * @param interface_ip Local address to join on, nullptr for the default interface.
+     * @return false if the socket cannot be opened or the group cannot be joined.
+     */
+    bool begin(const char* group, uint16_t port, const char* interface_ip = nullptr);
+
+    /**
+     * @brief Reads queued datagrams until a fresh one is found. Never blocks.
+     * @param out Receives the datagram.
+     * @return true if out holds a new status, false once the socket is drained.
+     */
+    bool poll(StatusDatagram& out);
+
+    /**
+     * @brief Socket descriptor for select()/poll() on hosts that wait for traffic; -1 before begin().
+     */
+    int fd() const { return sock; }
+
+    void end();
+
+    const StatusReceiverStats& stats() const { return counters; }
+
+private:
+    struct Sender {
+        uint32_t key;   ///< Hash of the faculty ID.
+        uint16_t epoch;
+        uint32_t seq;   ///< Last accepted sequence number.
+    };
+
+    bool accept(const StatusDatagram& datagram);
+
+    Sender senders[STATUS_RECEIVER_MAX_SENDERS];
+    uint16_t sender_count;
+    int sock;
+    StatusReceiverStats counters;
+};
+
+#endif // STATUS_RECEIVER_H
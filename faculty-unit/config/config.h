@@ -20,11 +20,216 @@
 #define MQTT_AVAILABILITY_TOPIC_TEMPLATE "consultease/faculty/%s/availability"
 // Topic for acknowledging requests (faculty units publish to this)
 #define MQTT_ACKNOWLEDGE_TOPIC_TEMPLATE "consultease/requests/%s/acknowledge" // %s is request ID
+// Topic for inbound request counters (accepted/dropped). %s is faculty ID.
+#define MQTT_REQUEST_STATS_TOPIC_TEMPLATE "consultease/faculty/%s/request_stats"
+// Topic for inbox capacity/credit records used by the central system for pacing. %s is faculty ID.
+#define MQTT_CAPACITY_TOPIC_TEMPLATE "consultease/faculty/%s/capacity"
+// Topic for the unit's retained capability record (supported payload codecs). %s is faculty ID.
+#define MQTT_CAPABILITIES_TOPIC_TEMPLATE "consultease/faculty/%s/capabilities"
+// Topic filter for QOI asset uploads (photo, status icons). %s is faculty ID; last level is the asset name.
+#define MQTT_ASSET_TOPIC_TEMPLATE "consultease/faculty/%s/asset/+"
+// Topics for remote command batches and the batched results published back. %s is faculty ID.
+#define MQTT_COMMAND_TOPIC_TEMPLATE "consultease/faculty/%s/commands"
+#define MQTT_COMMAND_RESULT_TOPIC_TEMPLATE "consultease/faculty/%s/commands/result"
+// Topic for per-request latency traces (requests carrying a "trace_id"). %s is faculty ID.
+#define MQTT_TRACE_TOPIC_TEMPLATE "consultease/faculty/%s/trace"
+// Topic for batched log frames (see core/unit_log.h). %s is faculty ID.
+#define MQTT_LOG_TOPIC_TEMPLATE "consultease/faculty/%s/log"
+#define MQTT_BUFFER_SIZE 1024                 // PubSubClient packet buffer (default 256 is too small for asset chunks)
+
+// Inbound Request Rate Limiting (token bucket per student_id)
+#define REQUEST_RATE_TABLE_SIZE 16        // Number of student buckets tracked (fixed table, oldest entry evicted)
+#define REQUEST_RATE_BURST 3              // Maximum requests a student may send back-to-back
+#define REQUEST_RATE_REFILL_MS 10000      // One token is refilled every this many ms
+#define REQUEST_STATS_PUBLISH_MS 30000    // Minimum interval between request counter publishes
+
+// Request Inbox
+#ifndef INBOX_CAPACITY
+#define INBOX_CAPACITY 8                  // Pending requests held on the unit (a build flag may override it; at most 253)
+#endif
+#define INBOX_STUDENT_ID_LEN 32           // Max student ID length (including terminator)
+#define INBOX_TEXT_LEN 200                // Max request text length (including terminator)
+#define REQUEST_MIN_DISPLAY_MS 5000       // Each request stays on screen at least this long
+#define CAPACITY_PUBLISH_MIN_MS 500       // Minimum interval between capacity record publishes
+#define CAPACITY_HEARTBEAT_MS 60000       // Republish the capacity record at least this often
+
+// Compressed request text ("request_text_hs": base64 heatshrink stream)
+// Must match WINDOW_BITS/LOOKAHEAD_BITS in central-system/comms/heatshrink.py
+#define HEATSHRINK_WINDOW_BITS 8
+#define HEATSHRINK_LOOKAHEAD_BITS 4
+#define HEATSHRINK_CODEC_TAG "hs8.4"      // Capability tag advertised to the central system
+
+// Rasterized request text ("request_text_bitmap": base64 1/2-bit RLE bitmap)
+// Must match central-system/comms/text_raster.py
+#define TEXT_BITMAP_CODEC_TAG "rle2"      // Capability tag advertised to the central system
+#define REQUEST_BITMAP_MAX_BYTES 576      // Largest decoded bitmap (header + runs); 768 base64 chars leave room in MQTT_BUFFER_SIZE
+#define REQUEST_BITMAP_SLOTS (INBOX_CAPACITY + 2) // One per inbox entry, plus the one on screen and an arriving one
+#define REQUEST_BITMAP_ALT_TEXT "[Message sent as image]" // Stored as the text when only a bitmap arrives
+#define REQUEST_TEXT_Y 40                 // Top of the request text area, below the "From:" line
 
 // BLE Configuration
 #define TARGET_BLE_ADDRESS "AA:BB:CC:DD:EE:FF" // Replace with the actual faculty beacon MAC address
 #define BLE_SCAN_DURATION 5                   // Scan duration in seconds
-#define PRESENCE_TIMEOUT_MS 15000             // Timeout in milliseconds for presence detection
+#define BLE_SCAN_INTERVAL_MS ((BLE_SCAN_DURATION * 1000) + 1000) // Scan start to scan start
+#define PRESENCE_TIMEOUT_MS 15000             // Presence timeout until the beacon's advertising interval is learned
+#define PRESENCE_TIMEOUT_MIN_MS 3000          // Bounds for the learned (adaptive) presence timeout
+#define PRESENCE_TIMEOUT_MAX_MS 60000
+#define PRESENCE_FALSE_ABSENCE_TARGET 0.001f  // Acceptable chance of declaring a present beacon absent
+#define PRESENCE_MIN_ADV_GAP_MS 20            // Shorter gaps are scan responses, not new adverts
+#define ADVERT_RING_SIZE 32                   // Target sightings buffered between BLE callback and loop task
+#define BLE_PHASE_LOCK 1                      // 1 = scan short windows around predicted adverts once learned
+#define BLE_PHASE_HALF_WINDOW_MS 25           // Base half-width of an aligned window
+#define BLE_ADV_DELAY_MAX_MS 10               // BLE advDelay: random 0-10 ms added to every advertising event
+#define BLE_PHASE_MAX_MISSES 3                // Consecutive missed windows before falling back to blind scans
+#define BLE_STATUS_ADVERTISING 1              // 1 = broadcast status in a non-connectable advertisement
+#define BLE_STATUS_COMPANY_ID 0xFFFF          // Manufacturer data company ID (0xFFFF = testing/unassigned)
+#define BLE_STATUS_FORMAT_VERSION 1           // First byte of the status payload
+#define BLE_STATUS_ADV_INTERVAL_MS 1000       // Advertising interval for the status broadcast
+
+// Memory Budgets (all buffers are static; nothing on the hot path uses the heap)
+#define JSON_REQUEST_DOC_SIZE 256         // Parsed consultation request (fields only; strings stay in the payload)
+#define JSON_COMMAND_DOC_SIZE 768         // Parsed remote command batch (fields only; strings stay in the payload)
+#define COMMAND_BATCH_MAX 8               // Commands run per message; the rest are skipped and counted
+// Batched command results: batch_id, results, error and skipped, plus one entry per command
+// with id, ok, error and one handler field. Strings are linked, not copied.
+#define JSON_COMMAND_RESULT_DOC_SIZE \
+    (JSON_OBJECT_SIZE(4) + JSON_ARRAY_SIZE(COMMAND_BATCH_MAX) + COMMAND_BATCH_MAX * JSON_OBJECT_SIZE(4))
+#define COMMAND_RESULT_LEN 768            // Serialized command results; stays under MQTT_BUFFER_SIZE with the topic
+#define JSON_STATUS_DOC_SIZE 256          // Status message being serialized
+#define STATUS_PAYLOAD_LEN 256            // Serialized status message
+#define MANUAL_STATUS_LEN 16              // "available" / "busy" / "away" plus terminator
+#define MESSAGE_ARENA_SIZE 2048           // Per-message scratch arena (payload copy + JSON pool + decoded text)
+
+// Heap Guard (detects heap allocations on the loop task after setup())
+#define HEAP_GUARD_OFF 0
+#define HEAP_GUARD_COUNT 1                // Count and report steady-state allocations (heap growth only without CONFIG_HEAP_USE_HOOKS)
+#define HEAP_GUARD_ASSERT 2               // Abort on the first steady-state allocation (debug builds; needs CONFIG_HEAP_USE_HOOKS)
+#ifndef HEAP_GUARD_MODE
+#define HEAP_GUARD_MODE HEAP_GUARD_COUNT
+#endif
+#define HEAP_GUARD_REPORT_MS 60000        // Interval between heap guard reports
+
+// Warm Restart (state snapshot kept in RTC slow memory across resets)
+#define WARM_STATE_MAGIC 0x57524D31       // Marks a written record
+#define WARM_STATE_VERSION 5              // Bump when WarmSnapshot changes layout
+#define WARM_STATE_RTC_BUDGET 4096        // Bytes of the 8 KB RTC slow memory the record may take (ULP and RTC_DATA use the rest)
+
+// Power Mode (select with a build flag, e.g. -DPOWER_MODE=POWER_MODE_BATTERY)
+#define POWER_MODE_MAINS 0                // Always on: continuous scanning, display and loop()
+#define POWER_MODE_BATTERY 1              // Deep sleep between wake/scan/publish cycles
+#ifndef POWER_MODE
+#define POWER_MODE POWER_MODE_MAINS
+#endif
+#define BATTERY_WAKE_INTERVAL_MS 60000    // Deep sleep between cycles
+#define BATTERY_AWAKE_MAX_MS 15000        // A cycle sleeps after this even if work is pending
+#define BATTERY_MQTT_LINGER_MS 1500       // Stay connected this long to receive queued requests
+#define BATTERY_MAX_BUTTONS 3             // Buttons watched by the ULP (RTC GPIOs, active-low)
+// Energy-budget model (measure your board and adjust)
+#define BATTERY_CAPACITY_MAH 2500
+#define BATTERY_USABLE_PERCENT 80         // Derating for cutoff voltage and self-discharge
+#define BATTERY_ACTIVE_MA 130             // Average current while awake (Wi-Fi + BLE + panel)
+#define BATTERY_SLEEP_UA 150              // ESP32 deep sleep with RTC peripherals and ULP polling, display excluded
+#define BATTERY_DISPLAY_ASLEEP 1          // 1 = panel keeps showing the last frame (idle mode) through deep sleep
+                                          // 0 = panel sleeps: nothing is visible until the next wake
+#define BATTERY_PANEL_IDLE_UA 4000        // ILI9341 driver in idle mode (8 colours), refreshing the last frame
+#define BATTERY_PANEL_SLEEP_UA 10         // ILI9341 in sleep mode, display off
+#define BATTERY_BACKLIGHT_UA 20000        // Backlight LEDs; drawn asleep too unless TFT_BACKLIGHT switches them off
+#define BATTERY_AWAKE_ESTIMATE_MS 8000    // Awake time per cycle assumed until one is measured
+
+// Unit Role (select with a build flag, e.g. -DUNIT_ROLE=UNIT_ROLE_DIRECTORY)
+#define UNIT_ROLE_FACULTY 0               // Door unit for one faculty member
+#define UNIT_ROLE_DIRECTORY 1             // Hallway board listing every faculty member's status
+#ifndef UNIT_ROLE
+#define UNIT_ROLE UNIT_ROLE_FACULTY
+#endif
+#if UNIT_ROLE == UNIT_ROLE_DIRECTORY && POWER_MODE == POWER_MODE_BATTERY
+#error "The directory board redraws continuously; build it with POWER_MODE_MAINS"
+#endif
+#define DIRECTORY_STATUS_TOPIC "consultease/faculty/+/status"
+#define DIRECTORY_MAX_ENTRIES 100         // Faculty members tracked by the board
+#define DIRECTORY_ID_LEN 24               // Faculty ID (topic level) including terminator
+#define DIRECTORY_NAME_LEN 24             // Display name including terminator
+#define DIRECTORY_ROW_HEIGHT 20           // Pixels per faculty row
+#define DIRECTORY_HEADER_HEIGHT 24        // Title and page indicator
+#define DIRECTORY_REDRAW_HOLD_MS 100      // Status changes arriving within this window are drawn together
+#define DIRECTORY_PAGE_MS 8000            // Time each page is shown when there is more than one
+#define MQTT_DRAIN_MAX 32                 // Messages handled per loop pass when the socket has more queued
+#define DIRECTORY_MULTICAST 1             // 1 = also take status from LAN multicast datagrams
+
+// LAN Status Multicast (broker-free status datagrams for displays on the same subnet)
+#define STATUS_MULTICAST_ENABLED 1        // 1 = faculty units send a datagram on every status change
+#define STATUS_MULTICAST_GROUP "239.255.77.1" // Administratively scoped group
+#define STATUS_MULTICAST_PORT 47701
+#define STATUS_MULTICAST_TTL 1            // Stay on the local subnet
+#define STATUS_MULTICAST_HEARTBEAT_MS 15000 // Unchanged status is resent so late joiners and lost datagrams catch up
+#define STATUS_DATAGRAM_VERSION 1         // Byte 2 of every datagram
+#define STATUS_DATAGRAM_ID_LEN 32         // Max faculty ID length in a datagram (including terminator)
+#define STATUS_RECEIVER_MAX_SENDERS 100   // Units a receiver tracks sequence numbers for
+
+// Logging (ULOG call sites; levels: 0 debug, 1 info, 2 warn, 3 error)
+#define LOG_MIN_LEVEL 1                   // Lower levels compile to a constant-false branch
+#define LOG_SERIAL 1                      // 1 = also print logged records to Serial
+#define LOG_REMOTE_LEVEL 1                // Records at or above this are queued for MQTT
+#define LOG_SAMPLE_FIRST 5                // Every call site logs its first N calls...
+#define LOG_SAMPLE_EVERY 20               // ...then one in M (the skipped count rides on the next record)
+#define LOG_TEXT_LEN 96                   // Formatted message including terminator (longer is truncated)
+#define LOG_RING_RECORDS 48               // Unsent records kept across MQTT outages (~5 KB)
+#define LOG_FRAME_LEN 768                 // One published frame; stays under MQTT_BUFFER_SIZE with the topic
+#define LOG_FRAME_VERSION 1               // First field of every frame
+#define LOG_FLUSH_MS 5000                 // A partial batch is published after this long
+#define LOG_FLUSH_RECORDS 16              // ...or as soon as this many records are waiting
+#define LOG_RETRY_MS 2000                 // After the sink rejects a frame, wait this long before formatting another
+
+// Firebase RTDB Writes (see comms/rtdb_writer.h)
+#define FIREBASE_TEST_MODE 0              // 1 = no sign-in or auth token (open rules or the utils/rtdb_standin.py stand-in)
+#define FIREBASE_WRITE_SLOTS 4            // Queued writes; a newer value for a queued path replaces it
+#define FIREBASE_PATH_LEN 64              // Database path including terminator
+#define FIREBASE_VALUE_LEN 64             // JSON value including terminator
+#define FIREBASE_AUTH_LEN 1280            // ID token including terminator (Firebase tokens run ~1 KB)
+#define FIREBASE_PIPELINE_DEPTH 4         // Requests sent before their responses are read
+#define FIREBASE_KEEPALIVE_MS 45000       // Idle connection is pinged this often (servers and NATs drop it after ~60 s)
+#define FIREBASE_IO_TIMEOUT_MS 5000       // Connect, handshake and per-response timeout
+#define FIREBASE_WRITE_RETRIES 3          // Attempts per write before it counts as failed
+#define FIREBASE_RETRY_BACKOFF_MS 500     // First retry delay, doubled per failed batch...
+#define FIREBASE_RETRY_MAX_BACKOFF_MS 8000 // ...up to this
+#define FIREBASE_WRITER_STACK 8192        // Writer task stack (mbedTLS record I/O runs on it)
+// #define FIREBASE_ROOT_CA "-----BEGIN CERTIFICATE-----\n..." // Verify the server; unset = unverified, like the Firebase client
+
+// Debug HTTP Server (/metrics and /events WebSocket)
+#define DEBUG_HTTP_ENABLED 0              // 1 = serve /metrics (and /events, see below) on the LAN; 0 = USB serial only
+#define DEBUG_HTTP_EVENTS_TOKEN ""        // /events?token=<this> streams events; empty = no event stream
+#define DEBUG_HTTP_PORT 80
+#define DEBUG_HTTP_MAX_CLIENTS 4          // Open sockets (HTTP + WebSocket); the least recently used is closed when full
+#define DEBUG_HTTP_METRICS_LEN 4096       // Rendered /metrics text (three buffers of this size)
+#define DEBUG_HTTP_REFRESH_MS 2000        // How often the loop re-renders /metrics
+#define DEBUG_HTTP_SEND_TIMEOUT_S 2       // Clients slower than this are disconnected
+#define DEBUG_WS_FRAME_SLOTS 4            // Event frames in flight to WebSocket clients
+#define DEBUG_WS_FRAME_LEN 192            // One serialized event
+
+// Event Bus
+#define EVENT_POOL_SIZE 8                 // Preallocated event records shared by all publishers
+#define EVENT_MAX_SUBSCRIPTIONS 16        // Handler registrations across all event types
+
+// Coroutine Scheduler (C++20 stackless coroutines driven from loop())
+#define CORO_MAX_TASKS 8                  // Concurrent coroutine flows
+#define CORO_FRAME_POOL_SIZE 2048         // Static storage for coroutine frames
+#define CORO_SCHEDULER_BENCH 0            // Print ns per resume for sleep_for() and CoEvent wakes at boot (about 1 s)
+#define BUTTON_POLL_MS 20                 // Button sampling interval
+#define BUTTON_DEBOUNCE_MS 50             // Press must be stable this long to count
+
+// Timer Wheel (every firmware timeout; loop() sleeps until the next deadline)
+#define TIMER_TICK_MS 10                  // Wheel resolution
+#define TIMER_WHEEL_L0_SLOTS 256          // Level-0 slots (power of two): 2.56 s at 10 ms
+#define TIMER_WHEEL_L1_SLOTS 64           // Level-1 slots (power of two): ~11 min reach
+#define TIMER_MAX_SLEEP_MS 1000           // Upper bound on a single loop() sleep
+#define MQTT_POLL_MS 50                   // PubSubClient has no readiness callback, so it is polled
+
+// Display Assets (QOI images stored in LittleFS)
+#define ASSET_DIR "/assets"               // LittleFS directory holding <name>.qoi files
+#define ASSET_NAME_LEN 24                 // Max asset name length (including terminator)
+#define ASSET_MAX_BYTES 65536             // Largest accepted asset upload
+#define ASSET_PHOTO_NAME "photo"          // Faculty photo shown on the idle screen
+#define STATUS_ICON_SIZE 20               // Status icons are square, drawn at the right of the status bar
 
 // Display Configuration (2.4" SPI TFT ILI9341)
 #define SCREEN_WIDTH 240 // TFT display width, in pixels
@@ -35,10 +240,18 @@
 #define TFT_CS    5  // Chip Select pin (Example: GPIO5)
 #define TFT_DC    4  // Data/Command pin (Example: GPIO4)
 #define TFT_RST   2  // Reset pin (Example: GPIO2, use -1 if not connected)
+#define TFT_BACKLIGHT -1 // Backlight enable pin (active high), or -1 if the LED pin is tied to 3.3 V
 // Standard SPI pins (MOSI, MISO, SCK) are usually handled by the library/hardware SPI
 
+// Pixel Kernels
+#define PIXEL_KERNELS_SIMD 0              // 1 = ESP32-S3 PIE vector unit for fills and byte swaps (ignored on other chips).
+                                          // Unverified: run PIXEL_KERNELS_BENCH on an S3 before enabling
+#define PIXEL_KERNELS_BENCH 0             // Check each kernel against a reference and print cycles/pixel at boot
+
 // Other constants
 #define SERIAL_BAUD_RATE 115200
-#define MQTT_RECONNECT_DELAY 5000 // Delay in ms before attempting MQTT reconnect
+#define MQTT_RECONNECT_DELAY 5000 // Delay in ms before the first MQTT reconnect retry (doubles on each failure)
+#define MQTT_RECONNECT_MAX_DELAY 60000 // Upper bound for the MQTT reconnect backoff
+#define MQTT_CONNECTION_CHECK_MS 500 // Interval between MQTT connection checks while connected
 
 #endif // CONFIG_H
\ No newline at end of file
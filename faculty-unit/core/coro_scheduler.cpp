@@ -0,0 +1,195 @@
+#include "coro_scheduler.h"
+#include "unit_log.h" // Sampled Serial/MQTT logging
+
+struct CoSlot {
+    std::coroutine_handle<> handle; ///< Null when the slot is free.
+    bool ready;                     ///< Set by spawn() or by the sleep timer firing.
+    CoEvent* event;                 ///< Resume when this event is signaled.
+    WheelTimer timer;               ///< Sleep deadline, owned by TimerWheel while active.
+};
+
+static CoSlot slots[CORO_MAX_TASKS];
+static int8_t currentSlot = -1; // Slot being resumed, so awaitables can park it in O(1)
+static unsigned long resumes = 0;
+static unsigned long busyMicros = 0;
+
+// Static storage for coroutine frames
+static uint8_t framePool[CORO_FRAME_POOL_SIZE] __attribute__((aligned(8)));
+static size_t framePoolUsed = 0;
+
+void* CoTask::promise_type::operator new(size_t size) noexcept {
+    size_t start = (framePoolUsed + 7) & ~(size_t)7;
+    if (start + size > CORO_FRAME_POOL_SIZE) {
+        ULOG(ULOG_ERROR, "Coroutine frame pool exhausted, frame size %lu", (unsigned long)size);
+        return nullptr;
+    }
+    framePoolUsed = start + size;
+    return &framePool[start];
+}
+
+void CoEvent::Awaiter::await_suspend(std::coroutine_handle<>) {
+    CoScheduler::park_on(&event);
+}
+
+void SleepAwaiter::await_suspend(std::coroutine_handle<>) {
+    CoScheduler::park_for(ms);
+}
+
+static void on_sleep_expired(void* arg) {
+    ((CoSlot*)arg)->ready = true;
+}
+
+bool CoScheduler::spawn(CoTask task) {
+    if (!task.handle) {
+        return false; // Frame allocation failed
+    }
+    for (uint8_t i = 0; i < CORO_MAX_TASKS; i++) {
+        if (!slots[i].handle) {
+            slots[i].handle = task.handle;
+            slots[i].ready = true;
+            slots[i].event = nullptr;
+            return true;
+        }
+    }
+    ULOG(ULOG_ERROR, "CoScheduler: no free task slot.");
+    task.handle.destroy();
+    return false;
+}
+
+void CoScheduler::park_for(unsigned long ms) {
+    CoSlot& slot = slots[currentSlot];
+    slot.event = nullptr;
+    TimerWheel::schedule(slot.timer, ms, on_sleep_expired, &slot);
+}
+
+void CoScheduler::park_on(CoEvent* event) {
+    slots[currentSlot].event = event;
+}
+
+/**
+ * @brief Sleep deadlines are kept by TimerWheel, so this only checks flags;
+ *        call it after TimerWheel::advance().
+ */
+void CoScheduler::run_ready() {
+    unsigned long start_us = micros();
+
+    for (uint8_t i = 0; i < CORO_MAX_TASKS; i++) {
+        CoSlot& slot = slots[i];
+        if (!slot.handle) {
+            continue;
+        }
+        bool ready = slot.event != nullptr ? slot.event->consume() : slot.ready;
+        if (!ready) {
+            continue;
+        }
+
+        slot.event = nullptr;
+        slot.ready = false;
+        currentSlot = i;
+        slot.handle.resume();
+        currentSlot = -1;
+        resumes++;
+
+        if (slot.handle.done()) {
+            slot.handle.destroy();
+            slot.handle = nullptr;
+        }
+    }
+
+    busyMicros += micros() - start_us;
+}
+
+unsigned long CoScheduler::resume_count() {
+    return resumes;
+}
+
+unsigned long CoScheduler::busy_us() {
+    return busyMicros;
+}
+
+#if CORO_SCHEDULER_BENCH
+static const unsigned BENCH_ROUNDS = 100; // Sleeps of one tick each, so about 1 s in total
+
+static CoTask bench_sleeper(unsigned rounds) {
+    for (unsigned i = 0; i < rounds; i++) {
+        co_await sleep_for(1);
+    }
+}
+
+static CoTask bench_waiter(CoEvent& event, unsigned rounds) {
+    for (unsigned i = 0; i < rounds; i++) {
+        co_await event;
+    }
+}
+
+static bool any_task() {
+    for (const CoSlot& slot : slots) {
+        if (slot.handle) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void print_result(const __FlashStringHelper* name, uint32_t cycles, unsigned long count) {
+    Serial.print(F("  "));
+    Serial.print(name);
+    Serial.print(F(": "));
+    Serial.print(count > 0 ? cycles * 1000.0f / ESP.getCpuFreqMHz() / count : 0.0f, 0);
+    Serial.print(F(" ns per resume ("));
+    Serial.print(count);
+    Serial.println(F(" resumes)"));
+}
+
+/**
+ * @brief Only passes that resumed something are timed, so the tick waits between
+ *        sleeps do not count. The timer wheel's expiry is part of a sleep resume and
+ *        signal() (with its wake()) part of an event resume.
+ */
+void CoScheduler::report_benchmark() {
+    size_t poolMark = framePoolUsed;
+    Serial.print(F("Coroutine scheduler ("));
+    Serial.print(CORO_MAX_TASKS);
+    Serial.println(F(" tasks):"));
+
+    for (uint8_t i = 0; i < CORO_MAX_TASKS; i++) {
+        spawn(bench_sleeper(BENCH_ROUNDS));
+    }
+    run_ready(); // First run to the first sleep is not a wake
+    uint32_t cycles = 0;
+    unsigned long counted = 0;
+    while (any_task()) {
+        unsigned long before = resumes;
+        uint32_t start = ESP.getCycleCount();
+        TimerWheel::advance();
+        run_ready();
+        uint32_t elapsed = ESP.getCycleCount() - start;
+        if (resumes != before) {
+            cycles += elapsed;
+            counted += resumes - before;
+        }
+    }
+    print_result(F("sleep_for"), cycles, counted);
+
+    static CoEvent events[CORO_MAX_TASKS];
+    for (uint8_t i = 0; i < CORO_MAX_TASKS; i++) {
+        spawn(bench_waiter(events[i], BENCH_ROUNDS * 10));
+    }
+    run_ready();
+    cycles = 0;
+    counted = 0;
+    while (any_task()) {
+        unsigned long before = resumes;
+        uint32_t start = ESP.getCycleCount();
+        for (CoEvent& event : events) {
+            event.signal();
+        }
+        run_ready();
+        cycles += ESP.getCycleCount() - start;
+        counted += resumes - before;
+    }
+    print_result(F("CoEvent"), cycles, counted);
+
+    framePoolUsed = poolMark; // Every benchmark frame is destroyed; nothing else was allocated
+}
+#endif
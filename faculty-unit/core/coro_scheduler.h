@@ -0,0 +1,127 @@
+#ifndef CORO_SCHEDULER_H
+#define CORO_SCHEDULER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <coroutine> // Requires C++20 (arduino-esp32 3.x builds with gnu++2b)
+#include "../config/config.h"
+#include "timer_wheel.h"
+
+/**
+ * @brief Handle to a stackless C++20 coroutine run by CoScheduler.
+ *        Frames come from a static pool (CORO_FRAME_POOL_SIZE) rather than the heap,
+ *        and flows are expected to be started once during setup() and run forever.
+ */
+class CoTask {
+public:
+    struct promise_type {
+        CoTask get_return_object() {
+            return CoTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        static CoTask get_return_object_on_allocation_failure() { return CoTask(nullptr); }
+        std::suspend_always initial_suspend() noexcept { return {}; } // Started by CoScheduler::spawn()
+        std::suspend_always final_suspend() noexcept { return {}; }   // Destroyed by the scheduler
+        void return_void() {}
+        void unhandled_exception() { abort(); }
+
+        static void* operator new(size_t size) noexcept;
+        static void operator delete(void*, size_t) noexcept {} // Pool memory is never reused
+    };
+
+    explicit CoTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * @brief Auto-reset event a coroutine can `co_await`.
+ *        signal() may be called from any task or callback; the waiting coroutine is
+ *        resumed by the scheduler on the loop task. A signal with no waiter is remembered.
+ */
+class CoEvent {
+public:
+    CoEvent() : signaled(false) {}
+
+    void signal() {
+        signaled.store(true);
+        TimerWheel::wake();
+    }
+
+    /**
+     * @brief Clears the event.
+     * @return true if it was signaled.
+     */
+    bool consume() { return signaled.exchange(false); }
+
+    struct Awaiter {
+        CoEvent& event;
+        bool await_ready() { return event.consume(); }
+        void await_suspend(std::coroutine_handle<> h);
+        void await_resume() noexcept {}
+    };
+
+    Awaiter operator co_await() { return Awaiter{*this}; }
+
+private:
+    std::atomic<bool> signaled;
+};
+
+/**
+ * @brief Awaitable returned by sleep_for().
+ */
+struct SleepAwaiter {
+    unsigned long ms;
+    bool await_ready() const noexcept { return ms == 0; }
+    void await_suspend(std::coroutine_handle<> h);
+    void await_resume() noexcept {}
+};
+
+/**
+ * @brief Suspends the calling coroutine for at least `ms` milliseconds.
+ *        Usage: `co_await sleep_for(50);`
+ */
+inline SleepAwaiter sleep_for(unsigned long ms) {
+    return SleepAwaiter{ms};
+}
+
+/**
+ * @brief Static cooperative scheduler for CoTask flows.
+ *        Call run_ready() from loop() after TimerWheel::advance(); it resumes every
+ *        coroutine whose sleep timer has fired or whose event has been signaled. Coroutines only yield at co_await,
+ *        so they must not block.
+ */
+class CoScheduler {
+public:
+    /**
+     * @brief Registers a coroutine; it first runs on the next run_ready().
+     * @return false if the task could not be created or CORO_MAX_TASKS is reached.
+     */
+    static bool spawn(CoTask task);
+
+    /**
+     * @brief Resumes all ready coroutines once.
+     */
+    static void run_ready();
+
+    /**
+     * @brief Total coroutine resumes, and cumulative time spent in run_ready()
+     *        (scheduling plus coroutine bodies), for overhead measurement.
+     */
+    static unsigned long resume_count();
+    static unsigned long busy_us();
+
+#if CORO_SCHEDULER_BENCH
+    /**
+     * @brief Runs CORO_MAX_TASKS sleeping and event-waiting coroutines and prints the
+     *        cost per resume to Serial. Call after TimerWheel::init() and before any
+     *        flow is spawned: the benchmark's frames are handed back to the pool.
+     */
+    static void report_benchmark();
+#endif
+
+    // Used by the awaitables to park the coroutine currently being resumed
+    static void park_for(unsigned long ms);
+    static void park_on(CoEvent* event);
+};
+
+#endif // CORO_SCHEDULER_H
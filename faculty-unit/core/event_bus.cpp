@@ -0,0 +1,157 @@
+#include "event_bus.h"
+#include "timer_wheel.h"
+
+struct Subscription {
+    EventType type;
+    EventTask task;
+    EVENT_HANDLER_SIGNATURE handler;
+};
+
+// Preallocated records and the stack of free ones
+static Event eventPool[EVENT_POOL_SIZE];
+static Event* freeEvents[EVENT_POOL_SIZE];
+static uint8_t freeCount = 0;
+
+static Subscription subscriptions[EVENT_MAX_SUBSCRIPTIONS];
+static uint8_t subscriptionCount = 0;
+
+// Bit i set = some subscription for this event type runs on task i
+static uint8_t taskMask[EVENT_TYPE_COUNT];
+
+static QueueHandle_t taskQueues[EVENT_TASK_COUNT];
+static EventStats eventStats[EVENT_TYPE_COUNT];
+
+// Guards the free stack, reference counts and stats across tasks
+static portMUX_TYPE busMux = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Fills the free stack and creates one queue per task, each deep enough
+ *        to hold every record in the pool.
+ */
+void EventBus::setup_bus() {
+    for (uint8_t i = 0; i < EVENT_POOL_SIZE; i++) {
+        freeEvents[i] = &eventPool[i];
+    }
+    freeCount = EVENT_POOL_SIZE;
+
+    for (uint8_t t = 0; t < EVENT_TASK_COUNT; t++) {
+        taskQueues[t] = xQueueCreate(EVENT_POOL_SIZE, sizeof(Event*));
+    }
+    Serial.println(F("Event bus initialized."));
+}
+
+bool EventBus::subscribe(EventType type, EventTask task, EVENT_HANDLER_SIGNATURE handler) {
+    if (subscriptionCount >= EVENT_MAX_SUBSCRIPTIONS) {
+        Serial.println(F("Event bus: too many subscriptions."));
+        return false;
+    }
+    subscriptions[subscriptionCount++] = {type, task, handler};
+    taskMask[type] |= (1u << task);
+    return true;
+}
+
+Event* EventBus::acquire(EventType type) {
+    Event* event = nullptr;
+    portENTER_CRITICAL(&busMux);
+    if (freeCount > 0) {
+        event = freeEvents[--freeCount];
+    } else {
+        eventStats[type].dropped++;
+    }
+    portEXIT_CRITICAL(&busMux);
+
+    if (event != nullptr) {
+        event->type = type;
+        event->refs = 0;
+    }
+    return event;
+}
+
+void EventBus::release(Event* event) {
+    portENTER_CRITICAL(&busMux);
+    freeEvents[freeCount++] = event;
+    portEXIT_CRITICAL(&busMux);
+}
+
+/**
+ * @brief Reference count is set before any queue send so a fast consumer on another
+ *        task cannot release the record while it is still being queued.
+ */
+void EventBus::publish(Event* event) {
+    if (event == nullptr) {
+        return;
+    }
+    uint8_t mask = taskMask[event->type];
+    uint8_t targets = 0;
+    for (uint8_t t = 0; t < EVENT_TASK_COUNT; t++) {
+        if (mask & (1u << t)) {
+            targets++;
+        }
+    }
+    if (targets == 0) {
+        release(event);
+        return;
+    }
+
+    event->refs = targets;
+    event->published_us = micros();
+
+    bool delivered = false;
+    uint8_t failed = 0;
+    for (uint8_t t = 0; t < EVENT_TASK_COUNT; t++) {
+        if (!(mask & (1u << t))) {
+            continue;
+        }
+        if (xQueueSend(taskQueues[t], &event, 0) == pdTRUE) {
+            delivered = true;
+            if (t == EVENT_TASK_LOOP) {
+                TimerWheel::wake(); // Publisher on another task: don't wait out the loop's sleep
+            }
+        } else {
+            failed++;
+        }
+    }
+
+    portENTER_CRITICAL(&busMux);
+    if (delivered) {
+        eventStats[event->type].dispatched++;
+    }
+    eventStats[event->type].dropped += failed;
+    event->refs -= failed;
+    bool unreferenced = event->refs == 0;
+    portEXIT_CRITICAL(&busMux);
+
+    if (unreferenced) {
+        release(event);
+    }
+}
+
+void EventBus::dispatch(EventTask task) {
+    Event* event;
+    while (xQueueReceive(taskQueues[task], &event, 0) == pdTRUE) {
+        unsigned long latency = micros() - event->published_us;
+
+        for (uint8_t i = 0; i < subscriptionCount; i++) {
+            if (subscriptions[i].type == event->type && subscriptions[i].task == task) {
+                subscriptions[i].handler(*event);
+            }
+        }
+
+        portENTER_CRITICAL(&busMux);
+        EventStats& s = eventStats[event->type];
+        s.total_us += latency;
+        if (latency > s.max_us) {
+            s.max_us = latency;
+        }
+        bool unreferenced = --event->refs == 0;
+        portEXIT_CRITICAL(&busMux);
+
+        if (unreferenced) {
+            release(event);
+        }
+    }
+}
+
+const EventStats& EventBus::stats(EventType type) {
+    return eventStats[type];
+}
@@ -0,0 +1,110 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include "../config/config.h"
+#include "../comms/request_inbox.h" // InboxRequest payload
+
+/**
+ * @brief Event types carried by the bus. Add new types before EVENT_TYPE_COUNT.
+ */
+enum EventType : uint8_t {
+    EVENT_PRESENCE_CHANGED, ///< BLE presence changed (payload: presence).
+    EVENT_STATUS_CHANGED,   ///< Manual status changed by button or remote command (payload: status).
+    EVENT_REQUEST_SHOW,     ///< A queued request is due to be drawn (payload: request).
+    EVENT_TYPE_COUNT
+};
+
+/**
+ * @brief Tasks that drain the bus. A subscription names the task its handler runs on;
+ *        that task must call EventBus::dispatch() with its ID regularly.
+ */
+enum EventTask : uint8_t {
+    EVENT_TASK_LOOP, ///< Arduino loopTask (setup()/loop()).
+    EVENT_TASK_COUNT
+};
+
+struct PresenceEvent {
+    bool present;
+};
+
+struct StatusEvent {
+    char status[16]; ///< "available", "busy" or "away".
+};
+
+/**
+ * @brief Fixed-size event record. Records come from a preallocated pool and are
+ *        handed to subscribers by reference; they are never copied or heap-allocated.
+ */
+struct Event {
+    EventType type;
+    uint8_t refs;               ///< Task queues still holding this record.
+    unsigned long published_us; ///< micros() at publish, for dispatch latency.
+    union {
+        PresenceEvent presence;
+        StatusEvent status;
+        InboxRequest request;
+    };
+};
+
+typedef void (*EVENT_HANDLER_SIGNATURE)(const Event& event);
+
+/**
+ * @brief Dispatch latency (publish to handler start) for one event type.
+ */
+struct EventStats {
+    unsigned long dispatched; ///< Events delivered to at least one task.
+    unsigned long dropped;    ///< Events lost because a task queue was full.
+    unsigned long total_us;   ///< Sum of dispatch latencies.
+    unsigned long max_us;     ///< Worst dispatch latency.
+};
+
+/**
+ * @brief Static, typed in-process publish/subscribe bus.
+ *        Publishers acquire a record, fill it in place and publish it; each task with a
+ *        matching subscription receives a pointer through its FreeRTOS queue. The
+ *        record returns to the pool after the last task has run its handlers.
+ */
+class EventBus {
+public:
+    /**
+     * @brief Creates the per-task queues. Call once from setup() before subscribing.
+     */
+    static void setup_bus();
+
+    /**
+     * @brief Registers a handler. Subscriptions are made during setup and never removed.
+     * @return false if EVENT_MAX_SUBSCRIPTIONS is exceeded.
+     */
+    static bool subscribe(EventType type, EventTask task, EVENT_HANDLER_SIGNATURE handler);
+
+    /**
+     * @brief Takes a free record from the pool.
+     * @return The record (type set, payload uninitialised), or nullptr if the pool is empty.
+     */
+    static Event* acquire(EventType type);
+
+    /**
+     * @brief Queues an acquired record to every task subscribed to its type.
+     *        Safe to call from any task. The caller must not touch the record afterwards.
+     */
+    static void publish(Event* event);
+
+    /**
+     * @brief Runs the handlers for all events queued for a task.
+     *        Must be called from that task.
+     */
+    static void dispatch(EventTask task);
+
+    /**
+     * @brief Dispatch counters for an event type.
+     */
+    static const EventStats& stats(EventType type);
+
+private:
+    static void release(Event* event);
+};
+
+#endif // EVENT_BUS_H
@@ -0,0 +1,88 @@
+#include "heap_guard.h"
+#include "timer_wheel.h"
+#include "unit_log.h" // Sampled Serial/MQTT logging
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#if HEAP_GUARD_MODE == HEAP_GUARD_ASSERT && !defined(CONFIG_HEAP_USE_HOOKS)
+#error "HEAP_GUARD_ASSERT needs an SDK built with CONFIG_HEAP_USE_HOOKS; without it nothing would ever abort"
+#endif
+
+static volatile bool steadyState = false;
+static volatile TaskHandle_t guardedTask = nullptr;
+static volatile unsigned long steadyAllocations = 0;
+static unsigned long reportedAllocations = 0;
+static size_t baselineAllocatedBytes = 0;
+static unsigned long maxGrowthBytes = 0;
+static WheelTimer reportTimer; // Active until the next report is due
+
+#if HEAP_GUARD_MODE != HEAP_GUARD_OFF && defined(CONFIG_HEAP_USE_HOOKS)
+/**
+ * @brief ESP-IDF heap hook, called for every successful allocation.
+ *        Kept in IRAM and free of locking so it is safe from any context.
+ */
+extern "C" void IRAM_ATTR esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps) {
+    (void)ptr;
+    (void)size;
+    (void)caps;
+    if (!steadyState || xTaskGetCurrentTaskHandle() != guardedTask) {
+        return;
+    }
+    steadyAllocations = steadyAllocations + 1;
+#if HEAP_GUARD_MODE == HEAP_GUARD_ASSERT
+    abort(); // The backtrace identifies the allocating call site
+#endif
+}
+
+extern "C" void IRAM_ATTR esp_heap_trace_free_hook(void* ptr) {
+    (void)ptr;
+}
+#endif
+
+void HeapGuard::begin_steady_state() {
+#if HEAP_GUARD_MODE != HEAP_GUARD_OFF
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+    baselineAllocatedBytes = info.total_allocated_bytes;
+    guardedTask = xTaskGetCurrentTaskHandle();
+    steadyState = true;
+#ifndef CONFIG_HEAP_USE_HOOKS
+    Serial.println(F("Heap guard: CONFIG_HEAP_USE_HOOKS not set, tracking heap growth only."));
+#endif
+    Serial.print(F("Heap guard armed. Allocated at boot: "));
+    Serial.println((unsigned long)baselineAllocatedBytes);
+#endif
+}
+
+void HeapGuard::check() {
+#if HEAP_GUARD_MODE != HEAP_GUARD_OFF
+    if (!steadyState || reportTimer.active()) {
+        return;
+    }
+    TimerWheel::schedule(reportTimer, HEAP_GUARD_REPORT_MS, nullptr, nullptr);
+
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+    if (info.total_allocated_bytes > baselineAllocatedBytes) {
+        unsigned long growth = info.total_allocated_bytes - baselineAllocatedBytes;
+        if (growth > maxGrowthBytes) {
+            maxGrowthBytes = growth;
+        }
+    }
+
+    unsigned long allocations = steadyAllocations;
+    if (allocations != reportedAllocations) {
+        ULOG(ULOG_WARN, "Heap guard: steady-state allocations on loop task: %lu", allocations);
+        reportedAllocations = allocations;
+    }
+#endif
+}
+
+unsigned long HeapGuard::steady_state_allocations() {
+    return steadyAllocations;
+}
+
+unsigned long HeapGuard::heap_growth_bytes() {
+    return maxGrowthBytes;
+}
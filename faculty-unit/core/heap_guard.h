@@ -0,0 +1,47 @@
+#ifndef HEAP_GUARD_H
+#define HEAP_GUARD_H
+
+#include <Arduino.h>
+#include "../config/config.h"
+
+/**
+ * @brief Detects heap allocations made by the loop task after setup() has finished.
+ *
+ * With HEAP_GUARD_MODE != HEAP_GUARD_OFF, every allocation made on the loop task after
+ * begin_steady_state() is counted through ESP-IDF's heap hooks (requires
+ * CONFIG_HEAP_USE_HOOKS). With HEAP_GUARD_ASSERT the first such allocation aborts with
+ * a backtrace, which points at the offending call site. Allocations made by the Wi-Fi,
+ * BLE and lwIP tasks are not counted; they are sized by the SDK, not by this firmware.
+ *
+ * The prebuilt Arduino-ESP32 SDK does not set CONFIG_HEAP_USE_HOOKS, so there the hook
+ * below is never called: HEAP_GUARD_COUNT only tracks growth of the total allocated heap
+ * since steady state began (leaks, not transient churn), and HEAP_GUARD_ASSERT does not
+ * build. Counting individual allocations needs an SDK rebuilt with the option (ESP-IDF
+ * with Arduino as a component, or esp32-arduino-lib-builder). tools/heap_soak_test.cpp
+ * counts them on the host instead.
+ */
+class HeapGuard {
+public:
+    /**
+     * @brief Marks the end of initialisation. Call as the last statement of setup().
+     */
+    static void begin_steady_state();
+
+    /**
+     * @brief Logs new steady-state allocations at most every HEAP_GUARD_REPORT_MS.
+     *        Call from loop().
+     */
+    static void check();
+
+    /**
+     * @brief Loop-task allocations since steady state began (0 without heap hooks).
+     */
+    static unsigned long steady_state_allocations();
+
+    /**
+     * @brief Largest growth in allocated heap bytes since steady state began.
+     */
+    static unsigned long heap_growth_bytes();
+};
+
+#endif // HEAP_GUARD_H
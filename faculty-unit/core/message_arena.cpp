@@ -0,0 +1,38 @@
+#include "message_arena.h"
+#include "unit_log.h" // Sampled Serial/MQTT logging
+
+static uint8_t arenaBuffer[MESSAGE_ARENA_SIZE] __attribute__((aligned(8)));
+
+size_t MessageArena::offset = 0;
+size_t MessageArena::high_water = 0;
+unsigned long MessageArena::overflows = 0;
+
+MessageArena::Scope::Scope() : mark(MessageArena::offset) {
+}
+
+MessageArena::Scope::~Scope() {
+    MessageArena::offset = mark;
+}
+
+void* MessageArena::allocate(size_t size) {
+    size_t start = (offset + 7) & ~(size_t)7; // 8-byte alignment
+    if (start + size > MESSAGE_ARENA_SIZE) {
+        overflows++;
+        ULOG(ULOG_WARN, "Message arena overflow, requested %lu", (unsigned long)size);
+        return nullptr;
+    }
+    offset = start + size;
+    if (offset > high_water) {
+        high_water = offset;
+    }
+    return &arenaBuffer[start];
+}
+
+char* MessageArena::copy_string(const byte* data, size_t length) {
+    char* copy = (char*)allocate(length + 1);
+    if (copy != nullptr) {
+        memcpy(copy, data, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
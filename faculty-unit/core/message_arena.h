@@ -0,0 +1,63 @@
+#ifndef MESSAGE_ARENA_H
+#define MESSAGE_ARENA_H
+
+#include <Arduino.h>
+#include "../config/config.h"
+
+/**
+ * @brief Static bump-pointer arena for inbound message processing.
+ *
+ * Everything a message needs while it is handled (payload copies, JSON documents,
+ * decoded text) is carved out of one MESSAGE_ARENA_SIZE buffer, and the arena is
+ * rewound when the message is done. Allocation is O(1), nothing is freed
+ * individually and the heap is never touched. Only used from the loop task
+ * (PubSubClient callbacks run inside client.loop()).
+ */
+class MessageArena {
+public:
+    /**
+     * @brief Rewinds the arena to where it was on construction.
+     *        Scopes nest, so a callback invoked from another callback only releases its own allocations;
+     *        the outermost scope resets the arena for the next message.
+     */
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+    private:
+        size_t mark;
+    };
+
+    /**
+     * @brief Allocates `size` bytes aligned for any scalar type.
+     * @return The block, or nullptr on overflow (counted in overflow_count()).
+     */
+    static void* allocate(size_t size);
+
+    /**
+     * @brief Allocates and null-terminates a copy of `length` bytes.
+     * @return The copy, or nullptr on overflow.
+     */
+    static char* copy_string(const byte* data, size_t length);
+
+    static size_t used() { return offset; }
+    static size_t high_water_mark() { return high_water; }
+    static unsigned long overflow_count() { return overflows; }
+
+private:
+    static size_t offset;
+    static size_t high_water;
+    static unsigned long overflows;
+};
+
+/**
+ * @brief ArduinoJson allocator that takes the document's memory pool from the message arena.
+ *        Use as BasicJsonDocument<MessageArenaAllocator> inside a MessageArena::Scope.
+ */
+struct MessageArenaAllocator {
+    void* allocate(size_t size) { return MessageArena::allocate(size); }
+    void deallocate(void*) {} // Released when the enclosing scope ends
+    void* reallocate(void* ptr, size_t) { return ptr; } // Only used to shrink; keep the block
+};
+
+#endif // MESSAGE_ARENA_H
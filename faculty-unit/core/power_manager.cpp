@@ -0,0 +1,146 @@
+#include "power_manager.h"
+#include <esp_sleep.h>
+#include <driver/rtc_io.h>
+#include <soc/rtc_cntl_reg.h>
+#include <soc/rtc_io_reg.h>
+#include <soc/soc_ulp.h>
+#include <esp32/ulp.h>
+
+// ULP program at word 0; the pressed-button snapshot is stored at this word offset,
+// inside the CONFIG_ULP_COPROC_RESERVE_MEM region
+#define ULP_BUTTON_DATA_WORD 120
+
+static int buttonPins[BATTERY_MAX_BUTTONS];
+static uint8_t buttonCount = 0;
+static int wokenBy = -1;
+
+// Average awake time per cycle (RTC_DATA_ATTR: kept across deep sleep, reset on power-on)
+RTC_DATA_ATTR static unsigned long avgAwakeMs = 0;
+
+void PowerManager::begin(const int* button_pins, uint8_t count) {
+    buttonCount = count < BATTERY_MAX_BUTTONS ? count : BATTERY_MAX_BUTTONS;
+    for (uint8_t i = 0; i < buttonCount; i++) {
+        buttonPins[i] = button_pins[i];
+    }
+
+    wokenBy = -1;
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_ULP) {
+        // Input levels sampled by the ULP when it saw the press (bit n = RTC GPIO n)
+        uint32_t levels = RTC_SLOW_MEM[ULP_BUTTON_DATA_WORD] & 0xFFFF;
+        for (uint8_t i = 0; i < buttonCount; i++) {
+            int rtc_io = rtc_io_number_get((gpio_num_t)buttonPins[i]);
+            if (rtc_io >= 0 && !(levels & (1u << rtc_io))) {
+                wokenBy = buttonPins[i];
+                break;
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < buttonCount; i++) {
+        rtc_gpio_hold_dis((gpio_num_t)buttonPins[i]);
+        rtc_gpio_deinit((gpio_num_t)buttonPins[i]);
+    }
+}
+
+int PowerManager::wake_button() {
+    return wokenBy;
+}
+
+/**
+ * @brief ULP loop, run every BUTTON_POLL_MS by the ULP timer: read the RTC GPIO input
+ *        register, and if any watched (active-low) button reads low, save the levels
+ *        and wake the main CPU.
+ */
+static void load_button_monitor() {
+    uint16_t mask = 0;
+    for (uint8_t i = 0; i < buttonCount; i++) {
+        gpio_num_t pin = (gpio_num_t)buttonPins[i];
+        int rtc_io = rtc_io_number_get(pin);
+        if (rtc_io < 0 || rtc_io > 15) {
+            Serial.print(F("PowerManager: button GPIO is not RTC-capable: "));
+            Serial.println(buttonPins[i]);
+            continue;
+        }
+        mask |= 1u << rtc_io;
+        rtc_gpio_init(pin);
+        rtc_gpio_set_direction(pin, RTC_GPIO_MODE_INPUT_ONLY);
+        rtc_gpio_pulldown_dis(pin);
+        rtc_gpio_pullup_en(pin);
+        rtc_gpio_hold_en(pin);
+    }
+
+    enum { LABEL_RELEASED };
+    const ulp_insn_t program[] = {
+        I_RD_REG(RTC_GPIO_IN_REG, RTC_GPIO_IN_NEXT_S, RTC_GPIO_IN_NEXT_S + 15),
+        I_ANDI(R1, R0, mask),
+        I_SUBI(R1, R1, mask),                 // Zero when every watched button is high
+        M_BXZ(LABEL_RELEASED),
+        I_MOVI(R2, ULP_BUTTON_DATA_WORD),
+        I_ST(R0, R2, 0),
+        I_WAKE(),
+        I_END(),                              // Stop the ULP timer; setup() reloads it
+        I_HALT(),
+        M_LABEL(LABEL_RELEASED),
+        I_HALT(),
+    };
+    size_t size = sizeof(program) / sizeof(ulp_insn_t);
+    ulp_process_macros_and_load(0, program, &size);
+    ulp_set_wakeup_period(0, BUTTON_POLL_MS * 1000UL);
+    ulp_run(0);
+}
+
+void PowerManager::deep_sleep(unsigned long sleep_ms) {
+    unsigned long awake = millis();
+    avgAwakeMs = avgAwakeMs == 0 ? awake : (avgAwakeMs * 7 + awake) / 8;
+    Serial.print(F("Cycle awake "));
+    Serial.print(awake);
+    Serial.print(F(" ms, sleeping "));
+    Serial.print(sleep_ms);
+    Serial.println(F(" ms."));
+    Serial.flush();
+
+    if (buttonCount > 0) {
+        load_button_monitor();
+        esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_ON); // Keep the pull-ups
+        esp_sleep_enable_ulp_wakeup();
+    }
+    esp_sleep_enable_timer_wakeup((uint64_t)sleep_ms * 1000ULL);
+    esp_deep_sleep_start();
+}
+
+// Current while the ESP32 deep-sleeps, display included (see DisplayManager::sleep_panel())
+#if BATTERY_DISPLAY_ASLEEP
+#define SLEEP_PANEL_UA BATTERY_PANEL_IDLE_UA
+#else
+#define SLEEP_PANEL_UA BATTERY_PANEL_SLEEP_UA
+#endif
+#define SLEEP_BACKLIGHT_UA (BATTERY_DISPLAY_ASLEEP || TFT_BACKLIGHT < 0 ? BATTERY_BACKLIGHT_UA : 0)
+#define SLEEP_TOTAL_UA (BATTERY_SLEEP_UA + SLEEP_PANEL_UA + SLEEP_BACKLIGHT_UA)
+
+/**
+ * @brief Average current over one cycle: awake at BATTERY_ACTIVE_MA, asleep at
+ *        SLEEP_TOTAL_UA (ESP32, panel and backlight), derated by BATTERY_USABLE_PERCENT
+ *        for self-discharge and cutoff voltage.
+ */
+float PowerManager::battery_life_hours(unsigned long wake_interval_ms, unsigned long awake_ms) {
+    float cycle_ms = (float)wake_interval_ms + awake_ms;
+    float avg_ma = (awake_ms * BATTERY_ACTIVE_MA + wake_interval_ms * (SLEEP_TOTAL_UA / 1000.0f)) / cycle_ms;
+    return (BATTERY_CAPACITY_MAH * BATTERY_USABLE_PERCENT / 100.0f) / avg_ma;
+}
+
+void PowerManager::report_energy_budget() {
+    static const unsigned long intervals_ms[] = {30000, 60000, 300000, 900000};
+    unsigned long awake = avgAwakeMs != 0 ? avgAwakeMs : BATTERY_AWAKE_ESTIMATE_MS;
+
+    Serial.print(F("Energy budget (awake "));
+    Serial.print(awake);
+    Serial.print(F(" ms per cycle, asleep "));
+    Serial.printf("%u uA = ESP32 %u + panel %u + backlight %u", (unsigned)SLEEP_TOTAL_UA, (unsigned)BATTERY_SLEEP_UA,
+                  (unsigned)SLEEP_PANEL_UA, (unsigned)SLEEP_BACKLIGHT_UA);
+    Serial.println(F("):"));
+    for (uint8_t i = 0; i < sizeof(intervals_ms) / sizeof(intervals_ms[0]); i++) {
+        float hours = battery_life_hours(intervals_ms[i], awake);
+        Serial.printf("  wake every %4lu s: %6.0f h (%.1f days)%s\n", intervals_ms[i] / 1000, hours, hours / 24,
+                      intervals_ms[i] == BATTERY_WAKE_INTERVAL_MS ? "  <- configured" : "");
+    }
+}
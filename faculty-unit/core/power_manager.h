@@ -0,0 +1,51 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+#include "../config/config.h"
+
+/**
+ * @brief Deep-sleep duty cycling for the battery build (POWER_MODE_BATTERY).
+ *
+ * Each wake runs one cycle (connect, scan, publish, receive queued requests) and then
+ * sleeps for BATTERY_WAKE_INTERVAL_MS. While asleep, the ULP coprocessor samples the
+ * buttons every BUTTON_POLL_MS and wakes the main CPU when one is pressed. Buttons must
+ * be RTC-capable GPIOs wired active-low. Persistent state lives in WarmRestart's RTC record.
+ */
+class PowerManager {
+public:
+    /**
+     * @brief Records why the chip woke and releases the button pins from RTC control.
+     *        Call at the start of setup(), before the buttons are configured.
+     * @param button_pins GPIOs watched by the ULP while asleep.
+     * @param count Number of pins (at most BATTERY_MAX_BUTTONS).
+     */
+    static void begin(const int* button_pins, uint8_t count);
+
+    /**
+     * @brief The button that woke the chip from deep sleep.
+     * @return Its GPIO, or -1 if the wake was not caused by a button.
+     */
+    static int wake_button();
+
+    /**
+     * @brief Loads the ULP button monitor, arms the timer and ULP wake sources and
+     *        enters deep sleep. Does not return. Records this cycle's awake time first.
+     */
+    static void deep_sleep(unsigned long sleep_ms);
+
+    /**
+     * @brief Energy-budget model: expected battery life for a wake interval, given an
+     *        awake time per cycle and the currents in config.h.
+     * @return Hours on a BATTERY_CAPACITY_MAH battery.
+     */
+    static float battery_life_hours(unsigned long wake_interval_ms, unsigned long awake_ms);
+
+    /**
+     * @brief Prints the model for a range of wake intervals, using the measured
+     *        average awake time (or BATTERY_AWAKE_ESTIMATE_MS before the first cycle).
+     */
+    static void report_energy_budget();
+};
+
+#endif // POWER_MANAGER_H
@@ -0,0 +1,169 @@
+#include "timer_wheel.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define L0_MASK (TIMER_WHEEL_L0_SLOTS - 1)
+#define L1_MASK (TIMER_WHEEL_L1_SLOTS - 1)
+
+// Slot list heads (circular, doubly linked sentinels)
+static WheelTimer level0[TIMER_WHEEL_L0_SLOTS];
+static WheelTimer level1[TIMER_WHEEL_L1_SLOTS];
+
+static uint32_t nowTick = 0;          // Tick containing lastAdvanceMs
+static uint32_t currentTick = 0;      // Next tick whose slot has not been run
+static unsigned long lastAdvanceMs = 0;
+static TaskHandle_t loopTask = nullptr;
+
+static void list_init(WheelTimer& head) {
+    head.next = &head;
+    head.prev = &head;
+}
+
+static bool list_empty(const WheelTimer& head) {
+    return head.next == &head;
+}
+
+static void list_link(WheelTimer& head, WheelTimer& timer) {
+    timer.next = head.next;
+    timer.prev = &head;
+    head.next->prev = &timer;
+    head.next = &timer;
+}
+
+static void list_unlink(WheelTimer& timer) {
+    timer.prev->next = timer.next;
+    timer.next->prev = timer.prev;
+    timer.next = nullptr;
+    timer.prev = nullptr;
+}
+
+/**
+ * @brief Puts a timer in the slot matching its distance from currentTick.
+ */
+static void file_timer(WheelTimer& timer) {
+    if ((int32_t)(timer.expiry_tick - currentTick) < 0) {
+        timer.expiry_tick = currentTick; // Already due: run on the next tick
+    }
+    uint32_t delta = timer.expiry_tick - currentTick;
+
+    if (delta < TIMER_WHEEL_L0_SLOTS) {
+        list_link(level0[timer.expiry_tick & L0_MASK], timer);
+    } else if (delta < (uint32_t)TIMER_WHEEL_L0_SLOTS * TIMER_WHEEL_L1_SLOTS) {
+        list_link(level1[(timer.expiry_tick / TIMER_WHEEL_L0_SLOTS) & L1_MASK], timer);
+    } else {
+        // Beyond the wheel: park in the farthest slot, re-filed when it cascades
+        list_link(level1[(currentTick / TIMER_WHEEL_L0_SLOTS + L1_MASK) & L1_MASK], timer);
+    }
+}
+
+/**
+ * @brief Moves the level-1 slot for the revolution starting at currentTick down to level 0.
+ */
+static void cascade() {
+    WheelTimer& head = level1[(currentTick / TIMER_WHEEL_L0_SLOTS) & L1_MASK];
+    while (!list_empty(head)) {
+        WheelTimer* timer = head.next;
+        list_unlink(*timer);
+        file_timer(*timer);
+    }
+}
+
+void TimerWheel::init() {
+    for (uint16_t i = 0; i < TIMER_WHEEL_L0_SLOTS; i++) {
+        list_init(level0[i]);
+    }
+    for (uint16_t i = 0; i < TIMER_WHEEL_L1_SLOTS; i++) {
+        list_init(level1[i]);
+    }
+    nowTick = 0;
+    currentTick = 0;
+    lastAdvanceMs = millis();
+    loopTask = xTaskGetCurrentTaskHandle();
+}
+
+void TimerWheel::schedule(WheelTimer& timer, unsigned long delay_ms, TIMER_CALLBACK_SIGNATURE callback, void* arg) {
+    if (timer.active()) {
+        list_unlink(timer);
+    }
+    timer.callback = callback;
+    timer.arg = arg;
+    // Measured from lastAdvanceMs (the start of nowTick) and rounded up so it never fires early
+    unsigned long since_advance = millis() - lastAdvanceMs;
+    timer.expiry_tick = nowTick + (since_advance + delay_ms + TIMER_TICK_MS - 1) / TIMER_TICK_MS;
+    file_timer(timer);
+}
+
+void TimerWheel::cancel(WheelTimer& timer) {
+    if (timer.active()) {
+        list_unlink(timer);
+    }
+}
+
+/**
+ * @brief Runs every tick up to now. Each slot is detached before its callbacks run,
+ *        so callbacks may reschedule or cancel any timer, including their own.
+ */
+void TimerWheel::advance() {
+    unsigned long now = millis();
+    uint32_t ticks = (now - lastAdvanceMs) / TIMER_TICK_MS;
+    lastAdvanceMs += ticks * TIMER_TICK_MS;
+    nowTick += ticks;
+
+    while ((int32_t)(nowTick - currentTick) >= 0) {
+        if ((currentTick & L0_MASK) == 0) {
+            cascade();
+        }
+
+        WheelTimer expired;
+        list_init(expired);
+        WheelTimer& head = level0[currentTick & L0_MASK];
+        while (!list_empty(head)) {
+            WheelTimer* timer = head.next;
+            list_unlink(*timer);
+            list_link(expired, *timer);
+        }
+        currentTick++;
+
+        while (!list_empty(expired)) {
+            WheelTimer* timer = expired.next;
+            list_unlink(*timer);
+            if (timer->callback != nullptr) {
+                timer->callback(timer->arg);
+            }
+        }
+    }
+}
+
+unsigned long TimerWheel::ms_until_next() {
+    // The next level-0 revolution needs a cascade even if no level-0 slot is occupied
+    uint32_t deadline = (currentTick | L0_MASK) + 1;
+    if ((currentTick & L0_MASK) == 0 &&
+        !list_empty(level1[(currentTick / TIMER_WHEEL_L0_SLOTS) & L1_MASK])) {
+        deadline = currentTick; // This revolution's cascade has not run yet
+    }
+    for (uint32_t t = currentTick; t != deadline; t++) {
+        if (!list_empty(level0[t & L0_MASK])) {
+            deadline = t;
+            break;
+        }
+    }
+
+    long ms = (long)(int32_t)(deadline - nowTick) * TIMER_TICK_MS - (long)(millis() - lastAdvanceMs);
+    if (ms <= 0) {
+        return 0;
+    }
+    return ms > TIMER_MAX_SLEEP_MS ? TIMER_MAX_SLEEP_MS : (unsigned long)ms;
+}
+
+void TimerWheel::sleep_until_next_deadline() {
+    unsigned long ms = ms_until_next();
+    if (ms > 0) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms));
+    }
+}
+
+void TimerWheel::wake() {
+    if (loopTask != nullptr && xTaskGetCurrentTaskHandle() != loopTask) {
+        xTaskNotifyGive(loopTask);
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <Arduino.h>
+#include "../config/config.h"
+
+typedef void (*TIMER_CALLBACK_SIGNATURE)(void* arg);
+
+/**
+ * @brief Intrusive timer node. Owned by the caller (usually a static or member),
+ *        so scheduling never allocates. A callback of nullptr just wakes the loop.
+ */
+struct WheelTimer {
+    WheelTimer* next;
+    WheelTimer* prev;
+    uint32_t expiry_tick;
+    TIMER_CALLBACK_SIGNATURE callback;
+    void* arg;
+
+    WheelTimer() : next(nullptr), prev(nullptr), expiry_tick(0), callback(nullptr), arg(nullptr) {}
+
+    bool active() const { return prev != nullptr; }
+};
+
+/**
+ * @brief Static two-level hierarchical timer wheel driving every firmware timeout.
+ *
+ * Level 0 has TIMER_WHEEL_L0_SLOTS slots of TIMER_TICK_MS; level 1 has
+ * TIMER_WHEEL_L1_SLOTS slots of one full level-0 revolution each. Timers further out
+ * are parked in the farthest level-1 slot and re-filed when it cascades. Insert and
+ * cancel are O(1) (doubly linked slot lists); expiry runs a whole slot per tick.
+ *
+ * The wheel belongs to the loop task: schedule, cancel and advance must only be called
+ * from there. wake() may be called from any task to cut a sleep short.
+ */
+class TimerWheel {
+public:
+    /**
+     * @brief Resets the wheel and records the loop task for wake-ups. Call from setup().
+     */
+    static void init();
+
+    /**
+     * @brief (Re)schedules a timer to fire `delay_ms` from now (rounded up to a tick).
+     */
+    static void schedule(WheelTimer& timer, unsigned long delay_ms, TIMER_CALLBACK_SIGNATURE callback, void* arg);
+
+    /**
+     * @brief Cancels a timer. Safe to call on an inactive timer.
+     */
+    static void cancel(WheelTimer& timer);
+
+    /**
+     * @brief Runs all callbacks whose deadline has passed. Call once per loop pass.
+     */
+    static void advance();
+
+    /**
+     * @brief Milliseconds until the next timer (or cascade) is due, at most TIMER_MAX_SLEEP_MS.
+     */
+    static unsigned long ms_until_next();
+
+    /**
+     * @brief Blocks the loop task until the next deadline or until wake() is called.
+     */
+    static void sleep_until_next_deadline();
+
+    /**
+     * @brief Ends the loop task's sleep early (e.g. an event was signaled from another task).
+     */
+    static void wake();
+};
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,205 @@
+#include "unit_log.h"
+#include "timer_wheel.h" // Batch flush interval
+#include <stdarg.h>
+#include <esp_random.h> // Boot ID
+#include <freertos/FreeRTOS.h>
+
+struct LogRecord {
+    uint32_t ms;
+    uint32_t site;
+    uint16_t suppressed;
+    uint8_t level;
+    char text[LOG_TEXT_LEN];
+};
+
+// Records are addressed by sequence number; seq lives in slot seq % LOG_RING_RECORDS
+static LogRecord ring[LOG_RING_RECORDS];
+static uint32_t nextSeq = 0;   // Sequence number of the next record written
+static uint32_t unsentSeq = 0; // Oldest record not yet published
+static portMUX_TYPE ringLock = portMUX_INITIALIZER_UNLOCKED;
+
+static char frameBuffer[LOG_FRAME_LEN];
+static uint32_t bootId = 0;
+
+static UnitLog::FrameSink sink = nullptr;
+static UnitLog::SinkReady sinkReady = nullptr;
+static unsigned long rejectedAtMs = 0; // Last frame the sink refused
+static bool backingOff = false;        // No frame before LOG_RETRY_MS after rejectedAtMs
+static WheelTimer flushTimer;         // Active while a partial batch waits for LOG_FLUSH_MS
+static volatile bool flushDue = false; // Set by flushTimer and by error records (any task)
+
+unsigned long UnitLog::written = 0;
+unsigned long UnitLog::sent = 0;
+unsigned long UnitLog::lost = 0;
+unsigned long UnitLog::frames = 0;
+
+static const char levelChars[] = {'D', 'I', 'W', 'E'};
+
+static void on_flush_timer(void*) {
+    flushDue = true;
+}
+
+void UnitLog::begin(FrameSink frame_sink, SinkReady ready) {
+    bootId = esp_random();
+    sink = frame_sink;
+    sinkReady = ready;
+}
+
+/**
+ * @brief Whether a frame is worth formatting: the sink reports ready and has not just
+ *        rejected one. Keeps an MQTT outage from costing a full frame every loop pass.
+ */
+static bool sink_accepting() {
+    if (backingOff && millis() - rejectedAtMs < LOG_RETRY_MS) {
+        return false;
+    }
+    backingOff = false;
+    return sinkReady == nullptr || sinkReady();
+}
+
+void UnitLog::write(LogSite& site, LogLevel level, const char* format, ...) {
+    LogRecord record;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(record.text, sizeof(record.text), format, args);
+    va_end(args);
+    for (char* c = record.text; *c != '\0'; c++) {
+        if (*c == '\n' || *c == '\r') {
+            *c = ' '; // One record per frame line
+        }
+    }
+    record.ms = millis();
+    record.site = site.id;
+    record.level = level;
+    record.suppressed = site.suppressed;
+    site.suppressed = 0;
+
+#if LOG_SERIAL
+    if (record.suppressed > 0) {
+        Serial.printf("%s (+%u suppressed)\n", record.text, (unsigned)record.suppressed);
+    } else {
+        Serial.println(record.text);
+    }
+#endif
+
+    if (level < LOG_REMOTE_LEVEL) {
+        return;
+    }
+    taskENTER_CRITICAL(&ringLock);
+    ring[nextSeq % LOG_RING_RECORDS] = record;
+    nextSeq++;
+    if (nextSeq - unsentSeq > LOG_RING_RECORDS) {
+        // Overwrote the oldest unsent record (sink down for longer than the ring lasts)
+        unsentSeq++;
+        lost++;
+    }
+    written++;
+    taskEXIT_CRITICAL(&ringLock);
+
+    if (level >= ULOG_ERROR) {
+        flushDue = true; // Errors go out on the next loop pass
+    }
+}
+
+uint16_t UnitLog::unsent_count() {
+    taskENTER_CRITICAL(&ringLock);
+    uint32_t unsent = nextSeq - unsentSeq;
+    taskEXIT_CRITICAL(&ringLock);
+    return unsent;
+}
+
+/**
+ * @brief Publishes one frame of the oldest unsent records.
+ *        Records are copied out one at a time so the lock is never held while formatting.
+ * @return false if the sink rejected the frame; the records stay unsent.
+ */
+bool UnitLog::publish_frame() {
+    taskENTER_CRITICAL(&ringLock);
+    uint32_t first = unsentSeq;
+    taskEXIT_CRITICAL(&ringLock);
+
+    size_t len = 0;
+    uint32_t base_ms = 0;
+    uint32_t seq = first;
+    for (;;) {
+        LogRecord record;
+        taskENTER_CRITICAL(&ringLock);
+        bool available = seq != nextSeq && nextSeq - seq <= LOG_RING_RECORDS;
+        if (available) {
+            record = ring[seq % LOG_RING_RECORDS];
+        }
+        taskEXIT_CRITICAL(&ringLock);
+        if (!available) {
+            break;
+        }
+
+        if (seq == first) {
+            base_ms = record.ms;
+            len = snprintf(frameBuffer, sizeof(frameBuffer), "%u %08lx %lu %lu", LOG_FRAME_VERSION,
+                           (unsigned long)bootId, (unsigned long)first, (unsigned long)base_ms);
+        }
+        int line = snprintf(frameBuffer + len, sizeof(frameBuffer) - len, "\n%lu %c %08lx %u %s",
+                            (unsigned long)(record.ms - base_ms), levelChars[record.level & 3],
+                            (unsigned long)record.site, (unsigned)record.suppressed, record.text);
+        if (line < 0 || len + line >= sizeof(frameBuffer)) {
+            frameBuffer[len] = '\0'; // Starts the next frame
+            break;
+        }
+        len += line;
+        seq++;
+    }
+
+    if (seq == first) {
+        return true; // Nothing to send
+    }
+    if (!sink(frameBuffer)) {
+        backingOff = true;
+        rejectedAtMs = millis();
+        return false;
+    }
+
+    taskENTER_CRITICAL(&ringLock);
+    // A writer may have advanced unsentSeq past some of these records while the frame was built
+    if ((int32_t)(seq - unsentSeq) > 0) {
+        unsentSeq = seq;
+    }
+    taskEXIT_CRITICAL(&ringLock);
+    sent += seq - first;
+    frames++;
+    return true;
+}
+
+void UnitLog::service() {
+    if (sink == nullptr) {
+        return;
+    }
+    uint16_t unsent = unsent_count();
+    if (unsent == 0) {
+        flushDue = false;
+        return;
+    }
+    if (!flushDue && unsent < LOG_FLUSH_RECORDS) {
+        // Batch: wait for more records or for the flush interval
+        if (!flushTimer.active()) {
+            TimerWheel::schedule(flushTimer, LOG_FLUSH_MS, on_flush_timer, nullptr);
+        }
+        return;
+    }
+    // One frame per pass; once due, everything is drained, including a backlog after a reconnect
+    flushDue = true;
+    if (!sink_accepting()) {
+        return; // Still due; sent once the sink is back
+    }
+    if (publish_frame() && unsent_count() == 0) {
+        flushDue = false;
+    }
+}
+
+void UnitLog::flush() {
+    if (sink == nullptr) {
+        return;
+    }
+    backingOff = false; // Last chance before deep sleep
+    while (unsent_count() > 0 && (sinkReady == nullptr || sinkReady()) && publish_frame()) {
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef UNIT_LOG_H
+#define UNIT_LOG_H
+
+#include <Arduino.h>
+#include "../config/config.h"
+
+enum LogLevel : uint8_t {
+    ULOG_DEBUG = 0,
+    ULOG_INFO = 1,
+    ULOG_WARN = 2,
+    ULOG_ERROR = 3,
+};
+
+/**
+ * @brief Per-call-site sampling state. One static instance lives at each ULOG() call site.
+ *        The counters are not atomic; a site hit from two tasks at once may be sampled
+ *        slightly off, which is acceptable for logging.
+ */
+struct LogSite {
+    uint32_t id;         ///< FNV-1a of the file name mixed with the line, stable across builds of the same source
+    uint32_t hits;       ///< Calls so far
+    uint16_t suppressed; ///< Calls dropped by sampling since the last record written (saturates)
+};
+
+constexpr uint32_t log_site_id(const char* file, uint32_t line, uint32_t hash = 2166136261UL) {
+    return *file == '\0' ? (hash ^ line) * 16777619UL : log_site_id(file + 1, line, (hash ^ (uint8_t)*file) * 16777619UL);
+}
+
+/**
+ * @brief Sampled logging to Serial and, in batched frames, to MQTT.
+ *
+ * Each call site logs its first LOG_SAMPLE_FIRST calls, then one in every LOG_SAMPLE_EVERY;
+ * the number skipped is carried on the next record from that site. A sampled-out call costs
+ * one counter increment: the arguments are not evaluated and nothing is formatted.
+ *
+ * Records at or above LOG_REMOTE_LEVEL go into a ring of LOG_RING_RECORDS that survives
+ * MQTT outages. service() publishes unsent records in frames of up to LOG_FRAME_LEN bytes
+ * every LOG_FLUSH_MS (or as soon as LOG_FLUSH_RECORDS are waiting); after a reconnect
+ * it backfills one frame per loop pass. While the sink is not ready nothing is formatted,
+ * and after a rejected frame the next attempt waits LOG_RETRY_MS. Records overwritten
+ * before they were sent are counted and show up as a sequence gap on the central side.
+ *
+ * Frame (text, '\n'-separated):
+ *   "<version> <boot id hex> <first seq> <base ms>" then per record
+ *   "<ms - base> <D|I|W|E> <site hex> <suppressed> <text>"
+ * Records in a frame have consecutive sequence numbers starting at <first seq>.
+ */
+class UnitLog {
+public:
+    /**
+     * @brief Publishes one frame; returns false if it could not be sent (e.g. not connected).
+     */
+    typedef bool (*FrameSink)(const char* frame);
+
+    /**
+     * @brief Cheap check that the sink could take a frame now (e.g. MQTT connected).
+     *        While it returns false no frame is formatted.
+     */
+    typedef bool (*SinkReady)();
+
+    /**
+     * @brief Sets the frame sink. Records written before this are kept and sent on the first flush.
+     */
+    static void begin(FrameSink sink, SinkReady ready = nullptr);
+
+    /**
+     * @brief Counts a call and decides whether it is logged. Used by ULOG().
+     */
+    static inline bool admit(LogSite& site) {
+        uint32_t hits = ++site.hits;
+        if (hits <= LOG_SAMPLE_FIRST || (hits - LOG_SAMPLE_FIRST) % LOG_SAMPLE_EVERY == 0) {
+            return true;
+        }
+        if (site.suppressed < 0xFFFF) {
+            site.suppressed++;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Formats and stores one record. Safe to call from any task. Use ULOG() instead.
+     */
+    static void write(LogSite& site, LogLevel level, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+    /**
+     * @brief Publishes a frame when one is due. Call once per loop pass.
+     */
+    static void service();
+
+    /**
+     * @brief Publishes every unsent record now, as far as the sink accepts them (before deep sleep).
+     */
+    static void flush();
+
+    static unsigned long written_count() { return written; }
+    static unsigned long sent_count() { return sent; }
+    static unsigned long lost_count() { return lost; }
+    static unsigned long frame_count() { return frames; }
+    static uint16_t unsent_count();
+
+private:
+    static bool publish_frame();
+
+    static unsigned long written;
+    static unsigned long sent;
+    static unsigned long lost;
+    static unsigned long frames;
+};
+
+/**
+ * @brief Logs a printf-style message, sampled per call site.
+ *        Usage: ULOG(ULOG_INFO, "Subscribed to: %s", topic);
+ */
+#define ULOG(level, ...)                                                              \
+    do {                                                                              \
+        static LogSite ulog_site_ = {log_site_id(__FILE__, __LINE__), 0, 0};          \
+        if ((level) >= LOG_MIN_LEVEL && UnitLog::admit(ulog_site_)) {                 \
+            UnitLog::write(ulog_site_, (level), __VA_ARGS__);                         \
+        }                                                                             \
+    } while (0)
+
+#endif // UNIT_LOG_H
@@ -0,0 +1,83 @@
+#include "warm_restart.h"
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <esp_rom_crc.h>
+
+struct WarmRecord {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    WarmSnapshot state;
+    uint32_t crc; ///< CRC32 of everything above.
+};
+
+static_assert(sizeof(WarmRecord) <= WARM_STATE_RTC_BUDGET,
+              "WarmRecord outgrows its share of RTC slow memory; lower INBOX_CAPACITY or raise WARM_STATE_RTC_BUDGET");
+static_assert(sizeof(WarmSnapshot) <= UINT16_MAX, "WarmRecord::size is uint16_t");
+
+RTC_NOINIT_ATTR static WarmRecord rtcRecord;
+
+static WARM_GATHER_SIGNATURE gatherState = nullptr;
+static bool dirty = false;
+
+static uint32_t record_crc() {
+    return esp_rom_crc32_le(0, (const uint8_t*)&rtcRecord, offsetof(WarmRecord, crc));
+}
+
+/**
+ * @brief Power-on and brownout leave RTC memory undefined, so only resets that keep it
+ *        powered are trusted even if the CRC happens to match.
+ */
+const WarmSnapshot* WarmRestart::restore() {
+    esp_reset_reason_t reason = esp_reset_reason();
+    bool retained = reason == ESP_RST_SW || reason == ESP_RST_PANIC || reason == ESP_RST_INT_WDT ||
+                    reason == ESP_RST_TASK_WDT || reason == ESP_RST_WDT || reason == ESP_RST_DEEPSLEEP;
+
+    if (!retained || rtcRecord.magic != WARM_STATE_MAGIC || rtcRecord.version != WARM_STATE_VERSION ||
+        rtcRecord.size != sizeof(WarmSnapshot) || rtcRecord.crc != record_crc()) {
+        Serial.print(F("Cold start (reset reason "));
+        Serial.print((int)reason);
+        Serial.println(F(")."));
+        rtcRecord.magic = 0;
+        return nullptr;
+    }
+
+    WarmSnapshot& state = rtcRecord.state;
+    state.status[sizeof(state.status) - 1] = '\0';
+    if (state.inbox_count > INBOX_CAPACITY) {
+        state.inbox_count = INBOX_CAPACITY;
+    }
+    state.shown.student_id[sizeof(state.shown.student_id) - 1] = '\0'; // Drawn as-is by applyWarmState()
+    state.shown.request_text[sizeof(state.shown.request_text) - 1] = '\0';
+    Serial.print(F("Warm restart: status "));
+    Serial.print(state.status);
+    Serial.print(F(", presence "));
+    Serial.print(state.presence);
+    Serial.print(F(", "));
+    Serial.print(state.inbox_count);
+    Serial.println(F(" pending requests restored."));
+    return &state;
+}
+
+void WarmRestart::begin(WARM_GATHER_SIGNATURE gather) {
+    gatherState = gather;
+    dirty = true;
+}
+
+void WarmRestart::mark_dirty() {
+    dirty = true;
+}
+
+void WarmRestart::checkpoint() {
+    if (!dirty || gatherState == nullptr) {
+        return;
+    }
+    dirty = false;
+
+    rtcRecord.magic = 0; // Invalid while being rewritten
+    gatherState(rtcRecord.state);
+    rtcRecord.version = WARM_STATE_VERSION;
+    rtcRecord.size = sizeof(WarmSnapshot);
+    rtcRecord.magic = WARM_STATE_MAGIC;
+    rtcRecord.crc = record_crc();
+}
@@ -0,0 +1,57 @@
+#ifndef WARM_RESTART_H
+#define WARM_RESTART_H
+
+#include <Arduino.h>
+#include "../config/config.h"
+#include "../comms/request_inbox.h" // InboxRequest
+
+static_assert(INBOX_CAPACITY <= 255, "WarmSnapshot::inbox_count and snapshot_pending_requests() count in uint8_t");
+
+/**
+ * @brief Runtime state worth keeping across a watchdog reset or OTA restart.
+ */
+struct WarmSnapshot {
+    char status[MANUAL_STATUS_LEN];     ///< Manual status (available/busy/away).
+    int8_t presence;                    ///< Last published presence: 1, 0, or -1 for none.
+    int64_t presence_deadline_us;       ///< System time (gettimeofday) when presence expires.
+    float adv_interval_ms;              ///< Learned beacon advertising interval (0 = unknown).
+    float adv_loss;                     ///< Learned beacon packet-loss rate.
+    uint8_t inbox_count;
+    InboxRequest inbox[INBOX_CAPACITY]; ///< Pending requests, highest rank first.
+    bool request_shown;                 ///< `shown` holds the request on screen.
+    InboxRequest shown;                 ///< Request on screen, already popped from the inbox.
+};
+
+typedef void (*WARM_GATHER_SIGNATURE)(WarmSnapshot& out);
+
+/**
+ * @brief Checkpoints a WarmSnapshot into RTC slow memory (RTC_NOINIT), which survives
+ *        software resets, panics, watchdog resets and deep sleep but not power loss.
+ *        The record carries a magic number, WARM_STATE_VERSION, its size and a CRC32,
+ *        so a cold boot or a firmware with a different layout starts clean.
+ */
+class WarmRestart {
+public:
+    /**
+     * @brief Validates the RTC record. Call once, early in setup().
+     * @return The restored snapshot, or nullptr on a cold boot or invalid record.
+     */
+    static const WarmSnapshot* restore();
+
+    /**
+     * @brief Registers the function that fills a snapshot from the live modules.
+     */
+    static void begin(WARM_GATHER_SIGNATURE gather);
+
+    /**
+     * @brief Notes that checkpointed state has changed.
+     */
+    static void mark_dirty();
+
+    /**
+     * @brief Rewrites the RTC record if anything changed. Call once per loop pass.
+     */
+    static void checkpoint();
+};
+
+#endif // WARM_RESTART_H
@@ -0,0 +1,116 @@
+#include "asset_store.h"
+#include "unit_log.h" // Sampled Serial/MQTT logging
+
+// Upload in progress (only one at a time)
+static File uploadFile;
+static char uploadName[ASSET_NAME_LEN] = "";
+static uint32_t uploadExpectedOffset = 0;
+
+/**
+ * @brief Mounts LittleFS and makes sure the asset directory exists.
+ */
+bool AssetStore::begin() {
+    if (!LittleFS.begin(true)) { // true = format on first mount failure
+        Serial.println(F("LittleFS mount failed; display assets disabled."));
+        return false;
+    }
+    if (!LittleFS.exists(ASSET_DIR)) {
+        LittleFS.mkdir(ASSET_DIR);
+    }
+    Serial.println(F("Asset store ready."));
+    return true;
+}
+
+/**
+ * @brief Restricts names to a safe character set so a topic cannot escape ASSET_DIR.
+ */
+bool AssetStore::valid_name(const char* name) {
+    size_t len = strlen(name);
+    if (len == 0 || len >= ASSET_NAME_LEN) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        char c = name[i];
+        if (!isalnum((unsigned char)c) && c != '_' && c != '-') {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetStore::build_path(char* out, size_t out_size, const char* name, bool partial) {
+    snprintf(out, out_size, "%s/%s.qoi%s", ASSET_DIR, name, partial ? ".part" : "");
+}
+
+/**
+ * @brief Appends a chunk to ASSET_DIR/<name>.qoi.part and renames it into place
+ *        after the last byte, so a half-finished upload never replaces a good asset.
+ */
+bool AssetStore::write_chunk(const char* name, const byte* payload, unsigned int length) {
+    if (!valid_name(name) || length < 8) {
+        ULOG(ULOG_WARN, "Rejected asset chunk: bad name or header.");
+        return false;
+    }
+
+    uint32_t offset = ((uint32_t)payload[0] << 24) | ((uint32_t)payload[1] << 16) | ((uint32_t)payload[2] << 8) | payload[3];
+    uint32_t total = ((uint32_t)payload[4] << 24) | ((uint32_t)payload[5] << 16) | ((uint32_t)payload[6] << 8) | payload[7];
+    const byte* data = payload + 8;
+    uint32_t data_len = length - 8;
+
+    if (total > ASSET_MAX_BYTES || offset + data_len > total) {
+        ULOG(ULOG_WARN, "Rejected asset chunk: size out of range.");
+        return false;
+    }
+
+    char path[48];
+    build_path(path, sizeof(path), name, true);
+
+    if (offset == 0) {
+        // Start (or restart) an upload; abandon any other upload in progress
+        if (uploadFile) {
+            uploadFile.close();
+        }
+        uploadFile = LittleFS.open(path, FILE_WRITE);
+        strncpy(uploadName, name, sizeof(uploadName) - 1);
+        uploadName[sizeof(uploadName) - 1] = '\0';
+        uploadExpectedOffset = 0;
+    }
+
+    if (!uploadFile || strcmp(uploadName, name) != 0 || offset != uploadExpectedOffset) {
+        ULOG(ULOG_WARN, "Rejected asset chunk: out of order.");
+        return false;
+    }
+
+    if (uploadFile.write(data, data_len) != data_len) {
+        ULOG(ULOG_ERROR, "Asset write failed (filesystem full?).");
+        uploadFile.close();
+        LittleFS.remove(path);
+        return false;
+    }
+    uploadExpectedOffset += data_len;
+
+    if (uploadExpectedOffset == total) {
+        uploadFile.close();
+        char final_path[48];
+        build_path(final_path, sizeof(final_path), name, false);
+        LittleFS.remove(final_path);
+        LittleFS.rename(path, final_path);
+        ULOG(ULOG_INFO, "Asset stored: %s", final_path);
+    }
+    return true;
+}
+
+/**
+ * @brief Opens ASSET_DIR/<name>.qoi for reading.
+ */
+File AssetStore::open(const char* name) {
+    if (!valid_name(name)) {
+        return File();
+    }
+    char path[48];
+    build_path(path, sizeof(path), name, false);
+    if (!LittleFS.exists(path)) {
+        return File();
+    }
+    return LittleFS.open(path, FILE_READ);
+}
@@ -0,0 +1,45 @@
+#ifndef ASSET_STORE_H
+#define ASSET_STORE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include "../config/config.h"
+
+/**
+ * @brief Static utility class for QOI display assets kept in LittleFS (ASSET_DIR/<name>.qoi).
+ *        Assets are uploaded over MQTT in chunks and written to a temporary file that
+ *        replaces the live one only once the final chunk has arrived.
+ */
+class AssetStore {
+public:
+    /**
+     * @brief Mounts LittleFS (formatting it on first use) and creates ASSET_DIR.
+     * @return true if the filesystem is usable.
+     */
+    static bool begin();
+
+    /**
+     * @brief Handles one upload chunk.
+     *        Payload layout: 4-byte big-endian offset, 4-byte big-endian total size, data.
+     *        Chunks must arrive in order; offset 0 starts a new upload.
+     * @param name Asset name (letters, digits, '_' and '-' only).
+     * @param payload Raw MQTT payload.
+     * @param length Payload length in bytes.
+     * @return true if the chunk was accepted.
+     */
+    static bool write_chunk(const char* name, const byte* payload, unsigned int length);
+
+    /**
+     * @brief Opens an asset for reading.
+     * @param name Asset name without directory or extension.
+     * @return An open File, or a closed one if the asset does not exist.
+     */
+    static File open(const char* name);
+
+private:
+    static bool valid_name(const char* name);
+    static void build_path(char* out, size_t out_size, const char* name, bool partial);
+};
+
+#endif // ASSET_STORE_H
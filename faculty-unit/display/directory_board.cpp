@@ -0,0 +1,237 @@
+#include "directory_board.h"
+#include "display_manager.h" // Row and header drawing
+#include <ArduinoJson.h>     // Manual status payloads
+#include "unit_log.h"        // Sampled Serial/MQTT logging
+
+#define ROWS_PER_PAGE ((SCREEN_HEIGHT - DIRECTORY_HEADER_HEIGHT) / DIRECTORY_ROW_HEIGHT)
+
+static DirectoryEntry entries[DIRECTORY_MAX_ENTRIES];
+static uint8_t entryCount = 0;
+
+static uint8_t currentPage = 0;
+static bool pageDirty = true;        // Redraw every row of the current page
+static bool headerDirty = true;      // Entry or page count changed
+static bool changesPending = false;  // Something was ingested since the last draw
+static WheelTimer redrawHoldTimer;   // Active while changes are being collected
+static WheelTimer pageTimer;         // Fires when the next page is due
+static bool pageFlipDue = false;     // Set by pageTimer
+
+static StaticJsonDocument<JSON_STATUS_DOC_SIZE> statusDoc;
+
+// Labels and colours indexed by DirectoryState
+static const char* const stateLabels[] = {"?", "Present", "Not in", "Available", "Busy", "Away", "Offline"};
+static const uint16_t stateColors[] = {
+    ILI9341_DARKGREY, ILI9341_GREEN, ILI9341_RED, ILI9341_GREEN, ILI9341_ORANGE, ILI9341_RED, ILI9341_DARKGREY
+};
+
+static uint8_t page_count() {
+    return entryCount == 0 ? 1 : (entryCount + ROWS_PER_PAGE - 1) / ROWS_PER_PAGE;
+}
+
+static void on_page_timer(void*) {
+    pageFlipDue = true;
+}
+
+static uint8_t parse_state(const char* text) {
+    static const char* const names[] = {"", "present", "unavailable", "available", "busy", "away", "offline"};
+    for (uint8_t i = 1; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcasecmp(text, names[i]) == 0) {
+            return i;
+        }
+    }
+    return DIRECTORY_UNKNOWN;
+}
+
+/**
+ * @brief Binary search by id. Returns the entry's index, or the insertion point with
+ *        *found false.
+ */
+static uint8_t find_entry(const char* id, size_t id_len, bool* found) {
+    uint8_t low = 0;
+    uint8_t high = entryCount;
+    while (low < high) {
+        uint8_t mid = (low + high) / 2;
+        int cmp = strncmp(entries[mid].id, id, id_len);
+        if (cmp == 0 && entries[mid].id[id_len] != '\0') {
+            cmp = 1; // Stored id is longer, so it sorts after
+        }
+        if (cmp == 0) {
+            *found = true;
+            return mid;
+        }
+        if (cmp < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    *found = false;
+    return low;
+}
+
+// Rows from `index` on moved; the ones on screen are redrawn
+static void mark_dirty_from(uint8_t index) {
+    for (uint8_t i = index; i < entryCount; i++) {
+        entries[i].dirty = true;
+    }
+}
+
+static void hold_redraw() {
+    changesPending = true;
+    if (!redrawHoldTimer.active()) {
+        TimerWheel::schedule(redrawHoldTimer, DIRECTORY_REDRAW_HOLD_MS, nullptr, nullptr);
+    }
+}
+
+/**
+ * @brief Inserts the entry at `index` if it is new, then applies the state and name
+ *        (nullptr keeps the current name).
+ */
+static bool apply_state(uint8_t index, bool found, const char* faculty_id, size_t id_len,
+                        uint8_t state, const char* name) {
+    if (!found) {
+        if (entryCount >= DIRECTORY_MAX_ENTRIES) {
+            ULOG(ULOG_WARN, "Directory board full, ignoring new faculty.");
+            return false;
+        }
+        memmove(&entries[index + 1], &entries[index], (entryCount - index) * sizeof(DirectoryEntry));
+        entryCount++;
+        DirectoryEntry& entry = entries[index];
+        memcpy(entry.id, faculty_id, id_len);
+        entry.id[id_len] = '\0';
+        entry.name[0] = '\0';
+        entry.state = DIRECTORY_UNKNOWN;
+        mark_dirty_from(index);
+        headerDirty = true;
+    }
+
+    DirectoryEntry& entry = entries[index];
+    if (entry.state != state) {
+        entry.state = state;
+        entry.dirty = true;
+    }
+    if (name != nullptr && strncmp(entry.name, name, sizeof(entry.name) - 1) != 0) {
+        strncpy(entry.name, name, sizeof(entry.name) - 1);
+        entry.name[sizeof(entry.name) - 1] = '\0';
+        entry.dirty = true;
+    }
+    if (entry.dirty) {
+        hold_redraw();
+    }
+    return true;
+}
+
+void DirectoryBoard::begin() {
+    entryCount = 0;
+    currentPage = 0;
+    pageDirty = true;
+    headerDirty = true;
+    changesPending = true;
+    DisplayManager::clear_display();
+}
+
+bool DirectoryBoard::ingest(const char* faculty_id, size_t id_len, const uint8_t* payload, unsigned int length) {
+    if (id_len == 0 || id_len >= DIRECTORY_ID_LEN) {
+        return false;
+    }
+
+    bool found = false;
+    uint8_t index = find_entry(faculty_id, id_len, &found);
+
+    if (length == 0) {
+        // Retained status cleared: the faculty member was removed
+        if (found) {
+            memmove(&entries[index], &entries[index + 1], (entryCount - index - 1) * sizeof(DirectoryEntry));
+            entryCount--;
+            if (currentPage >= page_count()) {
+                currentPage = page_count() - 1;
+            }
+            pageDirty = true; // Rows shift up and the last one is blanked
+            headerDirty = true;
+            hold_redraw();
+        }
+        return true;
+    }
+
+    const char* name = nullptr;
+    uint8_t state;
+    if (payload[0] == '{') {
+        if (deserializeJson(statusDoc, payload, length)) {
+            return false;
+        }
+        state = parse_state(statusDoc["status"] | "");
+        name = statusDoc["name"];
+    } else {
+        char text[16];
+        size_t n = length < sizeof(text) - 1 ? length : sizeof(text) - 1;
+        memcpy(text, payload, n);
+        text[n] = '\0';
+        state = parse_state(text);
+    }
+
+    return apply_state(index, found, faculty_id, id_len, state, name);
+}
+
+bool DirectoryBoard::ingest_state(const char* faculty_id, uint8_t state) {
+    size_t id_len = strlen(faculty_id);
+    if (id_len == 0 || id_len >= DIRECTORY_ID_LEN) {
+        return false;
+    }
+    bool found = false;
+    uint8_t index = find_entry(faculty_id, id_len, &found);
+    return apply_state(index, found, faculty_id, id_len, state, nullptr);
+}
+
+void DirectoryBoard::service() {
+    if (pageFlipDue) {
+        pageFlipDue = false;
+        next_page();
+    } else if (!pageTimer.active() && page_count() > 1) {
+        TimerWheel::schedule(pageTimer, DIRECTORY_PAGE_MS, on_page_timer, nullptr);
+    }
+
+    if (!changesPending || redrawHoldTimer.active()) {
+        return; // Nothing new, or still collecting a burst
+    }
+    changesPending = false;
+
+    uint8_t first = currentPage * ROWS_PER_PAGE;
+    if (pageDirty || headerDirty) {
+        DisplayManager::show_directory_header(currentPage, page_count(), entryCount);
+    }
+    for (uint8_t slot = 0; slot < ROWS_PER_PAGE; slot++) {
+        uint8_t index = first + slot;
+        if (index >= entryCount) {
+            if (pageDirty) {
+                DisplayManager::show_directory_row(slot, nullptr, nullptr, 0); // Blank the rest of the page
+            }
+            continue;
+        }
+        DirectoryEntry& entry = entries[index];
+        if (pageDirty || entry.dirty) {
+            DisplayManager::show_directory_row(slot, entry.name[0] != '\0' ? entry.name : entry.id,
+                                               stateLabels[entry.state], stateColors[entry.state]);
+        }
+    }
+    pageDirty = false;
+    headerDirty = false;
+
+    // Off-page changes are drawn with their page
+    for (uint8_t i = 0; i < entryCount; i++) {
+        entries[i].dirty = false;
+    }
+}
+
+void DirectoryBoard::next_page() {
+    uint8_t pages = page_count();
+    currentPage = (currentPage + 1) % pages;
+    pageDirty = true;
+    changesPending = true;
+    if (pages > 1) {
+        TimerWheel::schedule(pageTimer, DIRECTORY_PAGE_MS, on_page_timer, nullptr);
+    }
+}
+
+uint8_t DirectoryBoard::count() {
+    return entryCount;
+}
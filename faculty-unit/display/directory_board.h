@@ -0,0 +1,83 @@
+#ifndef DIRECTORY_BOARD_H
+#define DIRECTORY_BOARD_H
+
+#include <Arduino.h>
+#include "../config/config.h"
+#include "../core/timer_wheel.h"
+
+/**
+ * @brief Faculty status as shown on the board. Both payloads published on the
+ *        status topic are understood: BLE presence ("Present"/"Unavailable") and
+ *        the manual status JSON ({"status": "busy", "name": ...}).
+ */
+enum DirectoryState : uint8_t {
+    DIRECTORY_UNKNOWN = 0,
+    DIRECTORY_PRESENT,
+    DIRECTORY_UNAVAILABLE,
+    DIRECTORY_AVAILABLE,
+    DIRECTORY_BUSY,
+    DIRECTORY_AWAY,
+    DIRECTORY_OFFLINE
+};
+
+/**
+ * @brief One board row. Kept sorted by id so lookups are a binary search.
+ */
+struct DirectoryEntry {
+    char id[DIRECTORY_ID_LEN];
+    char name[DIRECTORY_NAME_LEN]; ///< Empty until a status JSON with "name" arrives
+    uint8_t state;                 ///< DirectoryState
+    bool dirty;                    ///< Changed since it was last drawn
+};
+
+/**
+ * @brief Static table behind the hallway directory board (UNIT_ROLE_DIRECTORY).
+ *
+ * ingest() only updates the table and marks rows dirty, so a burst of retained
+ * status messages on connect costs a lookup per message. service() draws after
+ * DIRECTORY_REDRAW_HOLD_MS without new changes or at most that often during a
+ * burst, and then only the dirty rows of the page on screen. With more entries
+ * than fit on the screen, pages rotate every DIRECTORY_PAGE_MS.
+ */
+class DirectoryBoard {
+public:
+    /**
+     * @brief Clears the table and draws the empty board. Call after DisplayManager::setup_display().
+     */
+    static void begin();
+
+    /**
+     * @brief Applies one status message. An empty payload (retained status cleared)
+     *        removes the entry.
+     * @param faculty_id Faculty ID taken from the topic (not null-terminated).
+     * @param id_len Length of faculty_id.
+     * @return false if the message was ignored (table full or ID too long).
+     */
+    static bool ingest(const char* faculty_id, size_t id_len, const uint8_t* payload, unsigned int length);
+
+    /**
+     * @brief Applies a state that arrived without a status message (e.g. a LAN
+     *        multicast datagram). The display name is left as it is.
+     * @param faculty_id Null-terminated faculty ID.
+     * @param state DirectoryState
+     * @return false if the update was ignored (table full or ID too long).
+     */
+    static bool ingest_state(const char* faculty_id, uint8_t state);
+
+    /**
+     * @brief Draws pending changes and rotates pages when due. Call from loop().
+     */
+    static void service();
+
+    /**
+     * @brief Shows the next page now and restarts the rotation timer.
+     */
+    static void next_page();
+
+    /**
+     * @brief Number of faculty members on the board.
+     */
+    static uint8_t count();
+};
+
+#endif // DIRECTORY_BOARD_H
@@ -1,21 +1,55 @@
 #include "display_manager.h"
 #include "../config/config.h"
 #include <Arduino.h> // Include Arduino core for Serial
+#include "asset_store.h" // QOI assets in LittleFS
+#include "qoi_decoder.h" // Streaming QOI decoding
+#include "pixel_kernels.h" // RGB565 span kernels
+#include "text_bitmap.h" // Rasterized request text
+#include "unit_log.h" // Sampled Serial/MQTT logging
+#include <driver/gpio.h> // Pin hold across deep sleep
 
 // Instantiate the display object for ILI9341 SPI display
 // Parameters: CS, DC, RST pins (MOSI and SCK are usually hardware SPI)
 Adafruit_ILI9341 display = Adafruit_ILI9341(TFT_CS, TFT_DC, TFT_RST);
 
+#define ILI9341_IDLE_ON 0x39 // IDMON: 8-colour idle mode (not defined by Adafruit_ILI9341.h)
+
+// One decoded scanline for draw_asset()
+static uint16_t assetRow[SCREEN_WIDTH] __attribute__((aligned(16))); // Aligned for the vector kernels
+// Status whose icon is currently drawn, so the icon is only redrawn on change
+static char lastStatusIcon[ASSET_NAME_LEN] = "";
+// Draw time of the last request body, per path
+static unsigned long lastTextDrawUs = 0;
+static unsigned long lastBitmapDrawUs = 0;
+
 /**
  * @brief Initializes the TFT display object and clears the screen.
  * @return true if initialization is successful (assumed for now), false otherwise.
  */
-bool DisplayManager::setup_display() {
+bool DisplayManager::setup_display(bool keep_contents) {
     // SPI communication is typically initialized by the library's begin() method.
+    gpio_hold_dis((gpio_num_t)TFT_CS); // Held high by sleep_panel() during deep sleep
+#if TFT_RST >= 0
+    gpio_hold_dis((gpio_num_t)TFT_RST);
+#endif
+#if TFT_BACKLIGHT >= 0
+    gpio_hold_dis((gpio_num_t)TFT_BACKLIGHT);
+    pinMode(TFT_BACKLIGHT, OUTPUT);
+    digitalWrite(TFT_BACKLIGHT, HIGH);
+#endif
 
-    // Initialize the ILI9341 display
+    // Initialize the ILI9341 display (its init sequence ends with sleep out + display on)
     display.begin();
 
+    if (keep_contents) {
+        display.setTextSize(2);
+        display.setTextColor(ILI9341_WHITE);
+        display.setTextWrap(true);
+        AssetStore::begin();
+        Serial.println(F("ILI9341 TFT display resumed with retained contents."));
+        return true;
+    }
+
     // Check if initialization was successful (optional, begin() might not return status)
     // Add specific checks here if the library provides them.
     // For now, assume success if no crash.
@@ -29,10 +63,41 @@ bool DisplayManager::setup_display() {
 
     // No display.display() needed for Adafruit_ILI9341, drawing is immediate
 
+    // Show the faculty photo on the idle screen, if one has been uploaded
+    if (AssetStore::begin()) {
+        int status_height = 25;
+        draw_asset(ASSET_PHOTO_NAME, 0, status_height, SCREEN_WIDTH, SCREEN_HEIGHT - status_height);
+    }
+
     Serial.println(F("ILI9341 TFT display initialized."));
     return true; // Assume success for now
 }
 
+/**
+ * @brief A floating reset line would blank the panel mid-sleep, so it is held high
+ *        along with chip select.
+ */
+void DisplayManager::sleep_panel() {
+#if BATTERY_DISPLAY_ASLEEP
+    display.sendCommand(ILI9341_IDLE_ON); // begin() on the next wake returns to full colour
+#else
+    display.sendCommand(ILI9341_DISPOFF);
+    display.sendCommand(ILI9341_SLPIN);
+#if TFT_BACKLIGHT >= 0
+    digitalWrite(TFT_BACKLIGHT, LOW);
+#endif
+#endif
+    digitalWrite(TFT_CS, HIGH);
+    gpio_hold_en((gpio_num_t)TFT_CS);
+#if TFT_RST >= 0
+    gpio_hold_en((gpio_num_t)TFT_RST);
+#endif
+#if TFT_BACKLIGHT >= 0
+    gpio_hold_en((gpio_num_t)TFT_BACKLIGHT);
+#endif
+    gpio_deep_sleep_hold_en();
+}
+
 /**
  * @brief Clears the entire display area by filling it with black.
  *        Resets the cursor position to a default top-left location.
@@ -52,11 +117,24 @@ void DisplayManager::show_status(const char* status_text) {
     int status_x = 0; // Start from left edge
     int status_y = 0; // Start from top edge
     int status_height = 25; // Estimated height for size 2 text + padding
-    int status_width = SCREEN_WIDTH; // Use full width
+    int status_width = SCREEN_WIDTH - STATUS_ICON_SIZE - 4; // Leave room for the status icon
 
-    // Clear the status area first
+    // Clear the status text area first
     display.fillRect(status_x, status_y, status_width, status_height, ILI9341_BLACK);
 
+    // Status icon: asset "status_<text>" (lowercase, non-alphanumerics as '_'), redrawn only on change
+    char icon_name[ASSET_NAME_LEN];
+    snprintf(icon_name, sizeof(icon_name), "status_%s", status_text);
+    for (char* c = icon_name; *c != '\0'; c++) {
+        *c = isalnum((unsigned char)*c) ? tolower((unsigned char)*c) : '_';
+    }
+    if (strcmp(icon_name, lastStatusIcon) != 0) {
+        int icon_x = SCREEN_WIDTH - STATUS_ICON_SIZE - 2;
+        display.fillRect(icon_x, 2, STATUS_ICON_SIZE, STATUS_ICON_SIZE, ILI9341_BLACK);
+        draw_asset(icon_name, icon_x, 2, STATUS_ICON_SIZE, STATUS_ICON_SIZE);
+        strncpy(lastStatusIcon, icon_name, sizeof(lastStatusIcon) - 1);
+    }
+
     // Set text properties and draw the new status
     display.setTextSize(2);
     display.setTextColor(ILI9341_WHITE);
@@ -64,6 +142,90 @@ void DisplayManager::show_status(const char* status_text) {
     display.println(status_text); // Use println to handle line breaks if needed
 }
 
+/**
+ * @brief Draws a QOI asset centred in a box, streaming each decoded scanline
+ *        into the panel's address window.
+ */
+bool DisplayManager::draw_asset(const char* name, int16_t box_x, int16_t box_y, int16_t box_w, int16_t box_h) {
+    File file = AssetStore::open(name);
+    if (!file) {
+        return false;
+    }
+
+    QoiDecoder qoi;
+    if (!qoi.begin(file) || qoi.width() > box_w || qoi.height() > box_h) {
+        ULOG(ULOG_WARN, "Asset not drawable: %s", name);
+        file.close();
+        return false;
+    }
+
+    int16_t x = box_x + (box_w - qoi.width()) / 2;
+    int16_t y = box_y + (box_h - qoi.height()) / 2;
+
+    display.startWrite();
+    display.setAddrWindow(x, y, qoi.width(), qoi.height());
+    bool ok = true;
+    for (uint16_t row = 0; row < qoi.height(); row++) {
+        if (!qoi.read_row(assetRow)) {
+            ok = false; // Truncated file; the rest of the window keeps its old contents
+            break;
+        }
+        // Swap to SPI byte order here so the row goes out as raw bytes
+        PixelKernels::swap_bytes(assetRow, assetRow, qoi.width());
+        display.writePixels(assetRow, qoi.width(), true, true);
+    }
+    display.endWrite();
+    file.close();
+    return ok;
+}
+
+/**
+ * @brief Draws the directory board title and, with more than one page, "page/pages".
+ */
+void DisplayManager::show_directory_header(uint8_t page, uint8_t pages, uint8_t count) {
+    display.fillRect(0, 0, SCREEN_WIDTH, DIRECTORY_HEADER_HEIGHT, ILI9341_NAVY);
+    display.setTextSize(2);
+    display.setTextColor(ILI9341_WHITE);
+    display.setCursor(4, 4);
+    display.print(F("Faculty ("));
+    display.print(count);
+    display.print(F(")"));
+    if (pages > 1) {
+        char indicator[8];
+        snprintf(indicator, sizeof(indicator), "%u/%u", page + 1, pages);
+        display.setCursor(SCREEN_WIDTH - 4 - strlen(indicator) * 12, 4); // 12 px per size-2 character
+        display.print(indicator);
+    }
+}
+
+/**
+ * @brief Draws a directory row: the name (size 2, clipped to fit) and the status
+ *        label right-aligned in its colour. Only this row's band is cleared.
+ */
+void DisplayManager::show_directory_row(uint8_t slot, const char* name, const char* status, uint16_t color) {
+    int16_t y = DIRECTORY_HEADER_HEIGHT + slot * DIRECTORY_ROW_HEIGHT;
+    display.fillRect(0, y, SCREEN_WIDTH, DIRECTORY_ROW_HEIGHT, ILI9341_BLACK);
+    if (name == nullptr) {
+        return;
+    }
+
+    // Size 1 status label on the right, name gets the rest of the row
+    int16_t status_w = strlen(status) * 6;
+    uint8_t name_chars = (SCREEN_WIDTH - status_w - 12) / 12;
+    char clipped[DIRECTORY_NAME_LEN];
+    snprintf(clipped, sizeof(clipped) < name_chars + 1U ? sizeof(clipped) : name_chars + 1, "%s", name);
+
+    display.setTextSize(2);
+    display.setTextColor(ILI9341_WHITE);
+    display.setCursor(4, y + 2);
+    display.print(clipped);
+
+    display.setTextSize(1);
+    display.setTextColor(color);
+    display.setCursor(SCREEN_WIDTH - 4 - status_w, y + 6);
+    display.print(status);
+}
+
 /**
  * @brief Placeholder/Compatibility function. For ILI9341 with Adafruit_GFX,
  *        drawing commands often update the display directly. This is not needed.
@@ -82,9 +244,10 @@ void DisplayManager::update_display() {
  * @param student_id The ID of the student making the request.
  * @param request_text The text of the consultation request.
  */
-void DisplayManager::show_request(const char* student_id, const char* request_text) {
+void DisplayManager::show_request(const char* student_id, const char* request_text,
+                                  const uint8_t* bitmap, size_t bitmap_len) {
     if (student_id == nullptr || request_text == nullptr) {
-        Serial.println(F("Error: Null pointer passed to show_request."));
+        ULOG(ULOG_ERROR, "Null pointer passed to show_request.");
         return; // Don't attempt to display null data
     }
 
@@ -102,10 +265,52 @@ void DisplayManager::show_request(const char* student_id, const char* request_te
     display.print(F("From: "));
     display.println(student_id);
 
-    // Print request text, potentially wrapping
-    display.setCursor(0, display.getCursorY() + 2); // Move down slightly for the message
-    display.println(request_text); // println should handle wrapping if enabled
+    // Prefer the rasterized text; scripts the built-in font cannot draw arrive that way
+    unsigned long start = micros();
+    if (bitmap != nullptr && draw_text_bitmap(bitmap, bitmap_len, 0, REQUEST_TEXT_Y)) {
+        lastBitmapDrawUs = micros() - start;
+        ULOG(ULOG_INFO, "Drew request bitmap (%u bytes) in %lu us", (unsigned)bitmap_len, lastBitmapDrawUs);
+    } else {
+        // Print request text, potentially wrapping
+        display.setCursor(0, display.getCursorY() + 2); // Move down slightly for the message
+        display.println(request_text); // println should handle wrapping if enabled
+        lastTextDrawUs = micros() - start;
+        ULOG(ULOG_INFO, "Drew request text (%u bytes) in %lu us", (unsigned)strlen(request_text), lastTextDrawUs);
+    }
 
     // Note: No display.display() needed for ILI9341
-    Serial.println(F("Displayed new request on TFT."));
+}
+
+unsigned long DisplayManager::last_request_draw_us(bool bitmap) {
+    return bitmap ? lastBitmapDrawUs : lastTextDrawUs;
+}
+
+/**
+ * @brief Each run is filled with a palette colour already in SPI byte order, so
+ *        decoded rows go to the panel without a separate swap pass.
+ */
+bool DisplayManager::draw_text_bitmap(const uint8_t* bitmap, size_t len, int16_t x, int16_t y) {
+    TextBitmapDecoder bmp;
+    if (!bmp.begin(bitmap, len) || x + bmp.width() > SCREEN_WIDTH || y + bmp.height() > SCREEN_HEIGHT) {
+        ULOG(ULOG_WARN, "Request bitmap not drawable.");
+        return false;
+    }
+
+    // Levels are evenly spaced steps on the build_ramp() ramp
+    uint16_t ramp[16];
+    PixelKernels::build_ramp(ramp, ILI9341_WHITE, ILI9341_BLACK);
+    uint16_t palette[4];
+    for (uint8_t level = 0; level < bmp.levels(); level++) {
+        uint16_t c = ramp[level * 15 / (bmp.levels() - 1)];
+        palette[level] = (c >> 8) | (c << 8);
+    }
+
+    display.startWrite();
+    display.setAddrWindow(x, y, bmp.width(), bmp.height());
+    for (uint16_t row = 0; row < bmp.height(); row++) {
+        bmp.read_row(assetRow, palette); // Cannot fail, begin() checked the run total
+        display.writePixels(assetRow, bmp.width(), true, true);
+    }
+    display.endWrite();
+    return true;
 }
\ No newline at end of file
@@ -19,9 +19,19 @@ public:
 
     /**
      * @brief Initializes the TFT display object and clears the screen.
+     * @param keep_contents Skip the clear and idle-screen redraw. Used when waking from
+     *        deep sleep: the panel's frame memory survives sleep mode and resets.
      * @return true if initialization is successful, false otherwise.
      */
-    static bool setup_display();
+    static bool setup_display(bool keep_contents = false);
+
+    /**
+     * @brief Prepares the panel for the ESP32's deep sleep. With BATTERY_DISPLAY_ASLEEP it
+     *        stays on in idle mode and keeps showing the last frame (8 colours); otherwise it
+     *        goes to sleep mode (blank, frame memory retained) and the backlight is switched
+     *        off if TFT_BACKLIGHT is wired. Chip select and reset are held high either way.
+     */
+    static void sleep_panel();
 
     /**
      * @brief Clears the entire display area.
@@ -40,8 +50,48 @@ public:
      *        (Student ID, Request Text) in a designated area.
      * @param student_id The ID of the student making the request.
      * @param request_text The text of the consultation request.
+     * @param bitmap Optional text pre-rasterized by the central system (TextBitmapDecoder
+     *        format), drawn instead of request_text. Falls back to the text if invalid.
+     * @param bitmap_len Length of bitmap in bytes.
+     */
+    static void show_request(const char* student_id, const char* request_text,
+                             const uint8_t* bitmap = nullptr, size_t bitmap_len = 0);
+
+    /**
+     * @brief Time the last request body took to draw, in microseconds.
+     * @param bitmap true for the last rasterized body, false for the last glyph-rendered one.
+     */
+    static unsigned long last_request_draw_us(bool bitmap);
+
+    /**
+     * @brief Draws the directory board's title bar with the page indicator.
+     * @param page Zero-based page on screen.
+     * @param pages Total pages.
+     * @param count Faculty members on the board.
      */
-    static void show_request(const char* student_id, const char* request_text);
+    static void show_directory_header(uint8_t page, uint8_t pages, uint8_t count);
+
+    /**
+     * @brief Draws one directory board row, clearing only that row.
+     * @param slot Row position on the page (0 = first row under the header).
+     * @param name Faculty name or ID; nullptr leaves the row blank.
+     * @param status Status label drawn at the right.
+     * @param color Status label colour.
+     */
+    static void show_directory_row(uint8_t slot, const char* name, const char* status, uint16_t color);
+
+    /**
+     * @brief Draws a QOI asset from the asset store, centred in the given box.
+     *        The image is decoded one scanline at a time straight into an SPI
+     *        address window, so no frame buffer is needed.
+     * @param name Asset name (file ASSET_DIR/<name>.qoi).
+     * @param box_x Left edge of the box.
+     * @param box_y Top edge of the box.
+     * @param box_w Box width; larger images are not drawn.
+     * @param box_h Box height; larger images are not drawn.
+     * @return true if the asset was drawn.
+     */
+    static bool draw_asset(const char* name, int16_t box_x, int16_t box_y, int16_t box_w, int16_t box_h);
 
     /**
      * @brief Placeholder/Compatibility function. For ILI9341 with Adafruit_GFX,
@@ -50,8 +100,12 @@ public:
     static void update_display();
 
 private:
-    // Private members are not needed for this purely static utility class
-    // unless managing internal static state.
+    /**
+     * @brief Streams a rasterized text bitmap into an address window at (x, y),
+     *        white on black, one decoded row at a time.
+     * @return false if the bitmap is malformed or does not fit below y.
+     */
+    static bool draw_text_bitmap(const uint8_t* bitmap, size_t len, int16_t x, int16_t y);
 };
 
 // Function-based approach (alternative to class)
@@ -0,0 +1,204 @@
+#include "pixel_kernels.h"
+
+#if PIXEL_KERNELS_SIMD && defined(CONFIG_IDF_TARGET_ESP32S3)
+#define PIXEL_KERNELS_USE_PIE 1
+#else
+#define PIXEL_KERNELS_USE_PIE 0
+#endif
+
+// RGB565 with green moved to the upper half: 00000gggggg00000 rrrrr000000bbbbb.
+// Each channel has 5 spare bits above it, so one 32-bit multiply by a 0..32 weight
+// scales all three channels without carries between them.
+#define SPREAD_MASK 0x07E0F81FUL
+
+static inline uint32_t spread(uint16_t c) {
+    return (c | ((uint32_t)c << 16)) & SPREAD_MASK;
+}
+
+static inline uint16_t unspread(uint32_t x) {
+    x &= SPREAD_MASK;
+    return (uint16_t)(x | (x >> 16));
+}
+
+/**
+ * @brief Weighted average of two spread colours; `w` is fg's weight out of 32.
+ *        The >> 5 floors every channel in place, the mask drops the remainders.
+ */
+static inline uint16_t mix(uint32_t fg, uint32_t bg, uint32_t w) {
+    return unspread((fg * w + bg * (32 - w)) >> 5);
+}
+
+// Two pixels as one word. The buffers are uint16_t arrays, so word access goes through
+// a may_alias type; memcpy would not do, it only knows 2-byte alignment and Xtensa has
+// no unaligned loads.
+typedef uint32_t __attribute__((__may_alias__)) pixel_pair_t;
+
+// 4-bit level to a 0..32 weight (0 -> 0, 15 -> 32)
+static inline uint32_t coverage_weight(uint8_t c) {
+    return (c * 32 + 7) / 15;
+}
+
+#if PIXEL_KERNELS_USE_PIE
+// Both loops move 16-byte blocks; callers guarantee alignment and count > 0.
+
+static void pie_fill(uint16_t* dst, const uint16_t* color, size_t blocks) {
+    asm volatile(
+        "ee.vldbc.16    q0, %2\n"
+        "1:\n"
+        "ee.vst.128.ip  q0, %0, 16\n"
+        "addi           %1, %1, -1\n"
+        "bnez           %1, 1b\n"
+        : "+r"(dst), "+r"(blocks)
+        : "r"(color)
+        : "memory");
+}
+
+// 32 bytes per pass: unzip splits low and high bytes, zipping them back in the
+// other order swaps every pixel.
+static void pie_swap(uint16_t* dst, const uint16_t* src, size_t pairs) {
+    asm volatile(
+        "1:\n"
+        "ee.vld.128.ip  q0, %1, 16\n"
+        "ee.vld.128.ip  q1, %1, 16\n"
+        "ee.vunzip.8    q0, q1\n"
+        "ee.vzip.8      q1, q0\n"
+        "ee.vst.128.ip  q1, %0, 16\n"
+        "ee.vst.128.ip  q0, %0, 16\n"
+        "addi           %2, %2, -1\n"
+        "bnez           %2, 1b\n"
+        : "+r"(dst), "+r"(src), "+r"(pairs)
+        :
+        : "memory");
+}
+#endif
+
+void PixelKernels::fill_span(uint16_t* dst, uint16_t color, size_t count) {
+#if PIXEL_KERNELS_USE_PIE
+    while (count > 0 && ((uintptr_t)dst & 15) != 0) {
+        *dst++ = color;
+        count--;
+    }
+    if (count >= 8) {
+        size_t blocks = count / 8;
+        pie_fill(dst, &color, blocks);
+        dst += blocks * 8;
+        count -= blocks * 8;
+    }
+#else
+    if (count > 0 && ((uintptr_t)dst & 3) != 0) {
+        *dst++ = color;
+        count--;
+    }
+    uint32_t pair = color | ((uint32_t)color << 16);
+    pixel_pair_t* words = (pixel_pair_t*)dst;
+    for (size_t i = 0; i < count / 2; i++) {
+        words[i] = pair;
+    }
+    dst += count & ~(size_t)1;
+    count &= 1;
+#endif
+    while (count-- > 0) {
+        *dst++ = color;
+    }
+}
+
+void PixelKernels::swap_bytes(uint16_t* dst, const uint16_t* src, size_t count) {
+#if PIXEL_KERNELS_USE_PIE
+    if ((((uintptr_t)dst ^ (uintptr_t)src) & 15) == 0) {
+        while (count > 0 && ((uintptr_t)dst & 15) != 0) {
+            uint16_t v = *src++;
+            *dst++ = (v << 8) | (v >> 8);
+            count--;
+        }
+        if (count >= 16) {
+            size_t pairs = count / 16;
+            pie_swap(dst, src, pairs);
+            dst += pairs * 16;
+            src += pairs * 16;
+            count -= pairs * 16;
+        }
+    }
+#endif
+    if ((((uintptr_t)dst ^ (uintptr_t)src) & 3) == 0) {
+        if (count > 0 && ((uintptr_t)dst & 3) != 0) {
+            uint16_t v = *src++;
+            *dst++ = (v << 8) | (v >> 8);
+            count--;
+        }
+        const pixel_pair_t* in = (const pixel_pair_t*)src;
+        pixel_pair_t* out = (pixel_pair_t*)dst;
+        for (size_t i = 0; i < count / 2; i++) {
+            uint32_t v = in[i];
+            out[i] = ((v & 0x00ff00ffUL) << 8) | ((v >> 8) & 0x00ff00ffUL);
+        }
+        dst += count & ~(size_t)1;
+        src += count & ~(size_t)1;
+        count &= 1;
+    }
+    while (count-- > 0) {
+        uint16_t v = *src++;
+        *dst++ = (v << 8) | (v >> 8);
+    }
+}
+
+void PixelKernels::build_ramp(uint16_t* palette, uint16_t fg, uint16_t bg) {
+    uint32_t fg_spread = spread(fg);
+    uint32_t bg_spread = spread(bg);
+    for (uint8_t c = 0; c < 16; c++) {
+        palette[c] = mix(fg_spread, bg_spread, coverage_weight(c));
+    }
+}
+
+#if PIXEL_KERNELS_BENCH
+static uint16_t benchA[SCREEN_WIDTH + 8] __attribute__((aligned(16)));
+static uint16_t benchB[SCREEN_WIDTH + 8] __attribute__((aligned(16)));
+
+static void print_result(const __FlashStringHelper* name, uint32_t cycles, size_t pixels, bool ok) {
+    Serial.print(F("  "));
+    Serial.print(name);
+    Serial.print(F(": "));
+    Serial.print((float)cycles / pixels, 2);
+    Serial.print(F(" cycles/px"));
+    Serial.println(ok ? F("") : F("  MISMATCH"));
+}
+
+void PixelKernels::report_benchmark() {
+    const size_t n = SCREEN_WIDTH;
+    uint32_t seed = 0x1234567;
+    auto next = [&seed]() { seed = seed * 1664525UL + 1013904223UL; return (uint16_t)(seed >> 16); };
+
+    Serial.print(F("Pixel kernels ("));
+    Serial.print(PIXEL_KERNELS_USE_PIE ? F("PIE") : F("scalar"));
+    Serial.println(F("), one scanline, odd offsets checked:"));
+
+    // Offset 1 exercises the unaligned head and tail paths
+    bool ok = true;
+    uint32_t start = ESP.getCycleCount();
+    fill_span(benchA, 0xF81F, n);
+    uint32_t cycles = ESP.getCycleCount() - start;
+    fill_span(benchB + 1, 0x07E0, n - 3);
+    for (size_t i = 0; i < n; i++) {
+        ok &= benchA[i] == 0xF81F;
+    }
+    for (size_t i = 1; i < n - 2; i++) {
+        ok &= benchB[i] == 0x07E0;
+    }
+    print_result(F("fill_span"), cycles, n, ok);
+
+    for (size_t i = 0; i < n + 8; i++) {
+        benchA[i] = next();
+    }
+    ok = true;
+    start = ESP.getCycleCount();
+    swap_bytes(benchB, benchA, n);
+    cycles = ESP.getCycleCount() - start;
+    for (size_t i = 0; i < n; i++) {
+        ok &= benchB[i] == (uint16_t)((benchA[i] << 8) | (benchA[i] >> 8));
+    }
+    swap_bytes(benchB + 1, benchA + 1, n - 3);
+    for (size_t i = 1; i < n - 2; i++) {
+        ok &= benchB[i] == (uint16_t)((benchA[i] << 8) | (benchA[i] >> 8));
+    }
+    print_result(F("swap_bytes"), cycles, n, ok);
+}
+#endif
@@ -0,0 +1,44 @@
+#ifndef PIXEL_KERNELS_H
+#define PIXEL_KERNELS_H
+
+#include <Arduino.h>
+#include "../config/config.h"
+
+/**
+ * @brief Static RGB565 span kernels used by the display code.
+ *
+ * On the ESP32-S3 (with PIXEL_KERNELS_SIMD) fill_span and swap_bytes use the PIE
+ * 128-bit vector unit for the 16-byte aligned middle of a span, with scalar head and
+ * tail loops. The portable versions work a 32-bit word (two pixels) at a time;
+ * tools/pixel_kernels_test.cpp checks them against per-pixel references on the host.
+ */
+class PixelKernels {
+public:
+    /**
+     * @brief Sets `count` pixels to `color` (native byte order).
+     */
+    static void fill_span(uint16_t* dst, uint16_t color, size_t count);
+
+    /**
+     * @brief Swaps each pixel's bytes into the panel's big-endian SPI order.
+     *        `dst` may equal `src`.
+     */
+    static void swap_bytes(uint16_t* dst, const uint16_t* src, size_t count);
+
+    /**
+     * @brief Fills a 16-entry palette with the blend ramp from `bg` (index 0) to
+     *        `fg` (index 15): each channel is mixed with weight round(index * 32 / 15) / 32
+     *        and floored. Grey levels of rasterized text are picked from it.
+     */
+    static void build_ramp(uint16_t* palette, uint16_t fg, uint16_t bg);
+
+#if PIXEL_KERNELS_BENCH
+    /**
+     * @brief Checks every kernel against a plain per-pixel reference and prints
+     *        cycles per pixel for each one. Call once from setup().
+     */
+    static void report_benchmark();
+#endif
+};
+
+#endif // PIXEL_KERNELS_H
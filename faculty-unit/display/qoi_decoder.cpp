@@ -0,0 +1,142 @@
+#include "qoi_decoder.h"
+
+// QOI chunk tags (https://qoiformat.org/qoi-specification.pdf)
+#define QOI_OP_INDEX 0x00
+#define QOI_OP_DIFF  0x40
+#define QOI_OP_LUMA  0x80
+#define QOI_OP_RUN   0xc0
+#define QOI_OP_RGB   0xfe
+#define QOI_OP_RGBA  0xff
+#define QOI_MASK_2   0xc0
+
+// Constructor
+QoiDecoder::QoiDecoder()
+    : src(nullptr), img_width(0), img_height(0), rows_left(0), run(0), buf_len(0), buf_pos(0) {
+    memset(index, 0, sizeof(index));
+    prev = {0, 0, 0, 255};
+}
+
+/**
+ * @brief Returns the next byte of the stream, refilling the small read buffer as needed.
+ * @return The byte, or -1 at end of stream.
+ */
+int QoiDecoder::next_byte() {
+    if (buf_pos == buf_len) {
+        buf_len = src->readBytes(buf, sizeof(buf));
+        buf_pos = 0;
+        if (buf_len == 0) {
+            return -1;
+        }
+    }
+    return buf[buf_pos++];
+}
+
+/**
+ * @brief Reads "qoif", big-endian width/height, channels and colourspace.
+ *        Images larger than the panel are rejected.
+ */
+bool QoiDecoder::begin(Stream& stream) {
+    src = &stream;
+    buf_len = buf_pos = 0;
+    run = 0;
+    memset(index, 0, sizeof(index));
+    prev = {0, 0, 0, 255};
+
+    uint8_t header[14];
+    for (int i = 0; i < 14; i++) {
+        int b = next_byte();
+        if (b < 0) {
+            return false;
+        }
+        header[i] = (uint8_t)b;
+    }
+    if (memcmp(header, "qoif", 4) != 0) {
+        return false;
+    }
+
+    uint32_t w = ((uint32_t)header[4] << 24) | ((uint32_t)header[5] << 16) | ((uint32_t)header[6] << 8) | header[7];
+    uint32_t h = ((uint32_t)header[8] << 24) | ((uint32_t)header[9] << 16) | ((uint32_t)header[10] << 8) | header[11];
+    if (w == 0 || h == 0 || w > SCREEN_WIDTH || h > SCREEN_HEIGHT) {
+        return false;
+    }
+    img_width = (uint16_t)w;
+    img_height = (uint16_t)h;
+    rows_left = img_height;
+    return true;
+}
+
+/**
+ * @brief Decodes one pixel, following the QOI chunk rules.
+ */
+bool QoiDecoder::next_pixel(Rgba& px) {
+    if (run > 0) {
+        run--;
+        px = prev;
+        return true;
+    }
+
+    int b1 = next_byte();
+    if (b1 < 0) {
+        return false;
+    }
+
+    if (b1 == QOI_OP_RGB || b1 == QOI_OP_RGBA) {
+        int r = next_byte(), g = next_byte(), b = next_byte();
+        int a = (b1 == QOI_OP_RGBA) ? next_byte() : prev.a;
+        if (r < 0 || g < 0 || b < 0 || a < 0) {
+            return false;
+        }
+        prev = {(uint8_t)r, (uint8_t)g, (uint8_t)b, (uint8_t)a};
+    } else {
+        switch (b1 & QOI_MASK_2) {
+        case QOI_OP_INDEX:
+            prev = index[b1];
+            break;
+        case QOI_OP_DIFF:
+            prev.r += ((b1 >> 4) & 0x03) - 2;
+            prev.g += ((b1 >> 2) & 0x03) - 2;
+            prev.b += (b1 & 0x03) - 2;
+            break;
+        case QOI_OP_LUMA: {
+            int b2 = next_byte();
+            if (b2 < 0) {
+                return false;
+            }
+            int vg = (b1 & 0x3f) - 32;
+            prev.r += vg - 8 + ((b2 >> 4) & 0x0f);
+            prev.g += vg;
+            prev.b += vg - 8 + (b2 & 0x0f);
+            break;
+        }
+        case QOI_OP_RUN:
+            run = b1 & 0x3f; // Stored as run - 1; this pixel is the first of the run
+            break;
+        }
+    }
+
+    index[(prev.r * 3 + prev.g * 5 + prev.b * 7 + prev.a * 11) % 64] = prev;
+    px = prev;
+    return true;
+}
+
+/**
+ * @brief Decodes width() pixels into RGB565.
+ */
+bool QoiDecoder::read_row(uint16_t* out) {
+    if (src == nullptr || rows_left == 0) {
+        return false;
+    }
+
+    Rgba px;
+    for (uint16_t x = 0; x < img_width; x++) {
+        if (!next_pixel(px)) {
+            return false;
+        }
+        uint8_t r = (px.r * px.a) / 255;
+        uint8_t g = (px.g * px.a) / 255;
+        uint8_t b = (px.b * px.a) / 255;
+        out[x] = ((r & 0xf8) << 8) | ((g & 0xfc) << 3) | (b >> 3);
+    }
+    rows_left--;
+    return true;
+}
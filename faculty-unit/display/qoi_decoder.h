@@ -0,0 +1,53 @@
+#ifndef QOI_DECODER_H
+#define QOI_DECODER_H
+
+#include <Arduino.h>
+#include "../config/config.h" // For SCREEN_WIDTH / SCREEN_HEIGHT
+
+/**
+ * @brief Streaming decoder for QOI ("Quite OK Image") files.
+ *        Pixels are produced one scanline at a time as RGB565, so an image can be
+ *        pushed into a TFT address window without holding a full frame in RAM.
+ *        State is the 64-entry colour index plus a small read buffer (~330 bytes).
+ */
+class QoiDecoder {
+public:
+    QoiDecoder();
+
+    /**
+     * @brief Reads and validates the 14-byte QOI header.
+     * @param src Byte source (e.g. a LittleFS File), positioned at the start of the image.
+     * @return true if the header is valid.
+     */
+    bool begin(Stream& src);
+
+    uint16_t width() const { return img_width; }
+    uint16_t height() const { return img_height; }
+
+    /**
+     * @brief Decodes the next scanline.
+     *        Alpha is blended over black, since the panel has no transparency.
+     * @param out Receives width() RGB565 pixels.
+     * @return false if the data ended early or all rows were already read.
+     */
+    bool read_row(uint16_t* out);
+
+private:
+    struct Rgba { uint8_t r, g, b, a; };
+
+    int next_byte();
+    bool next_pixel(Rgba& px);
+
+    Stream* src;
+    uint16_t img_width;
+    uint16_t img_height;
+    uint16_t rows_left;
+    Rgba index[64]; ///< Previously seen colours, addressed by QOI hash.
+    Rgba prev;      ///< Last decoded pixel.
+    uint8_t run;    ///< Remaining repeats of prev from a QOI_OP_RUN.
+    uint8_t buf[64];
+    uint8_t buf_len;
+    uint8_t buf_pos;
+};
+
+#endif // QOI_DECODER_H
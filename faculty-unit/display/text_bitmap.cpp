@@ -0,0 +1,57 @@
+#include "text_bitmap.h"
+#include "pixel_kernels.h" // Run fills
+
+TextBitmapDecoder::TextBitmapDecoder()
+    : p(nullptr), end(nullptr), img_width(0), img_height(0), rows_left(0), bpp(1), level(0), run(0) {}
+
+bool TextBitmapDecoder::begin(const uint8_t* data, size_t len) {
+    if (data == nullptr || len < 5 || (data[0] != 1 && data[0] != 2)) {
+        return false;
+    }
+    bpp = data[0];
+    img_width = data[1] | (data[2] << 8);
+    img_height = data[3] | (data[4] << 8);
+    if (img_width == 0 || img_width > SCREEN_WIDTH || img_height == 0 || img_height > SCREEN_HEIGHT) {
+        return false;
+    }
+    p = data + 5;
+    end = data + len;
+
+    // The runs are short enough to check up front, so a bad bitmap is never half drawn
+    const uint8_t len_mask = (1 << (8 - bpp)) - 1;
+    uint32_t pixels = 0;
+    for (const uint8_t* q = p; q < end; q++) {
+        pixels += (*q & len_mask) + 1;
+    }
+    if (pixels != (uint32_t)img_width * img_height) {
+        return false;
+    }
+    rows_left = img_height;
+    run = 0;
+    return true;
+}
+
+bool TextBitmapDecoder::read_row(uint16_t* out, const uint16_t* palette) {
+    if (rows_left == 0) {
+        return false;
+    }
+    const uint8_t shift = 8 - bpp;
+    const uint8_t len_mask = (1 << shift) - 1;
+    uint16_t x = 0;
+    while (x < img_width) {
+        if (run == 0) {
+            if (p == end) {
+                return false;
+            }
+            uint8_t b = *p++;
+            level = b >> shift;
+            run = (b & len_mask) + 1;
+        }
+        uint16_t n = img_width - x < run ? img_width - x : run;
+        PixelKernels::fill_span(out + x, palette[level], n);
+        x += n;
+        run -= n;
+    }
+    rows_left--;
+    return true;
+}
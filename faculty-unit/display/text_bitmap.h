@@ -0,0 +1,50 @@
+#ifndef TEXT_BITMAP_H
+#define TEXT_BITMAP_H
+
+#include <Arduino.h>
+#include "../config/config.h" // For SCREEN_WIDTH / SCREEN_HEIGHT
+
+/**
+ * @brief Streaming decoder for request text rasterized by the central system
+ *        (central-system/comms/text_raster.py).
+ *
+ * Layout: 1 byte bits per pixel (1 or 2), width and height as little-endian
+ * uint16, then run-length bytes in row-major order. A run byte holds the level in
+ * its top `bpp` bits and (length - 1) in the rest, so a 1-bit run covers 1-128
+ * pixels and a 2-bit run 1-64. Runs may continue onto the next row.
+ */
+class TextBitmapDecoder {
+public:
+    TextBitmapDecoder();
+
+    /**
+     * @brief Validates the header. The data must stay valid while rows are read.
+     * @return true if the header is valid, the bitmap fits the panel and the runs
+     *         cover exactly width x height pixels.
+     */
+    bool begin(const uint8_t* data, size_t len);
+
+    uint16_t width() const { return img_width; }
+    uint16_t height() const { return img_height; }
+    uint8_t levels() const { return 1 << bpp; }
+
+    /**
+     * @brief Decodes the next row, filling each run with PixelKernels::fill_span().
+     * @param out Receives width() pixels.
+     * @param palette levels() colours, indexed by level (already in the byte order wanted in out).
+     * @return false if the runs ended early or all rows were already read.
+     */
+    bool read_row(uint16_t* out, const uint16_t* palette);
+
+private:
+    const uint8_t* p;
+    const uint8_t* end;
+    uint16_t img_width;
+    uint16_t img_height;
+    uint16_t rows_left;
+    uint8_t bpp;
+    uint8_t level; ///< Level of the current run.
+    uint8_t run;   ///< Pixels left in the current run.
+};
+
+#endif // TEXT_BITMAP_H
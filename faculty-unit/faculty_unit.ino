@@ -8,8 +8,25 @@
 #include <ArduinoJson.h> // Keep for JSON handling in callbacks
 #include "config.h"       // Include project configuration
 #include "comms/mqtt_handler.h" // Include our MQTT handler
+#include "comms/debug_server.h"  // /metrics and /events over HTTP
+#include "comms/command_rpc.h"   // Batched remote commands with results
+#include "comms/request_bitmaps.h" // Pre-rasterized request text
+#include "comms/status_multicast.h" // LAN status datagrams (sender)
+#include "comms/status_receiver.h"  // LAN status datagrams (directory board)
+#include "comms/rtdb_writer.h"      // Firebase RTDB writes over a kept-alive connection
 #include "ble/ble_scanner.h"    // Include our BLE Scanner
+#include "ble/status_advertiser.h" // Status broadcast for nearby phones
 #include "display/display_manager.h" // Include our Display Manager
+#include "display/pixel_kernels.h"   // RGB565 span kernels (boot benchmark)
+#include "display/directory_board.h" // Hallway board (UNIT_ROLE_DIRECTORY)
+#include "core/event_bus.h"          // In-process publish/subscribe between modules
+#include "core/heap_guard.h"         // Steady-state heap allocation detection
+#include "core/message_arena.h"      // Per-message scratch memory
+#include "core/coro_scheduler.h"     // Cooperative coroutine flows (reconnect, buttons, scanning)
+#include "core/timer_wheel.h"        // All timeouts; loop() sleeps until the next one
+#include "core/warm_restart.h"       // State snapshot surviving watchdog/OTA restarts
+#include "core/power_manager.h"      // Deep-sleep cycling for the battery build
+#include "core/unit_log.h"           // Sampled logging, streamed to MQTT in batches
 #include <Firebase_ESP_Client.h>
 
 // Include Firebase auth helper
@@ -52,18 +69,32 @@ const int BTN_AWAY = 25;
 // Global objects
 // WiFiClient espClient; // Now managed by mqtt_handler.cpp
 // PubSubClient mqtt(espClient); // Now managed by mqtt_handler.cpp
-FirebaseData fbdo;
 FirebaseAuth auth;
 FirebaseConfig config;
 BLEScanner bleScanner; // Instance of our BLE Scanner
 // DisplayManager displayManager; // Instance removed - using static methods
 
 // Status variables
-String currentStatus = "offline"; // Tracks the *manual* status set by buttons or remote MQTT command (available, busy, away)
+char currentStatus[MANUAL_STATUS_LEN] = "offline"; // Tracks the *manual* status set by buttons or remote MQTT command (available, busy, away)
 unsigned long lastStatusUpdate = 0; // Timestamp for general updates (less used now)
-bool firebaseConnected = false;
 // bool mqttConnected = false; // Connection status managed internally by mqtt_handler
-String last_published_status = "Unknown"; // Tracks the last *BLE presence* status published ("Present", "Unavailable")
+int last_published_presence = -1; // Tracks the last *BLE presence* published (1 = "Present", 0 = "Unavailable", -1 = none yet)
+uint32_t handledPresenceGeneration = 0;   // bleScanner.presence() generation last announced
+uint32_t statusGeneration = 0;            // Bumped whenever currentStatus changes
+uint32_t announcedStatusGeneration = 0;   // statusGeneration last published as EVENT_STATUS_CHANGED
+uint32_t broadcastPresenceGeneration = 0; // Inputs of the last BLE status advertisement
+uint32_t broadcastStatusGeneration = 0;
+int broadcastDepth = -1;
+unsigned long idleLoopPasses = 0;         // Passes in which no presence, status or inbox change was seen
+
+// Status message buffers, sized from the budgets in config.h (no heap use after setup)
+StaticJsonDocument<JSON_STATUS_DOC_SIZE> statusDoc;
+char statusPayload[STATUS_PAYLOAD_LEN];
+char firebaseStatusPath[FIREBASE_PATH_LEN];
+
+#if UNIT_ROLE == UNIT_ROLE_DIRECTORY && DIRECTORY_MULTICAST
+StatusReceiver statusReceiver; // Joined once WiFi is up
+#endif
 
 // BLE Scanner - Replaced by BLEScanner class instance
 // NimBLEScan* pBLEScan = nullptr;
@@ -73,23 +104,72 @@ String last_published_status = "Unknown"; // Tracks the last *BLE presence* stat
 // void setupWiFi(); // Now handled by mqtt_handler
 // void setupMQTT(); // Now handled by mqtt_handler
 void setupFirebase();
+void writeFirebaseStatus(const char* status);
+bool firebaseToken(char* out, size_t out_size);
 // void setupBLE(); // Replaced by bleScanner.setup_ble()
 // void setupDisplay(); // Now handled by displayManager.setup_display()
 void setupLEDs();
 void setupButtons();
 // void reconnectMQTT(); // Now handled by mqtt_handler
 void mqtt_message_callback(char* topic, byte* payload, unsigned int length); // Renamed callback
-void updateStatus(String newStatus);
+void updateStatus(const char* newStatus);
+bool announcePresence(bool present);
+bool announceStatus();
 // void scanForBeacons(); // Replaced by bleScanner.scan() and bleScanner.is_present()
 // void updateDisplay(); // Now handled by displayManager methods in loop()
-void checkButtons();
+CoTask buttonFlow(int pin, const char* status);
+CoTask bleScanFlow();
 void publishStatus();
+void setupEventHandlers();
+void setStatusLeds(const char* status);
+void gatherWarmState(WarmSnapshot& out);
+void applyWarmState(const WarmSnapshot& state);
+bool batteryCycleDone();
+void enterDeepSleep();
+void renderUnitMetrics(MetricsWriter& out);
+#if UNIT_ROLE == UNIT_ROLE_DIRECTORY && DIRECTORY_MULTICAST
+void serviceStatusMulticast();
+#endif
+const char* commandStatusUpdate(JsonObjectConst args, JsonObject result);
+const char* commandDisplayUpdate(JsonObjectConst args, JsonObject result);
+const char* commandSetStatus(JsonObjectConst args, JsonObject result);
+
+// Remote commands, looked up by name hash (see CommandRpc)
+constexpr CommandEntry commandTable[] = {
+  {"status_update", commandStatusUpdate},
+  {"display_update", commandDisplayUpdate},
+  {"set_status", commandSetStatus},
+};
+static_assert(command_hashes_unique(commandTable), "Command names must hash uniquely");
 
 void setup() {
   // Initialize serial
   Serial.begin(SERIAL_BAUD_RATE); // Use constant from config.h
   Serial.println("\nConsultEase Faculty Unit Starting...");
 
+  // Checked before anything overwrites it; applied once the modules are up
+  const WarmSnapshot* warm = WarmRestart::restore();
+
+#if POWER_MODE == POWER_MODE_BATTERY
+  // Find out whether a button press (seen by the ULP) woke us, before reconfiguring the pins
+  const int buttonPins[] = {BTN_AVAILABLE, BTN_BUSY, BTN_AWAY};
+  PowerManager::begin(buttonPins, 3);
+  PowerManager::report_energy_budget();
+#endif
+
+#if PIXEL_KERNELS_BENCH
+  PixelKernels::report_benchmark();
+#endif
+
+  // Timer wheel and event bus first so modules can use them during their own setup
+  TimerWheel::init();
+  EventBus::setup_bus();
+  setupEventHandlers();
+
+#if CORO_SCHEDULER_BENCH
+  CoScheduler::report_benchmark(); // Before any flow is spawned; needs the timer wheel
+#endif
+
   // Setup hardware
   setupLEDs();
   setupButtons();
@@ -99,26 +179,72 @@ void setup() {
   set_faculty_id(FACULTY_ID); // Use FACULTY_ID from config.h for the MQTT handler
   setup_wifi();               // Call MQTT handler's WiFi setup
   setup_mqtt(mqtt_message_callback); // Call MQTT handler's MQTT setup, pass callback
+  UnitLog::begin(publish_log_frame, log_sink_ready);  // Boot records are kept and sent once MQTT connects
+  CommandRpc::begin(FACULTY_ID, commandTable, sizeof(commandTable) / sizeof(commandTable[0]));
+#if DEBUG_HTTP_ENABLED && POWER_MODE == POWER_MODE_MAINS
+  DebugServer::begin(renderUnitMetrics); // Battery units are asleep most of the time; no server
+#endif
+
+#if UNIT_ROLE == UNIT_ROLE_DIRECTORY
+  // Hallway board: no beacon, buttons or status of its own, just every faculty's status
+  CoScheduler::spawn(mqtt_reconnect_flow());
+  if (!DisplayManager::setup_display()) {
+    Serial.println("FATAL: Display setup failed. Halting.");
+    while(1) { delay(1000); } // Stop execution
+  }
+  DirectoryBoard::begin();
+  Serial.println("Setup complete (directory board)");
+  HeapGuard::begin_steady_state();
+  return;
+#endif
+
     setupFirebase();
     bleScanner.setup_ble(); // Initialize our BLE scanner
+#if BLE_STATUS_ADVERTISING
+    StatusAdvertiser::begin(); // Shares the BLE stack set up by the scanner
+#endif
+#if STATUS_MULTICAST_ENABLED
+    StatusMulticast::begin(FACULTY_ID);
+#endif
+
+    // Long-running flows, interleaved by the coroutine scheduler in loop()
+    CoScheduler::spawn(mqtt_reconnect_flow());
+    CoScheduler::spawn(bleScanFlow());
+    CoScheduler::spawn(buttonFlow(BTN_AVAILABLE, "available"));
+    CoScheduler::spawn(buttonFlow(BTN_BUSY, "busy"));
+    CoScheduler::spawn(buttonFlow(BTN_AWAY, "away"));
 
     // Initialize Display using static method
-    if (!DisplayManager::setup_display()) {
+    // After deep sleep the panel still shows the last frame; don't redraw it
+    if (!DisplayManager::setup_display(POWER_MODE == POWER_MODE_BATTERY && warm != nullptr)) {
         Serial.println("FATAL: Display setup failed. Halting.");
         while(1) { delay(1000); } // Stop execution
     }
   
-    // Initial status update (for LEDs/MQTT, display handled separately in loop)
-    updateStatus("available");
+    if (warm != nullptr) {
+      // Resume without republishing: the broker still holds the retained status and presence
+      applyWarmState(*warm);
+    } else {
+      // Initial status update (for LEDs/MQTT, display handled separately in loop)
+      updateStatus("available");
+    }
+    WarmRestart::begin(gatherWarmState);
+
+#if POWER_MODE == POWER_MODE_BATTERY
+    int wakeButton = PowerManager::wake_button();
+    if (wakeButton == BTN_AVAILABLE) {
+      updateStatus("available");
+    } else if (wakeButton == BTN_BUSY) {
+      updateStatus("busy");
+    } else if (wakeButton == BTN_AWAY) {
+      updateStatus("away");
+    }
+#endif
   
   Serial.println("Setup complete");
+  HeapGuard::begin_steady_state(); // Every allocation on the loop task from here on is reported
 }
 
-// Define BLE scan timing variables
-unsigned long lastBleScanTime = 0;
-// Scan slightly more often than the scan duration to avoid missing beacons
-const unsigned long BLE_SCAN_INTERVAL_MS = (BLE_SCAN_DURATION * 1000) + 1000;
-
 void loop() {
   // Check WiFi connection (Handled by mqtt_handler_loop now)
   // if (WiFi.status() != WL_CONNECTED) {
@@ -126,50 +252,71 @@ void loop() {
   //   setup_wifi(); // Should call the handler's setup
   // }
 
-  // MQTT connection and message processing is handled by the handler's loop function
+  // Run every timer that came due while the loop slept
+  unsigned long passStartUs = micros();
+  TimerWheel::advance();
+
+  // MQTT message processing is handled by the handler's loop function
   mqtt_handler_loop();
 
-  // Check buttons for status changes
-  checkButtons();
+  // Resume coroutine flows: MQTT reconnect, button debouncing, BLE scanning
+  CoScheduler::run_ready();
+
+#if UNIT_ROLE == UNIT_ROLE_DIRECTORY
+#if DIRECTORY_MULTICAST
+  serviceStatusMulticast(); // Same-subnet units, without the broker hop
+#endif
+  DirectoryBoard::service(); // Draws changed rows once a burst of status messages settles
+  HeapGuard::check();
+  UnitLog::service();
+#if DEBUG_HTTP_ENABLED
+  DebugServer::service();
+  DebugServer::record_loop_pass(micros() - passStartUs);
+#endif
+  TimerWheel::sleep_until_next_deadline();
+  return;
+#endif
 
   // --- BLE Presence Check & MQTT Publish ---
-  unsigned long currentMillis = millis();
-
-  // Periodically trigger a BLE scan
-  if (currentMillis - lastBleScanTime >= BLE_SCAN_INTERVAL_MS || lastBleScanTime == 0) { // Scan immediately on first loop
-      Serial.println("Triggering BLE Scan...");
-      bleScanner.scan(); // Perform the scan (non-blocking)
-      lastBleScanTime = currentMillis;
-      // Scan is triggered, is_present() below will use latest scan results or timeout logic
+  // The scanner bumps the snapshot's generation only when presence flips, so an
+  // unchanged generation means there is nothing to announce
+  const PresenceSnapshot& presence = bleScanner.presence();
+  if (presence.generation != handledPresenceGeneration && announcePresence(presence.present)) {
+      handledPresenceGeneration = presence.generation; // Retried next pass if the event pool was empty
   }
-
-  // Check current presence status (can be checked anytime)
-  bool present = bleScanner.is_present();
-  String current_status_string = present ? "Present" : "Unavailable";
-
-  // Check if status has changed since last publish
-  if (current_status_string != last_published_status) {
-      Serial.print("Presence status changed to: ");
-      Serial.println(current_status_string);
-
-      // Construct the specific MQTT topic
-      char topic_buffer[100]; // Ensure buffer is large enough
-      snprintf(topic_buffer, sizeof(topic_buffer), MQTT_STATUS_TOPIC_TEMPLATE, FACULTY_ID);
-
-      // Publish the new status as a retained message
-      Serial.print("Publishing presence status to topic: ");
-      Serial.println(topic_buffer);
-      publish_message(topic_buffer, current_status_string.c_str(), true); // Publish "Present" or "Unavailable"
-
-      // Update the tracking variable
-      last_published_status = current_status_string;
+  if (statusGeneration != announcedStatusGeneration && announceStatus()) {
+      announcedStatusGeneration = statusGeneration; // Likewise; only the latest status is published
   }
 
-  // --- Display Update ---
-  // The display primarily shows the faculty's *presence* based on BLE detection.
-  // MQTT status updates reflect both BLE presence and manual button status on different topics/payloads.
-  DisplayManager::show_status(current_status_string.c_str()); // Show "Present" or "Unavailable" based on BLE
-  // DisplayManager::update_display(); // No longer needed for ILI9341
+  // Run handlers for everything published since the last pass
+  EventBus::dispatch(EVENT_TASK_LOOP);
+
+  uint16_t depth = pending_request_count();
+  if (presence.generation != broadcastPresenceGeneration || statusGeneration != broadcastStatusGeneration ||
+      depth != broadcastDepth) {
+      broadcastPresenceGeneration = presence.generation;
+      broadcastStatusGeneration = statusGeneration;
+      broadcastDepth = depth;
+#if BLE_STATUS_ADVERTISING
+      StatusAdvertiser::update(presence.present, currentStatus, depth);
+#endif
+  } else {
+      idleLoopPasses++;
+  }
+#if STATUS_MULTICAST_ENABLED
+  // Every pass: besides changes, it sends the heartbeat and the first datagram once WiFi is up
+  StatusMulticast::update(presence.present, currentStatus, depth);
+#endif
+
+  WarmRestart::checkpoint();
+  HeapGuard::check();
+  UnitLog::service(); // Batched log frames, and backfill after a reconnect
+
+#if POWER_MODE == POWER_MODE_BATTERY
+  if (batteryCycleDone()) {
+    enterDeepSleep(); // Does not return; the next cycle starts in setup()
+  }
+#endif
 
   // Remove old periodic display update logic
   // if (currentMillis - lastStatusUpdate > 5000) {
@@ -177,8 +324,256 @@ void loop() {
   //   lastStatusUpdate = currentMillis;
   // }
   
-  // Small delay to prevent CPU hogging
-  delay(100);
+#if DEBUG_HTTP_ENABLED && POWER_MODE == POWER_MODE_MAINS
+  DebugServer::service();
+  DebugServer::record_loop_pass(micros() - passStartUs);
+#endif
+
+  // Sleep until the next timer is due, or until another task publishes or signals
+  TimerWheel::sleep_until_next_deadline();
+}
+
+/**
+ * @brief Publishes EVENT_PRESENCE_CHANGED if presence differs from what was last published;
+ *        MQTT publishing and the display subscribe to the event.
+ * @return false if the event pool was empty (try again next pass).
+ */
+bool announcePresence(bool present) {
+  if ((int)present == last_published_presence) {
+    return true; // E.g. restored by a warm restart, already published before it
+  }
+  ULOG(ULOG_INFO, "Presence status changed to: %s", present ? "Present" : "Unavailable");
+
+  Event* event = EventBus::acquire(EVENT_PRESENCE_CHANGED);
+  if (event == nullptr) {
+    return false;
+  }
+  event->presence.present = present;
+  EventBus::publish(event);
+  last_published_presence = present;
+  WarmRestart::mark_dirty();
+  return true;
+}
+
+/**
+ * @brief Publishes the BLE presence ("Present"/"Unavailable") as a retained status message.
+ */
+void onPresencePublish(const Event& event) {
+  const char* presence = event.presence.present ? "Present" : "Unavailable";
+
+  // Construct the specific MQTT topic
+  char topic_buffer[100]; // Ensure buffer is large enough
+  snprintf(topic_buffer, sizeof(topic_buffer), MQTT_STATUS_TOPIC_TEMPLATE, FACULTY_ID);
+
+  ULOG(ULOG_DEBUG, "Publishing presence status to topic: %s", topic_buffer);
+  publish_message(topic_buffer, presence, true);
+}
+
+/**
+ * @brief The display primarily shows the faculty's *presence* based on BLE detection.
+ */
+void onPresenceDisplay(const Event& event) {
+  DisplayManager::show_status(event.presence.present ? "Present" : "Unavailable");
+}
+
+void onRequestDisplay(const Event& event) {
+  size_t bitmap_len = 0;
+  const uint8_t* bitmap = RequestBitmaps::data(event.request.bitmap, &bitmap_len);
+  unsigned long drawStartMs = millis();
+  unsigned long drawStartUs = micros();
+  DisplayManager::show_request(event.request.student_id, event.request.request_text, bitmap, bitmap_len);
+  publish_request_trace(event.request, drawStartMs, micros() - drawStartUs);
+}
+
+/**
+ * @brief Updates the status LEDs for a manual status change.
+ */
+void onStatusLeds(const Event& event) {
+  setStatusLeds(event.status.status);
+}
+
+void setStatusLeds(const char* status) {
+  digitalWrite(LED_AVAILABLE, strcmp(status, "available") == 0 ? HIGH : LOW);
+  digitalWrite(LED_BUSY, strcmp(status, "busy") == 0 ? HIGH : LOW);
+  digitalWrite(LED_AWAY, strcmp(status, "away") == 0 ? HIGH : LOW);
+}
+
+/**
+ * @brief Fills a warm-restart snapshot from the live modules (WarmRestart::checkpoint()).
+ */
+void gatherWarmState(WarmSnapshot& out) {
+  strncpy(out.status, currentStatus, sizeof(out.status) - 1);
+  out.status[sizeof(out.status) - 1] = '\0';
+  out.presence = last_published_presence;
+  out.presence_deadline_us = bleScanner.presence_deadline();
+  out.adv_interval_ms = bleScanner.estimator().interval_ms();
+  out.adv_loss = bleScanner.estimator().loss_rate();
+  out.inbox_count = snapshot_pending_requests(out.inbox, INBOX_CAPACITY);
+  out.request_shown = snapshot_shown_request(out.shown);
+}
+
+/**
+ * @brief A battery wake cycle is done once the beacon has been scanned, presence published,
+ *        and MQTT has been up long enough to deliver requests queued while asleep and all of
+ *        them have been drawn. BATTERY_AWAKE_MAX_MS bounds the cycle if any of that stalls.
+ */
+bool batteryCycleDone() {
+  if (millis() >= BATTERY_AWAKE_MAX_MS) {
+    return true;
+  }
+  return bleScanner.scans_completed() > 0 &&
+         (int)bleScanner.is_present() == last_published_presence &&
+         mqtt_connected_ms() >= BATTERY_MQTT_LINGER_MS &&
+         pending_request_count() == 0;
+}
+
+/**
+ * @brief Saves state, turns off the LEDs, puts the panel to sleep and deep-sleeps until the
+ *        next cycle or a button press.
+ */
+void enterDeepSleep() {
+  EventBus::dispatch(EVENT_TASK_LOOP); // Finish drawing and publishing anything pending
+  UnitLog::flush();                    // The log ring does not survive deep sleep
+  WarmRestart::mark_dirty();
+  WarmRestart::checkpoint();
+  setStatusLeds("");
+  DisplayManager::sleep_panel();
+  PowerManager::deep_sleep(BATTERY_WAKE_INTERVAL_MS);
+}
+
+/**
+ * @brief Restores state after a warm restart. Local outputs (LEDs, display) are refreshed
+ *        directly; nothing is published, so subscribers see no spurious transitions.
+ */
+void applyWarmState(const WarmSnapshot& state) {
+  strncpy(currentStatus, state.status, sizeof(currentStatus) - 1);
+  currentStatus[sizeof(currentStatus) - 1] = '\0';
+  statusGeneration++;
+  announcedStatusGeneration = statusGeneration; // Already published before the restart
+  setStatusLeds(currentStatus);
+
+  last_published_presence = state.presence;
+  bleScanner.restore_presence(state.presence == 1, state.presence_deadline_us,
+                              state.adv_interval_ms, state.adv_loss);
+  if (state.presence >= 0) {
+    DisplayManager::show_status(state.presence == 1 ? "Present" : "Unavailable");
+  }
+  if (state.request_shown) {
+    DisplayManager::show_request(state.shown.student_id, state.shown.request_text); // Bitmaps are not kept
+    restore_shown_request(state.shown);
+  }
+
+  restore_pending_requests(state.inbox, state.inbox_count);
+}
+
+/**
+ * @brief Firmware metrics for the debug server's /metrics endpoint (loop task).
+ */
+void renderUnitMetrics(MetricsWriter& out) {
+  out.gauge("unit_heap_free_bytes", ESP.getFreeHeap());
+  out.gauge("unit_heap_min_free_bytes", ESP.getMinFreeHeap());
+  out.gauge("unit_heap_largest_block_bytes", ESP.getMaxAllocHeap());
+  out.counter("unit_heap_steady_allocations_total", HeapGuard::steady_state_allocations());
+  out.gauge("unit_heap_growth_bytes", HeapGuard::heap_growth_bytes());
+  out.counter("unit_coro_resumes_total", CoScheduler::resume_count());
+  out.counter("unit_coro_busy_us_total", CoScheduler::busy_us());
+
+  out.gauge("unit_ble_present", bleScanner.is_present() ? 1 : 0);
+  out.counter("unit_presence_changes_total", bleScanner.presence().generation - 1);
+  out.counter("unit_loop_idle_passes_total", idleLoopPasses);
+  out.counter("unit_ble_scans_total", bleScanner.scans_completed());
+  out.counter("unit_ble_radio_on_ms_total", bleScanner.radio_on_ms());
+  out.gauge("unit_ble_adv_interval_ms", bleScanner.estimator().interval_ms());
+  out.gauge("unit_ble_adv_loss_rate", bleScanner.estimator().loss_rate());
+
+  const MqttStats& mqtt = mqtt_stats();
+  out.gauge("unit_mqtt_connected_ms", mqtt_connected_ms());
+  out.counter("unit_mqtt_received_total", mqtt.received);
+  out.counter("unit_mqtt_published_total", mqtt.published);
+  out.counter("unit_mqtt_publish_failures_total", mqtt.publish_failures);
+  out.counter("unit_mqtt_connects_total", mqtt.connects);
+  out.counter("unit_mqtt_connect_failures_total", mqtt.connect_failures);
+  out.gauge("unit_requests_pending", pending_request_count());
+  out.gauge("unit_request_draw_text_us", DisplayManager::last_request_draw_us(false));
+  out.gauge("unit_request_draw_bitmap_us", DisplayManager::last_request_draw_us(true));
+  out.counter("unit_log_records_total", UnitLog::written_count());
+  out.counter("unit_log_records_sent_total", UnitLog::sent_count());
+  out.counter("unit_log_records_lost_total", UnitLog::lost_count());
+  out.counter("unit_log_frames_total", UnitLog::frame_count());
+  out.gauge("unit_log_records_unsent", UnitLog::unsent_count());
+  const RtdbWriterStats firebase = RtdbWriter::stats();
+  out.gauge("unit_firebase_write_us", firebase.last_write_us);
+  out.gauge("unit_firebase_write_max_us", firebase.max_write_us);
+  out.counter("unit_firebase_writes_total", firebase.writes);
+  out.counter("unit_firebase_write_failures_total", firebase.failures);
+  out.counter("unit_firebase_write_retries_total", firebase.retries);
+  out.counter("unit_firebase_connects_total", firebase.connects);
+#if STATUS_MULTICAST_ENABLED
+  out.counter("unit_multicast_sent_total", StatusMulticast::sent_count());
+  out.counter("unit_multicast_send_failures_total", StatusMulticast::failed_count());
+#endif
+#if UNIT_ROLE == UNIT_ROLE_DIRECTORY && DIRECTORY_MULTICAST
+  const StatusReceiverStats& multicast = statusReceiver.stats();
+  out.counter("unit_multicast_received_total", multicast.received);
+  out.counter("unit_multicast_lost_total", multicast.lost);
+  out.counter("unit_multicast_stale_total", multicast.stale);
+#endif
+
+  unsigned long events_dropped = 0;
+  unsigned long dispatch_max_us = 0;
+  for (int type = 0; type < EVENT_TYPE_COUNT; type++) {
+    const EventStats& stats = EventBus::stats((EventType)type);
+    events_dropped += stats.dropped;
+    dispatch_max_us = stats.max_us > dispatch_max_us ? stats.max_us : dispatch_max_us;
+  }
+  out.counter("unit_events_dropped_total", events_dropped);
+  out.gauge("unit_event_dispatch_max_us", dispatch_max_us);
+}
+
+#if UNIT_ROLE == UNIT_ROLE_DIRECTORY && DIRECTORY_MULTICAST
+/**
+ * @brief Feeds LAN status datagrams to the directory board. The group is joined once
+ *        WiFi is connected, because IGMP membership belongs to an interface.
+ */
+void serviceStatusMulticast() {
+  if (statusReceiver.fd() < 0) {
+    if (WiFi.status() != WL_CONNECTED || !statusReceiver.begin(STATUS_MULTICAST_GROUP, STATUS_MULTICAST_PORT)) {
+      return;
+    }
+    Serial.println("Joined status multicast group " STATUS_MULTICAST_GROUP);
+  }
+
+  StatusDatagram datagram;
+  while (statusReceiver.poll(datagram)) {
+    // Away from the office outranks the manual status; in the office, show the manual status if set
+    uint8_t state = DIRECTORY_UNAVAILABLE;
+    if (datagram.present) {
+      const uint8_t byStatus[] = {DIRECTORY_PRESENT, DIRECTORY_AVAILABLE, DIRECTORY_BUSY, DIRECTORY_AWAY};
+      state = byStatus[datagram.status];
+    }
+    DirectoryBoard::ingest_state(datagram.faculty_id, state);
+  }
+}
+#endif
+
+/**
+ * @brief Publishes the manual status via MQTT and mirrors it to Firebase RTDB.
+ */
+void onStatusPublish(const Event& event) {
+  publishStatus();
+
+  writeFirebaseStatus(event.status.status);
+}
+
+/**
+ * @brief Wires module events to their consumers. All handlers run on the loop task.
+ */
+void setupEventHandlers() {
+  EventBus::subscribe(EVENT_PRESENCE_CHANGED, EVENT_TASK_LOOP, onPresencePublish);
+  EventBus::subscribe(EVENT_PRESENCE_CHANGED, EVENT_TASK_LOOP, onPresenceDisplay);
+  EventBus::subscribe(EVENT_REQUEST_SHOW, EVENT_TASK_LOOP, onRequestDisplay);
+  EventBus::subscribe(EVENT_STATUS_CHANGED, EVENT_TASK_LOOP, onStatusLeds);
+  EventBus::subscribe(EVENT_STATUS_CHANGED, EVENT_TASK_LOOP, onStatusPublish);
 }
 
 // --- Removed old WiFi/MQTT setup and reconnect functions ---
@@ -194,23 +589,55 @@ void setupFirebase() {
   // Configure Firebase
   config.api_key = API_KEY;
   config.database_url = DATABASE_URL;
+  snprintf(firebaseStatusPath, sizeof(firebaseStatusPath), "faculty/%s/status", faculty_id);
+#if FIREBASE_TEST_MODE
+  config.signer.test_mode = true; // No sign-in; the database must not require auth
+#endif
   
   // Initialize Firebase
   Firebase.begin(&config, &auth);
   Firebase.reconnectWiFi(true);
   
-  // Check connection
-  if (Firebase.ready()) {
-    Serial.println("Firebase connected");
-    firebaseConnected = true;
-    
-    // Update faculty status in Firebase
-    String path = "faculty/" + String(faculty_id) + "/status";
-    Firebase.RTDB.setString(&fbdo, path.c_str(), currentStatus);
-  } else {
-    Serial.println("Firebase connection failed");
-    firebaseConnected = false;
+  // Sign-in and token refresh run on the writer task; the loop never waits for them
+#if !FIREBASE_TEST_MODE
+  RtdbWriter::set_token_provider(firebaseToken);
+#endif
+  RtdbWriter::begin(DATABASE_URL, firebaseStatusPath);
+  // Update faculty status in Firebase
+  writeFirebaseStatus(currentStatus);
+}
+
+#if !FIREBASE_TEST_MODE
+/**
+ * @brief RtdbWriter token provider; runs on the writer task. ready() signs in and refreshes
+ *        the ID token when due, blocking only that task. The token is copied out (one ~1 KB
+ *        String) only when it changed, about once an hour.
+ */
+bool firebaseToken(char* out, size_t out_size) {
+  static time_t copiedExpiry = 0;
+  if (!Firebase.ready()) {
+    return false;
+  }
+  if (out[0] == '\0' || config.signer.tokens.expires != copiedExpiry) {
+    String token = Firebase.getToken();
+    if (token.length() == 0 || token.length() >= out_size) {
+      ULOG(ULOG_WARN, "Firebase token unusable (%u bytes)", (unsigned)token.length());
+      return false;
+    }
+    memcpy(out, token.c_str(), token.length() + 1);
+    copiedExpiry = config.signer.tokens.expires;
   }
+  return true;
+}
+#endif
+
+/**
+ * @brief Mirrors the manual status to Firebase RTDB. The write is queued for the writer
+ *        task, which holds it until signed in; the loop never waits on the network or the
+ *        token, and nothing here allocates.
+ */
+void writeFirebaseStatus(const char* status) {
+  RtdbWriter::put_string(firebaseStatusPath, status);
 }
 
 // --- Removed old setupBLE() function ---
@@ -243,82 +670,83 @@ void setupButtons() {
   Serial.println("Buttons initialized");
 }
 
+/**
+ * @brief "status_update": republishes the manual status.
+ */
+const char* commandStatusUpdate(JsonObjectConst, JsonObject result) {
+  publishStatus();
+  result["status"] = (const char*)currentStatus;
+  return nullptr;
+}
+
+/**
+ * @brief "display_update": logs a custom message (no display area for it yet).
+ */
+const char* commandDisplayUpdate(JsonObjectConst args, JsonObject) {
+  const char* display_message = args["message"] | "";
+  ULOG(ULOG_INFO, "Display update: %s", display_message);
+  return nullptr;
+}
+
+/**
+ * @brief "set_status": sets the manual status remotely.
+ */
+const char* commandSetStatus(JsonObjectConst args, JsonObject result) {
+  const char* newStatus = args["status"] | "";
+  if (strcmp(newStatus, "available") != 0 && strcmp(newStatus, "busy") != 0 && strcmp(newStatus, "away") != 0) {
+    return "invalid_status";
+  }
+  updateStatus(newStatus);
+  result["status"] = (const char*)currentStatus;
+  return nullptr;
+}
+
 // Renamed function to match the signature passed to setup_mqtt
 void mqtt_message_callback(char* topic, byte* payload, unsigned int length) {
-  // The mqtt_handler.cpp internal callback already prints this
-  // Serial.print("Message arrived [");
-  // Serial.print(topic);
-  Serial.print("] ");
-  
-  // Convert payload to string
-  char message[length + 1];
-  memcpy(message, payload, length);
-  message[length] = '\0';
-  Serial.println(message);
-  
-  // Parse JSON payload (Expected format: {"command": "...", "payload": ...})
-  DynamicJsonDocument doc(1024); // Adjust size if needed for larger payloads
-  DeserializationError error = deserializeJson(doc, message);
-  
-  if (error) {
-    Serial.print("deserializeJson() failed: ");
-    Serial.println(error.c_str());
-    return;
-  }
-  
-  // Handle command
-  String command = doc["command"].as<String>();
-  
-  if (command == "status_update") {
-    // Publish current status
-    publishStatus();
-  } else if (command == "display_update") {
-    // Update display with custom message
-    String message = doc["message"].as<String>();
-    // This would update the actual display
-    Serial.print("Display update: ");
-    Serial.println(message);
-    // updateDisplay(); // Obsolete call removed
-  } else if (command == "set_status") {
-    // Set status remotely
-    String newStatus = doc["status"].as<String>();
-    updateStatus(newStatus);
-  }
+  // The mqtt_handler.cpp internal callback already prints the topic and payload
+  MessageArena::Scope arena_scope; // Payload copy and JSON pool are released on return
+
+  // Only the command topic reaches this callback; each message is a batch
+  // ({"batch_id": ..., "commands": [...]}) answered on the result topic
+  CommandRpc::handle(payload, length);
 }
 
 /**
  * @brief Updates the faculty's *manual* status based on button presses or remote commands.
- *        Updates LEDs, publishes the manual status via MQTT, and updates Firebase RTDB.
+ *        Publishes EVENT_STATUS_CHANGED; subscribers update the LEDs, MQTT and Firebase RTDB.
+ *        If the event pool is empty the change is kept and loop() publishes it next pass.
  * @param newStatus The new manual status ("available", "busy", "away").
  */
-void updateStatus(String newStatus) {
-  if (newStatus == currentStatus) {
+void updateStatus(const char* newStatus) {
+  if (strcmp(newStatus, currentStatus) == 0) {
     return;  // No change
   }
   
-  Serial.print("Updating status from ");
-  Serial.print(currentStatus);
-  Serial.print(" to ");
-  Serial.println(newStatus);
-  
-  currentStatus = newStatus;
-  
-  // Update LEDs
-  digitalWrite(LED_AVAILABLE, currentStatus == "available" ? HIGH : LOW);
-  digitalWrite(LED_BUSY, currentStatus == "busy" ? HIGH : LOW);
-  digitalWrite(LED_AWAY, currentStatus == "away" ? HIGH : LOW);
+  ULOG(ULOG_INFO, "Updating status from %s to %s", currentStatus, newStatus);
   
-  // Update display (Removed - Loop now handles display based on BLE status)
-  // updateDisplay(); // Obsolete call removed
+  strncpy(currentStatus, newStatus, sizeof(currentStatus) - 1);
+  currentStatus[sizeof(currentStatus) - 1] = '\0';
+  statusGeneration++;
+  WarmRestart::mark_dirty();
 
-  // Publish to MQTT
-  publishStatus();
-  
-  // Update Firebase
-  if (firebaseConnected) {
-    String path = "faculty/" + String(faculty_id) + "/status";
-    Firebase.RTDB.setString(&fbdo, path.c_str(), currentStatus);
+  if (announceStatus()) {
+    announcedStatusGeneration = statusGeneration; // Otherwise loop() retries next pass
+  }
+}
+
+/**
+ * @brief Publishes EVENT_STATUS_CHANGED with the current manual status.
+ * @return false if the event pool was empty (try again next pass).
+ */
+bool announceStatus() {
+  Event* event = EventBus::acquire(EVENT_STATUS_CHANGED);
+  if (event == nullptr) {
+    return false;
   }
+  strncpy(event->status.status, currentStatus, sizeof(event->status.status) - 1);
+  event->status.status[sizeof(event->status.status) - 1] = '\0';
+  EventBus::publish(event);
+  return true;
 }
 
 // --- Removed old scanForBeacons() function ---
@@ -326,38 +754,59 @@ void updateStatus(String newStatus) {
 // --- Removed old updateDisplay() function, now handled by DisplayManager ---
 // void updateDisplay() { ... }
 
-void checkButtons() {
-  // Check available button
-  if (digitalRead(BTN_AVAILABLE) == LOW) {
-    delay(50);  // Debounce
-    if (digitalRead(BTN_AVAILABLE) == LOW) {
-      updateStatus("available");
-      while (digitalRead(BTN_AVAILABLE) == LOW) {
-        delay(10);  // Wait for button release
-      }
+/**
+ * @brief Coroutine watching one status button. A press must stay LOW for
+ *        BUTTON_DEBOUNCE_MS to count, and is reported once until released.
+ * @param pin Button GPIO (active LOW, INPUT_PULLUP).
+ * @param status Manual status to set on press.
+ */
+CoTask buttonFlow(int pin, const char* status) {
+  for (;;) {
+    co_await sleep_for(BUTTON_POLL_MS);
+    if (digitalRead(pin) != LOW) {
+      continue;
     }
-  }
-  
-  // Check busy button
-  if (digitalRead(BTN_BUSY) == LOW) {
-    delay(50);  // Debounce
-    if (digitalRead(BTN_BUSY) == LOW) {
-      updateStatus("busy");
-      while (digitalRead(BTN_BUSY) == LOW) {
-        delay(10);  // Wait for button release
-      }
+    co_await sleep_for(BUTTON_DEBOUNCE_MS);  // Debounce
+    if (digitalRead(pin) != LOW) {
+      continue;
+    }
+    updateStatus(status);
+    while (digitalRead(pin) == LOW) {
+      co_await sleep_for(BUTTON_POLL_MS);  // Wait for button release
     }
   }
-  
-  // Check away button
-  if (digitalRead(BTN_AWAY) == LOW) {
-    delay(50);  // Debounce
-    if (digitalRead(BTN_AWAY) == LOW) {
-      updateStatus("away");
-      while (digitalRead(BTN_AWAY) == LOW) {
-        delay(10);  // Wait for button release
+}
+
+/**
+ * @brief Coroutine running a BLE scan every BLE_SCAN_INTERVAL_MS. The scan runs on the
+ *        BLE stack while other flows continue; results are checked once it signals completion.
+ */
+CoTask bleScanFlow() {
+  unsigned long next_scan_ms = millis();
+  for (;;) {
+    // Once the beacon's phase is learned, listen only around its predicted adverts
+    unsigned long open_ms = next_scan_ms;
+    unsigned long window_ms = 0;
+    bool aligned = bleScanner.plan_window(next_scan_ms, &open_ms, &window_ms);
+
+    long wait = (long)(open_ms - millis());
+    co_await sleep_for(wait > 0 ? wait : 0);
+
+    if (aligned) {
+      if (bleScanner.start_window()) {
+        co_await sleep_for(window_ms);
+        bleScanner.stop_window();
+        bleScanner.process_results();
+      }
+    } else {
+      ULOG(ULOG_DEBUG, "Triggering BLE Scan...");
+      if (bleScanner.scan()) {
+        co_await bleScanner.scan_done();
+        bleScanner.process_results();
       }
     }
+    WarmRestart::mark_dirty(); // Learned beacon model
+    next_scan_ms = open_ms + BLE_SCAN_INTERVAL_MS;
   }
 }
 
@@ -371,15 +820,14 @@ void publishStatus() {
   char statusTopic[100]; // Make sure buffer is large enough
   snprintf(statusTopic, sizeof(statusTopic), MQTT_STATUS_TOPIC_TEMPLATE, faculty_id);
 
-  DynamicJsonDocument doc(256);
-  doc["status"] = currentStatus;
-  doc["name"] = faculty_name;
-  doc["department"] = faculty_department;
-  doc["timestamp"] = millis();
+  statusDoc.clear();
+  statusDoc["status"] = (const char*)currentStatus; // Stored by pointer; currentStatus outlives the call
+  statusDoc["name"] = faculty_name;
+  statusDoc["department"] = faculty_department;
+  statusDoc["timestamp"] = millis();
   
-  String statusPayload;
-  serializeJson(doc, statusPayload);
+  serializeJson(statusDoc, statusPayload, sizeof(statusPayload));
 
   // Use the handler's publish function
-  publish_message(statusTopic, statusPayload.c_str(), true);
+  publish_message(statusTopic, statusPayload, true);
 }
\ No newline at end of file
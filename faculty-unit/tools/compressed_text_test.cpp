@@ -0,0 +1,88 @@
+/**
+ * Host test for decode_heatshrink_base64() (comms/compressed_text.h).
+ *
+ * The vectors were produced by central-system/comms/heatshrink.py (compress_text(),
+ * window 8 / lookahead 4), so they also check that both ends agree on the format.
+ * Text longer than the inbox entry must come out truncated, like plain request_text,
+ * not rejected.
+ *
+ * Build and run from faculty-unit/:
+ *   g++ -std=c++20 -O2 -Wall -Wextra -Itools/host -Iconfig -Icomms tools/compressed_text_test.cpp \
+ *       comms/compressed_text.cpp -o compressed_text_test && ./compressed_text_test
+ */
+#ifndef ARDUINO // See host/check.h
+
+#include "host/check.h"
+#include "compressed_text.h"
+#include <cstdio>
+#include <string>
+
+// 310 characters: five copies of the sentence below, then "Thank you."
+static const char* const LONG_PACKED =
+    "o9vt9kkFhs10stytwJG3SyQUmQXe33W2BIbZabXZZBdLfILJabnY7rc7nILbeQaNostzBoyC4XK33C33Ow2yXSAd+O/Hfjvzv5387+d/WfrP1n6z"
+    "93+7/d/1S0WG3WuQXlxjLg==";
+static const char* const LONG_SENTENCE = "Good afternoon, I would like to discuss my thesis proposal. ";
+
+static std::string long_text() {
+    std::string text;
+    for (int i = 0; i < 5; i++) {
+        text += LONG_SENTENCE;
+    }
+    return text + "Thank you.";
+}
+
+static void test_round_trip() {
+    char out[64];
+    size_t len = 0;
+    bool truncated = true;
+    CHECK(decode_heatshrink_base64("sNisYC8IpILRZbZbLeBb", out, sizeof(out), &len, &truncated));
+    CHECK(std::string(out) == "abcabcabcabcabcabcabcabc hello hello hello"); // Overlapping back-references
+    CHECK(len == strlen(out));
+    CHECK(!truncated);
+
+    CHECK(decode_heatshrink_base64("udot9yukgullvF0A", out, sizeof(out), &len, &truncated));
+    CHECK(std::string(out) == "short text");
+    CHECK(!truncated);
+}
+
+static void test_truncation() {
+    const std::string full = long_text();
+
+    char big[512];
+    bool truncated = true;
+    CHECK(decode_heatshrink_base64(LONG_PACKED, big, sizeof(big), nullptr, &truncated));
+    CHECK(std::string(big) == full);
+    CHECK(!truncated);
+
+    // The inbox entry size, as in mqtt_handler.cpp
+    char entry[INBOX_TEXT_LEN];
+    size_t len = 0;
+    CHECK(decode_heatshrink_base64(LONG_PACKED, entry, sizeof(entry), &len, &truncated));
+    CHECK(truncated);
+    CHECK(len == INBOX_TEXT_LEN - 1);
+    CHECK(std::string(entry) == full.substr(0, INBOX_TEXT_LEN - 1));
+
+    // Every cut point, including ones inside a back-reference
+    for (size_t size = 1; size <= full.size() + 1; size++) {
+        CHECK(decode_heatshrink_base64(LONG_PACKED, big, size, &len, &truncated));
+        CHECK(len == std::min(size - 1, full.size()));
+        CHECK(truncated == (size - 1 < full.size()));
+        CHECK(std::string(big) == full.substr(0, size - 1));
+    }
+}
+
+static void test_malformed() {
+    char out[64];
+    CHECK(!decode_heatshrink_base64("sNis*C8I", out, sizeof(out), nullptr)); // Not base64
+    CHECK(!decode_heatshrink_base64("AAAA", out, sizeof(out), nullptr));     // Back-reference before any text
+    CHECK(!decode_heatshrink_base64(nullptr, out, sizeof(out), nullptr));
+}
+
+int main() {
+    test_round_trip();
+    test_truncation();
+    test_malformed();
+    return check_summary("compressed_text_test");
+}
+
+#endif // ARDUINO
@@ -0,0 +1,156 @@
+/**
+ * Host benchmark and test for CoScheduler (core/coro_scheduler.h) on the real TimerWheel.
+ *
+ * Measures the cost per resume of CORO_MAX_TASKS coroutines woken by sleep_for() (timer
+ * expiry in TimerWheel::advance(), then run_ready()) and by CoEvent::signal(), the same
+ * loops as the CORO_SCHEDULER_BENCH boot benchmark. The clock is driven by hand, one
+ * tick per pass, so only scheduling is timed. Every coroutine must run its exact number
+ * of rounds. Then it fills the task slots and the frame pool: spawn() must refuse a
+ * task with no free slot or no frame and log why, and the flows already running must
+ * keep running.
+ *
+ * Build and run from faculty-unit/:
+ *   g++ -std=c++20 -O2 -Wall -Wextra -Itools/host tools/coro_scheduler_bench.cpp \
+ *       core/coro_scheduler.cpp core/timer_wheel.cpp -o coro_scheduler_bench && ./coro_scheduler_bench
+ */
+#ifndef ARDUINO // See host/check.h
+
+#include "host/check.h"
+#include "../core/coro_scheduler.h"
+#include "../core/unit_log.h"
+#include <chrono>
+#include <cstdio>
+
+// The scheduler reports exhausted slots and frames as errors
+static unsigned logged_errors = 0;
+
+void UnitLog::write(LogSite&, LogLevel level, const char*, ...) {
+    logged_errors += level == ULOG_ERROR;
+}
+
+static const unsigned ROUNDS = 20000;
+static unsigned completed_rounds = 0;
+
+static CoTask sleeper(unsigned rounds) {
+    for (unsigned i = 0; i < rounds; i++) {
+        co_await sleep_for(1);
+        completed_rounds++;
+    }
+}
+
+static CoTask waiter(CoEvent& event, unsigned rounds) {
+    for (unsigned i = 0; i < rounds; i++) {
+        co_await event;
+        completed_rounds++;
+    }
+}
+
+static void tick() {
+    host_clock_us += TIMER_TICK_MS * 1000ULL;
+}
+
+static double ns_per_resume(double seconds, unsigned long resumes) {
+    return resumes > 0 ? seconds * 1e9 / resumes : 0;
+}
+
+static void bench_sleep_for() {
+    completed_rounds = 0;
+    for (uint8_t i = 0; i < CORO_MAX_TASKS; i++) {
+        CHECK(CoScheduler::spawn(sleeper(ROUNDS)));
+    }
+    CoScheduler::run_ready(); // Runs each to its first sleep
+    unsigned long first = CoScheduler::resume_count();
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned pass = 0; pass <= ROUNDS; pass++) {
+        tick();
+        TimerWheel::advance();
+        CoScheduler::run_ready();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    unsigned long resumes = CoScheduler::resume_count() - first;
+    CHECK(completed_rounds == CORO_MAX_TASKS * ROUNDS);
+    CHECK(resumes == CORO_MAX_TASKS * ROUNDS);
+    printf("sleep_for: %.1f ns per resume (%lu resumes, timer expiry included)\n",
+           ns_per_resume(elapsed.count(), resumes), resumes);
+}
+
+static void bench_event() {
+    static CoEvent events[CORO_MAX_TASKS];
+    completed_rounds = 0;
+    for (uint8_t i = 0; i < CORO_MAX_TASKS; i++) {
+        CHECK(CoScheduler::spawn(waiter(events[i], ROUNDS)));
+    }
+    CoScheduler::run_ready();
+    unsigned long first = CoScheduler::resume_count();
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned pass = 0; pass < ROUNDS; pass++) {
+        for (CoEvent& event : events) {
+            event.signal();
+        }
+        CoScheduler::run_ready();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    unsigned long resumes = CoScheduler::resume_count() - first;
+    CHECK(completed_rounds == CORO_MAX_TASKS * ROUNDS);
+    CHECK(resumes == CORO_MAX_TASKS * ROUNDS);
+    printf("CoEvent:   %.1f ns per resume (%lu resumes, signal() included)\n", ns_per_resume(elapsed.count(), resumes),
+           resumes);
+
+    // A signal with no waiter is remembered: the next co_await does not suspend
+    events[0].signal();
+    completed_rounds = 0;
+    CHECK(CoScheduler::spawn(waiter(events[0], 1)));
+    CoScheduler::run_ready();
+    CHECK(completed_rounds == 1);
+}
+
+static void test_exhaustion() {
+    // Fill every slot with a flow waiting on its own event
+    static CoEvent events[CORO_MAX_TASKS];
+    completed_rounds = 0;
+    unsigned errors = logged_errors;
+    for (uint8_t i = 0; i < CORO_MAX_TASKS; i++) {
+        CHECK(CoScheduler::spawn(waiter(events[i], 2)));
+    }
+    CoScheduler::run_ready();
+    CHECK(!CoScheduler::spawn(sleeper(1))); // No free slot
+    CHECK(logged_errors == errors + 1);
+
+    // Frames are never reused, so the pool runs dry after a bounded number of spawns
+    unsigned frames = 0;
+    for (;;) {
+        CoTask task = sleeper(1);
+        if (!task.handle) {
+            CHECK(!CoScheduler::spawn(task)); // Allocation failure comes back as a null task
+            break;
+        }
+        task.handle.destroy();
+        frames++;
+        if (frames > CORO_FRAME_POOL_SIZE) {
+            break;
+        }
+    }
+    CHECK(frames <= CORO_FRAME_POOL_SIZE);
+    CHECK(logged_errors > errors + 1);
+    printf("frame pool: %u more frames fit after the benchmarks (%d bytes)\n", frames, CORO_FRAME_POOL_SIZE);
+
+    // The running flows are unaffected
+    for (unsigned pass = 0; pass < 2; pass++) {
+        for (CoEvent& event : events) {
+            event.signal();
+        }
+        CoScheduler::run_ready();
+    }
+    CHECK(completed_rounds == CORO_MAX_TASKS * 2);
+}
+
+int main() {
+    host_clock_manual = true;
+    TimerWheel::init();
+    bench_sleep_for();
+    bench_event();
+    test_exhaustion();
+    return check_summary("coro_scheduler_bench");
+}
+
+#endif // ARDUINO
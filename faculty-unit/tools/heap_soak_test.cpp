@@ -0,0 +1,410 @@
+/**
+ * Host soak test for the no-heap-after-init rule (core/heap_guard.h).
+ *
+ * Runs a simulated week of a unit's loop-task traffic through the firmware's own
+ * loop-path modules. The TimerWheel drives every timeout and the loop sleeps until the
+ * next one, as loop() does. BLE scan windows feed the PresenceEstimator against a beacon
+ * that is in range during office hours. MQTT requests, plain and heatshrink-packed, plus a
+ * daily flood from spoofed IDs, go through the MessageArena, the rate limiter and the
+ * RequestInbox. Presence, status and request changes travel over the EventBus to
+ * handlers that encode and decode status datagrams and rasterize spans.
+ *
+ * After setup, every malloc/calloc/realloc (glibc; libstdc++'s operator new calls malloc)
+ * or operator new (elsewhere) is counted, as HeapGuard counts them on the board. The test
+ * fails unless the week ends with zero steady-state allocations. PubSubClient,
+ * ArduinoJson, the BLE stack and the TFT driver do not run here; on the board HeapGuard
+ * covers them, as far as CONFIG_HEAP_USE_HOOKS allows.
+ *
+ * Build and run from faculty-unit/:
+ *   g++ -std=c++20 -O2 -Wall -Wextra -I.. -Itools/host -Iconfig -Icomms tools/heap_soak_test.cpp \
+ *       core/timer_wheel.cpp core/event_bus.cpp core/message_arena.cpp comms/request_inbox.cpp \
+ *       comms/rate_limiter.cpp comms/compressed_text.cpp comms/status_datagram.cpp \
+ *       ble/presence_estimator.cpp display/pixel_kernels.cpp -o heap_soak_test && ./heap_soak_test [--days 7]
+ */
+#ifndef ARDUINO // See host/check.h
+
+#include "host/check.h"
+#include "../core/timer_wheel.h"
+#include "../core/event_bus.h"
+#include "../core/message_arena.h"
+#include "../core/unit_log.h"
+#include "../ble/presence_estimator.h"
+#include "../display/pixel_kernels.h"
+#include "compressed_text.h"
+#include "rate_limiter.h"
+#include "request_inbox.h"
+#include "status_datagram.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+
+// --- Allocation counting ---------------------------------------------------------------
+
+static bool steadyState = false;
+static unsigned long steadyAllocations = 0;
+
+#ifdef __GLIBC__
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+extern "C" void* malloc(size_t size) noexcept {
+    steadyAllocations += steadyState;
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) noexcept {
+    steadyAllocations += steadyState;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) noexcept {
+    steadyAllocations += steadyState;
+    return __libc_realloc(ptr, size);
+}
+#else
+void* operator new(size_t size) {
+    steadyAllocations += steadyState;
+    if (void* ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+#endif
+
+// MessageArena logs its overflows; they are counted by the arena and checked below
+void UnitLog::write(LogSite&, LogLevel, const char*, ...) {
+}
+
+// --- Simulated unit --------------------------------------------------------------------
+
+static const unsigned long HOUR_MS = 3600UL * 1000;
+static const unsigned long DAY_MS = 24 * HOUR_MS;
+static const unsigned long BEACON_INTERVAL_MS = 1000;
+static const float BEACON_LOSS = 0.2f;
+
+// From compressed_text_test.cpp (central-system/comms/heatshrink.py output)
+static const char* const PACKED_TEXTS[] = {
+    "udot9yukgullvF0A",
+    "o9vt9kkFhs10stytwJG3SyQUmQXe33W2BIbZabXZZBdLfILJabnY7rc7nILbeQaNostzBoyC4XK33C33Ow2yXSAd+O/Hfjvzv5387+d/WfrP1n6z"
+    "93+7/d/1S0WG3WuQXlxjLg==",
+};
+static const char* const STATUSES[] = {"available", "busy", "away"};
+
+static std::mt19937 rng(82);
+static std::uniform_real_distribution<float> unit(0, 1);
+
+static RequestInbox inbox;
+static RequestRateLimiter limiter;
+static PresenceEstimator estimator;
+static WheelTimer scanTimer, presenceTimer, pollTimer, dwellTimer, statusTimer;
+
+static bool present = false;
+static bool requestShown = false;
+static InboxRequest shownRequest;
+static uint8_t statusIndex = 0;
+static unsigned long nextAdvertMs = 0;
+static unsigned long nextRequestMs = 0;
+static unsigned long nextFloodMs = 0;
+static unsigned long previousWindowEndMs = 0;
+static uint32_t nextTraceId = 1;
+static uint32_t datagramSeq = 0;
+
+// Buffers the handlers fill, sized as on the board
+static char payloadBuffer[512];
+static uint8_t datagramBuffer[STATUS_DATAGRAM_MAX_LEN];
+static uint16_t lineBuffer[SCREEN_WIDTH];
+static uint16_t ramp[16];
+
+struct SoakStats {
+    unsigned long passes = 0;
+    unsigned long scans = 0;
+    unsigned long presence_changes = 0;
+    unsigned long status_changes = 0;
+    unsigned long requests = 0;
+    unsigned long rate_limited = 0;
+    unsigned long shown = 0;
+    unsigned long datagrams = 0;
+};
+static SoakStats stats;
+
+/**
+ * @brief Monday 00:00 at t = 0; the beacon is in range 08:00-12:00 and 13:00-17:00 on weekdays.
+ */
+static bool in_office(unsigned long long t_ms) {
+    unsigned long long day = t_ms / DAY_MS;
+    unsigned long hour = (t_ms % DAY_MS) / HOUR_MS;
+    return day % 7 < 5 && ((hour >= 8 && hour < 12) || (hour >= 13 && hour < 17));
+}
+
+static unsigned long long now_ms() {
+    return host_clock_us / 1000;
+}
+
+static unsigned long exponential_ms(float mean_ms) {
+    return 1 + (unsigned long)(-mean_ms * logf(1 - unit(rng) * 0.999f));
+}
+
+static void publish_status_event(EventType type) {
+    Event* event = EventBus::acquire(type);
+    CHECK(event != nullptr);
+    if (event == nullptr) {
+        return;
+    }
+    if (type == EVENT_PRESENCE_CHANGED) {
+        event->presence.present = present;
+    } else {
+        strncpy(event->status.status, STATUSES[statusIndex], sizeof(event->status.status) - 1);
+        event->status.status[sizeof(event->status.status) - 1] = '\0';
+    }
+    EventBus::publish(event);
+}
+
+/**
+ * @brief Status datagram round trip, as the unit sends it and a directory board reads it.
+ */
+static void on_status_event(const Event& event) {
+    StatusDatagram out = {};
+    out.epoch = 82;
+    out.seq = ++datagramSeq;
+    out.sent_us = micros();
+    out.present = event.type == EVENT_PRESENCE_CHANGED ? event.presence.present : present;
+    out.status = status_code_from_name(STATUSES[statusIndex]);
+    out.depth = inbox.depth();
+    strcpy(out.faculty_id, "faculty1");
+    size_t len = status_datagram_encode(out, datagramBuffer, sizeof(datagramBuffer));
+    StatusDatagram in;
+    CHECK(len > 0 && status_datagram_decode(datagramBuffer, len, in));
+    CHECK(in.seq == out.seq && in.status == out.status && in.present == out.present);
+    stats.datagrams++;
+}
+
+/**
+ * @brief Stands in for DisplayManager::show_request(): palette and a few rows of spans.
+ */
+static void on_request_event(const Event& event) {
+    PixelKernels::build_ramp(ramp, 0xFFFF, (uint16_t)(event.request.priority * 0x1111));
+    for (size_t row = 0; row < 24; row++) {
+        PixelKernels::fill_span(lineBuffer, ramp[row & 15], SCREEN_WIDTH);
+        PixelKernels::swap_bytes(lineBuffer, lineBuffer, SCREEN_WIDTH);
+    }
+    stats.shown++;
+}
+
+static void on_dwell_timer(void*) {
+    requestShown = false;
+}
+
+static void on_presence_timer(void*) {
+    present = false;
+    stats.presence_changes++;
+    publish_status_event(EVENT_PRESENCE_CHANGED);
+}
+
+/**
+ * @brief One blind scan window: adverts that fall in it are heard unless lost.
+ */
+static void on_scan_timer(void*) {
+    unsigned long long open = now_ms();
+    unsigned long window_ms = BLE_SCAN_DURATION * 1000UL;
+    unsigned long long close = open + window_ms;
+    while (nextAdvertMs < open) {
+        nextAdvertMs += BEACON_INTERVAL_MS + rng() % (BLE_ADV_DELAY_MAX_MS + 1);
+    }
+    bool found = false;
+    while (nextAdvertMs < close) {
+        if (in_office(nextAdvertMs) && unit(rng) >= BEACON_LOSS) {
+            estimator.on_advert(nextAdvertMs);
+            found = true;
+        }
+        nextAdvertMs += BEACON_INTERVAL_MS + rng() % (BLE_ADV_DELAY_MAX_MS + 1);
+    }
+    estimator.end_window(window_ms, present);
+    unsigned long period_ms = previousWindowEndMs != 0 ? close - previousWindowEndMs : BLE_SCAN_INTERVAL_MS;
+    previousWindowEndMs = close;
+    stats.scans++;
+
+    if (found) {
+        TimerWheel::schedule(presenceTimer, window_ms + estimator.timeout_ms(window_ms, period_ms), on_presence_timer,
+                             nullptr);
+        if (!present) {
+            present = true;
+            stats.presence_changes++;
+            publish_status_event(EVENT_PRESENCE_CHANGED);
+        }
+    }
+    TimerWheel::schedule(scanTimer, BLE_SCAN_INTERVAL_MS, on_scan_timer, nullptr);
+}
+
+static void on_status_timer(void*) {
+    statusIndex = (statusIndex + 1 + rng() % 2) % 3;
+    stats.status_changes++;
+    publish_status_event(EVENT_STATUS_CHANGED);
+    TimerWheel::schedule(statusTimer, exponential_ms(3 * HOUR_MS), on_status_timer, nullptr);
+}
+
+/**
+ * @brief The request path of the MQTT callback: payload copy, JSON pool and decoded text
+ *        in the arena, then the rate limiter and the inbox.
+ */
+static void handle_request(const char* student_id, uint8_t priority) {
+    MessageArena::Scope arena_scope;
+    bool packed = rng() % 2;
+    const char* packed_text = PACKED_TEXTS[rng() % 2];
+    int len = snprintf(payloadBuffer, sizeof(payloadBuffer),
+                       "{\"student_id\":\"%s\",\"priority\":%u,\"trace_id\":%lu,\"%s\":\"%s\"}", student_id,
+                       (unsigned)priority, (unsigned long)nextTraceId, packed ? "request_text_hs" : "request_text",
+                       packed ? packed_text : "Could we go over the lab report?");
+    char* payload = MessageArena::copy_string((const byte*)payloadBuffer, len);
+    void* pool = MessageArena::allocate(JSON_REQUEST_DOC_SIZE);
+    CHECK(payload != nullptr && pool != nullptr);
+
+    const char* text = "Could we go over the lab report?";
+    if (packed) {
+        char* decoded = (char*)MessageArena::allocate(INBOX_TEXT_LEN);
+        CHECK(decoded != nullptr && decode_heatshrink_base64(packed_text, decoded, INBOX_TEXT_LEN, nullptr));
+        text = decoded;
+    }
+    stats.requests++;
+    if (!limiter.allow(student_id, millis())) {
+        stats.rate_limited++;
+        return;
+    }
+    inbox.push(student_id, text, priority, millis(), 0, nextTraceId++);
+}
+
+/**
+ * @brief MQTT poll: delivers the requests that have arrived since the last one.
+ */
+static void on_poll_timer(void*) {
+    unsigned long long t = now_ms();
+    char student[INBOX_STUDENT_ID_LEN];
+    while (nextRequestMs <= t) {
+        snprintf(student, sizeof(student), "2024-%05u", (unsigned)(rng() % 40));
+        handle_request(student, rng() % 3);
+        nextRequestMs += exponential_ms(in_office(t) ? 6 * 60 * 1000.0f : 2.0f * HOUR_MS);
+    }
+    if (nextFloodMs <= t) {
+        // Half from one student hammering the button, half from spoofed IDs
+        for (unsigned i = 0; i < 40; i++) {
+            snprintf(student, sizeof(student), i % 2 ? "spoof-%08lx" : "2024-00007", (unsigned long)rng());
+            handle_request(student, 0);
+        }
+        nextFloodMs += DAY_MS;
+    }
+    TimerWheel::schedule(pollTimer, MQTT_POLL_MS, on_poll_timer, nullptr);
+}
+
+/**
+ * @brief Shows the next request once the previous one has had its minimum time on screen.
+ */
+static void service_inbox() {
+    if (requestShown || !inbox.pop(shownRequest)) {
+        return;
+    }
+    Event* event = EventBus::acquire(EVENT_REQUEST_SHOW);
+    CHECK(event != nullptr);
+    if (event != nullptr) {
+        event->request = shownRequest;
+        EventBus::publish(event);
+    }
+    requestShown = true;
+    TimerWheel::schedule(dwellTimer, REQUEST_MIN_DISPLAY_MS, on_dwell_timer, nullptr);
+}
+
+static void setup_unit() {
+    host_clock_manual = true;
+    host_clock_us = 0;
+    TimerWheel::init();
+    EventBus::setup_bus();
+    EventBus::subscribe(EVENT_PRESENCE_CHANGED, EVENT_TASK_LOOP, on_status_event);
+    EventBus::subscribe(EVENT_STATUS_CHANGED, EVENT_TASK_LOOP, on_status_event);
+    EventBus::subscribe(EVENT_REQUEST_SHOW, EVENT_TASK_LOOP, on_request_event);
+    TimerWheel::schedule(scanTimer, 1000, on_scan_timer, nullptr);
+    TimerWheel::schedule(pollTimer, MQTT_POLL_MS, on_poll_timer, nullptr);
+    TimerWheel::schedule(statusTimer, exponential_ms(3 * HOUR_MS), on_status_timer, nullptr);
+    nextRequestMs = exponential_ms(HOUR_MS);
+    nextFloodMs = 10 * HOUR_MS + 17 * 60 * 1000;
+}
+
+/**
+ * @brief The counter must see allocations, or a zero at the end proves nothing.
+ */
+static void test_counter_sees_allocations() {
+    void* (*volatile allocate)(size_t) = malloc;
+    steadyState = true;
+    void* block = allocate(16);
+    std::string* text = new std::string(64, 'x');
+    steadyState = false;
+    delete text;
+    free(block);
+    CHECK(steadyAllocations >= 2);
+    steadyAllocations = 0;
+}
+
+int main(int argc, char** argv) {
+    double days = 7;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--days") == 0 && i + 1 < argc) {
+            days = atof(argv[++i]);
+        }
+    }
+    test_counter_sees_allocations();
+
+    setup_unit();
+    printf("Simulating %.1f days of loop-task traffic...\n", days); // Also allocates stdout's buffer before arming
+    const unsigned long long end_ms = (unsigned long long)(days * DAY_MS);
+    steadyState = true;
+    while (now_ms() < end_ms) {
+        TimerWheel::advance();
+        EventBus::dispatch(EVENT_TASK_LOOP);
+        service_inbox();
+        stats.passes++;
+        unsigned long sleep_ms = TimerWheel::ms_until_next();
+        host_clock_us += (sleep_ms > 0 ? sleep_ms : 1) * 1000ULL;
+    }
+    steadyState = false;
+
+    printf("%lu loop passes, %lu scans, %lu presence changes, %lu status changes, %lu datagrams\n", stats.passes,
+           stats.scans, stats.presence_changes, stats.status_changes, stats.datagrams);
+    printf("%lu requests (%lu rate-limited, %lu inbox overflows), %lu shown; arena high water %lu bytes\n",
+           stats.requests, stats.rate_limited, inbox.overflow_count(), stats.shown,
+           (unsigned long)MessageArena::high_water_mark());
+    printf("steady-state allocations: %lu\n", steadyAllocations);
+
+    CHECK(steadyAllocations == 0);
+    CHECK(MessageArena::overflow_count() == 0);
+    for (uint8_t type = 0; type < EVENT_TYPE_COUNT; type++) {
+        CHECK(EventBus::stats((EventType)type).dropped == 0);
+    }
+    // The week really exercised every path
+    CHECK(stats.presence_changes >= 2 * 5 * (unsigned long)(days / 7));
+    CHECK(stats.shown > 100 * (unsigned long)(days / 7));
+    CHECK(stats.rate_limited > 0 || days < 1);
+    return check_summary("heap_soak_test");
+}
+
+#endif // ARDUINO
@@ -0,0 +1,91 @@
+/**
+ * Adafruit_GFX shim for the host unit: the text calls DisplayManager makes, drawn the
+ * way the library draws its built-in 6x8 font (one fillRect per set glyph pixel, size
+ * times size, wrapping at the right edge). The glyph shapes are made up from the
+ * character code, so the pixel work per character is realistic but the text is not legible.
+ */
+#ifndef HOST_ADAFRUIT_GFX_SHIM_H
+#define HOST_ADAFRUIT_GFX_SHIM_H
+
+#include <Arduino.h>
+
+class Adafruit_GFX {
+public:
+    Adafruit_GFX(int16_t w, int16_t h) : _width(w), _height(h) {}
+    virtual ~Adafruit_GFX() = default;
+
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) = 0;
+    virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+
+    void setCursor(int16_t x, int16_t y) {
+        cursor_x = x;
+        cursor_y = y;
+    }
+    int16_t getCursorX() const { return cursor_x; }
+    int16_t getCursorY() const { return cursor_y; }
+    void setTextSize(uint8_t s) { textsize = s > 0 ? s : 1; }
+    void setTextColor(uint16_t c) { textcolor = c; }
+    void setTextWrap(bool w) { wrap = w; }
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+
+    void print(const char* s) {
+        while (*s != '\0') {
+            write((uint8_t)*s++);
+        }
+    }
+    void print(unsigned long n) {
+        char digits[12];
+        snprintf(digits, sizeof(digits), "%lu", n);
+        print(digits);
+    }
+    void print(unsigned n) { print((unsigned long)n); }
+    void print(uint8_t n) { print((unsigned long)n); }
+    void println(const char* s = "") {
+        print(s);
+        print("\r\n");
+    }
+
+    void write(uint8_t c) {
+        if (c == '\n') {
+            cursor_x = 0;
+            cursor_y += textsize * 8;
+            return;
+        }
+        if (c == '\r') {
+            return;
+        }
+        if (wrap && cursor_x + textsize * 6 > _width) {
+            cursor_x = 0;
+            cursor_y += textsize * 8;
+        }
+        drawChar(cursor_x, cursor_y, c);
+        cursor_x += textsize * 6;
+    }
+
+protected:
+    int16_t _width, _height;
+
+private:
+    void drawChar(int16_t x, int16_t y, uint8_t c) {
+        if (x >= _width || y >= _height || x + 6 * textsize <= 0 || y + 8 * textsize <= 0) {
+            return;
+        }
+        uint32_t shape = (c == ' ') ? 0 : c * 2654435761u;
+        for (int8_t i = 0; i < 5; i++) {
+            uint8_t line = (shape >> (i * 6)) & 0x7F; // Seven rows, the eighth is the baseline gap
+            for (int8_t j = 0; j < 8; j++, line >>= 1) {
+                if (line & 1) {
+                    fillRect(x + i * textsize, y + j * textsize, textsize, textsize, textcolor);
+                }
+            }
+        }
+    }
+
+    int16_t cursor_x = 0, cursor_y = 0;
+    uint8_t textsize = 1;
+    uint16_t textcolor = 0xFFFF;
+    bool wrap = true;
+};
+
+#endif // HOST_ADAFRUIT_GFX_SHIM_H
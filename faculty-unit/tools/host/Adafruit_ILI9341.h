@@ -0,0 +1,78 @@
+/**
+ * Adafruit_ILI9341 shim for the host unit: draws into a RGB565 framebuffer instead of
+ * sending SPI transactions. Panel commands are accepted and ignored; writePixels()
+ * fills the address window row by row as the panel does. Drawing is host memory
+ * bandwidth only, so draw times say nothing about the SPI bus.
+ */
+#ifndef HOST_ADAFRUIT_ILI9341_SHIM_H
+#define HOST_ADAFRUIT_ILI9341_SHIM_H
+
+#include "Adafruit_GFX.h"
+
+#define ILI9341_TFTWIDTH 240
+#define ILI9341_TFTHEIGHT 320
+
+#define ILI9341_SLPIN 0x10
+#define ILI9341_DISPOFF 0x28
+
+#define ILI9341_BLACK 0x0000
+#define ILI9341_NAVY 0x000F
+#define ILI9341_DARKGREY 0x7BEF
+#define ILI9341_RED 0xF800
+#define ILI9341_GREEN 0x07E0
+#define ILI9341_ORANGE 0xFD20
+#define ILI9341_WHITE 0xFFFF
+
+class Adafruit_ILI9341 : public Adafruit_GFX {
+public:
+    Adafruit_ILI9341(int8_t, int8_t, int8_t = -1) : Adafruit_GFX(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT) {}
+
+    void begin(uint32_t = 0) {}
+    void sendCommand(uint8_t) {}
+    void startWrite() {}
+    void endWrite() {}
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+        int16_t x1 = x + w > _width ? _width : x + w;
+        int16_t y1 = y + h > _height ? _height : y + h;
+        for (int16_t row = y < 0 ? 0 : y; row < y1; row++) {
+            for (int16_t col = x < 0 ? 0 : x; col < x1; col++) {
+                frame[row * ILI9341_TFTWIDTH + col] = color;
+            }
+        }
+    }
+
+    void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+        win_x = x;
+        win_y = y;
+        win_w = w;
+        win_h = h;
+        win_pos = 0;
+    }
+
+    /**
+     * @param bigEndian true if `colors` are already in SPI byte order (swapped).
+     */
+    void writePixels(uint16_t* colors, uint32_t len, bool = true, bool bigEndian = false) {
+        for (uint32_t i = 0; i < len && win_pos < (uint32_t)win_w * win_h; i++, win_pos++) {
+            uint16_t c = bigEndian ? (uint16_t)((colors[i] >> 8) | (colors[i] << 8)) : colors[i];
+            int x = win_x + win_pos % win_w;
+            int y = win_y + win_pos / win_w;
+            if (x < _width && y < _height) {
+                frame[y * ILI9341_TFTWIDTH + x] = c;
+            }
+        }
+    }
+
+    /**
+     * @brief The panel contents, row-major RGB565.
+     */
+    const uint16_t* framebuffer() const { return frame; }
+
+private:
+    uint16_t frame[ILI9341_TFTWIDTH * ILI9341_TFTHEIGHT] = {};
+    uint16_t win_x = 0, win_y = 0, win_w = 0, win_h = 0;
+    uint32_t win_pos = 0;
+};
+
+#endif // HOST_ADAFRUIT_ILI9341_SHIM_H
@@ -0,0 +1,76 @@
+/**
+ * Minimal Arduino shim for the host tests and benchmarks in tools/.
+ *
+ * Only what the pure-C++ modules under test use. millis()/micros() follow the
+ * host clock unless a test sets host_clock_manual and drives host_clock_us itself.
+ * freertos/ next to this file covers the few FreeRTOS calls of the core modules; the
+ * other headers here stand in for the board libraries host_unit.cpp links against.
+ */
+#ifndef HOST_ARDUINO_SHIM_H
+#define HOST_ARDUINO_SHIM_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define F(s) (s)
+
+/**
+ * Serial prints go to stdout (setup-time messages only; the soak test counts allocations).
+ */
+struct HostSerial {
+    void print(const char* s) { fputs(s, stdout); }
+    void println(const char* s = "") { puts(s); }
+};
+inline HostSerial Serial;
+
+inline bool host_clock_manual = false;
+inline uint64_t host_clock_us = 0;
+
+inline unsigned long micros() {
+    if (host_clock_manual) {
+        return (unsigned long)(uint32_t)host_clock_us;
+    }
+    using namespace std::chrono;
+    return (unsigned long)(uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+inline unsigned long millis() {
+    if (host_clock_manual) {
+        return (unsigned long)(uint32_t)(host_clock_us / 1000);
+    }
+    using namespace std::chrono;
+    return (unsigned long)(uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+inline void delay(unsigned long ms) {
+    if (host_clock_manual) {
+        host_clock_us += ms * 1000ULL;
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+}
+
+// GPIO writes go nowhere
+#define LOW 0
+#define HIGH 1
+#define OUTPUT 0x03
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+
+/**
+ * Byte source read by QoiDecoder (Arduino's Stream, reading side only).
+ */
+class Stream {
+public:
+    virtual ~Stream() = default;
+    virtual size_t readBytes(uint8_t* buffer, size_t length) = 0;
+};
+
+#endif // HOST_ARDUINO_SHIM_H
@@ -0,0 +1,361 @@
+/**
+ * ArduinoJson 6 shim for the host unit: what mqtt_handler.cpp reads from a request.
+ * deserializeJson() parses in place like the library's zero-copy mode (strings are
+ * unescaped and terminated inside the writable input) into a pool of 16-byte slots
+ * taken from the document's allocator, one slot per value as on the ESP32, and fails
+ * with the library's error names. Only the top-level object's members can be read;
+ * nested objects and arrays are parsed and take their slots, but read as null.
+ */
+#ifndef HOST_ARDUINOJSON_SHIM_H
+#define HOST_ARDUINOJSON_SHIM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#define JSON_OBJECT_SIZE(n) ((n) * 16)
+#define JSON_ARRAY_SIZE(n) ((n) * 16)
+
+class DeserializationError {
+public:
+    enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory, TooDeep };
+
+    DeserializationError(Code code = Ok) : _code(code) {}
+    explicit operator bool() const { return _code != Ok; }
+    Code code() const { return _code; }
+    const char* c_str() const {
+        static const char* const names[] = {"Ok", "EmptyInput", "IncompleteInput", "InvalidInput", "NoMemory",
+                                            "TooDeep"};
+        return names[_code];
+    }
+
+private:
+    Code _code;
+};
+
+namespace host_json {
+
+enum Kind : uint8_t { KIND_NULL, KIND_STRING, KIND_NUMBER, KIND_BOOL, KIND_NESTED };
+
+// Offsets into the input keep the slot at 16 bytes with 64-bit pointers
+struct Slot {
+    uint32_t key;   ///< Offset of the member name (top-level members only)
+    uint32_t str;   ///< Offset of the string value
+    int32_t num;    ///< Number (truncated to an integer) or bool
+    uint8_t kind;
+    uint8_t depth;  ///< 1 for members of the top-level object
+};
+static_assert(sizeof(Slot) == 16, "one ESP32 ArduinoJson slot");
+
+const uint8_t NESTING_LIMIT = 10; // ARDUINOJSON_DEFAULT_NESTING_LIMIT
+
+class Parser {
+public:
+    Parser(char* input, size_t length, Slot* slots, size_t capacity)
+        : base(input), p(input), end(input + length), slots(slots), capacity(capacity) {}
+
+    DeserializationError::Code parse_document(size_t& used) {
+        skip_space();
+        if (p == end) {
+            return DeserializationError::EmptyInput;
+        }
+        DeserializationError::Code err = parse_value(0, 0);
+        used = count;
+        return err;
+    }
+
+private:
+    void skip_space() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+            p++;
+        }
+    }
+
+    Slot* take(uint8_t depth) {
+        if (count == capacity) {
+            return nullptr;
+        }
+        Slot* slot = &slots[count++];
+        *slot = {};
+        slot->depth = depth;
+        return slot;
+    }
+
+    static int hex(char c) {
+        return c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+    }
+
+    // Unescapes the string at p (opening quote) in place and terminates it
+    DeserializationError::Code parse_string(uint32_t& offset) {
+        char* out = ++p;
+        offset = (uint32_t)(out - base);
+        while (p < end && *p != '"') {
+            char c = *p++;
+            if (c != '\\') {
+                *out++ = c;
+                continue;
+            }
+            if (p == end) {
+                return DeserializationError::IncompleteInput;
+            }
+            char e = *p++;
+            switch (e) {
+                case '"': case '\\': case '/': *out++ = e; break;
+                case 'b': *out++ = '\b'; break;
+                case 'f': *out++ = '\f'; break;
+                case 'n': *out++ = '\n'; break;
+                case 'r': *out++ = '\r'; break;
+                case 't': *out++ = '\t'; break;
+                case 'u': {
+                    if (end - p < 4) {
+                        return DeserializationError::IncompleteInput;
+                    }
+                    uint32_t cp = 0;
+                    for (int i = 0; i < 4; i++) {
+                        int h = hex(*p++);
+                        if (h < 0) {
+                            return DeserializationError::InvalidInput;
+                        }
+                        cp = cp << 4 | h;
+                    }
+                    if (cp < 0x80) {
+                        *out++ = (char)cp;
+                    } else if (cp < 0x800) {
+                        *out++ = (char)(0xC0 | cp >> 6);
+                        *out++ = (char)(0x80 | (cp & 0x3F));
+                    } else {
+                        *out++ = (char)(0xE0 | cp >> 12);
+                        *out++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+                        *out++ = (char)(0x80 | (cp & 0x3F));
+                    }
+                    break;
+                }
+                default:
+                    return DeserializationError::InvalidInput;
+            }
+        }
+        if (p == end) {
+            return DeserializationError::IncompleteInput;
+        }
+        p++;
+        *out = '\0'; // At or before the closing quote
+        return DeserializationError::Ok;
+    }
+
+    bool literal(const char* word) {
+        size_t n = strlen(word);
+        if ((size_t)(end - p) < n || strncmp(p, word, n) != 0) {
+            return false;
+        }
+        p += n;
+        return true;
+    }
+
+    DeserializationError::Code parse_value(uint8_t depth, uint32_t key) {
+        skip_space();
+        if (p == end) {
+            return DeserializationError::IncompleteInput;
+        }
+        if (*p == '{' || *p == '[') {
+            return parse_container(depth, key);
+        }
+        Slot* slot = nullptr;
+        if (depth > 0) { // The top-level value of a document is not a slot
+            slot = take(depth);
+            if (slot == nullptr) {
+                return DeserializationError::NoMemory;
+            }
+            slot->key = key;
+        }
+        Slot scratch = {};
+        Slot& value = slot != nullptr ? *slot : scratch;
+        if (*p == '"') {
+            value.kind = KIND_STRING;
+            return parse_string(value.str);
+        }
+        if (literal("true") || literal("false")) {
+            value.kind = KIND_BOOL;
+            value.num = p[-1] == 'e' && p[-2] == 'u'; // "true"
+            return DeserializationError::Ok;
+        }
+        if (literal("null")) {
+            return DeserializationError::Ok;
+        }
+        if (end - p < 5 && strchr("tfn", *p) != nullptr) {
+            return DeserializationError::IncompleteInput;
+        }
+        // The input is not terminated, so the number is copied out for strtod()
+        char digits[32];
+        size_t n = 0;
+        while (p + n < end && n < sizeof(digits) - 1 && strchr("0123456789+-.eE", p[n]) != nullptr) {
+            digits[n] = p[n];
+            n++;
+        }
+        digits[n] = '\0';
+        char* num_end = nullptr;
+        double number = strtod(digits, &num_end);
+        if (n == 0 || num_end != digits + n) {
+            return DeserializationError::InvalidInput;
+        }
+        p += n;
+        value.kind = KIND_NUMBER;
+        value.num = (int32_t)(int64_t)number;
+        return DeserializationError::Ok;
+    }
+
+    DeserializationError::Code parse_container(uint8_t depth, uint32_t key) {
+        if (depth >= NESTING_LIMIT) {
+            return DeserializationError::TooDeep;
+        }
+        if (depth > 0) {
+            Slot* slot = take(depth);
+            if (slot == nullptr) {
+                return DeserializationError::NoMemory;
+            }
+            slot->key = key;
+            slot->kind = KIND_NESTED;
+        }
+        char close = *p == '{' ? '}' : ']';
+        bool object = close == '}';
+        if (depth == 0) {
+            top_object = object;
+        }
+        p++;
+        skip_space();
+        if (p < end && *p == close) {
+            p++;
+            return DeserializationError::Ok;
+        }
+        for (;;) {
+            uint32_t member_key = 0;
+            if (object) {
+                skip_space();
+                if (p == end) {
+                    return DeserializationError::IncompleteInput;
+                }
+                if (*p != '"') {
+                    return DeserializationError::InvalidInput;
+                }
+                DeserializationError::Code err = parse_string(member_key);
+                if (err != DeserializationError::Ok) {
+                    return err;
+                }
+                skip_space();
+                if (p == end) {
+                    return DeserializationError::IncompleteInput;
+                }
+                if (*p++ != ':') {
+                    return DeserializationError::InvalidInput;
+                }
+            }
+            DeserializationError::Code err = parse_value(depth + 1, member_key);
+            if (err != DeserializationError::Ok) {
+                return err;
+            }
+            skip_space();
+            if (p == end) {
+                return DeserializationError::IncompleteInput;
+            }
+            char c = *p++;
+            if (c == close) {
+                return DeserializationError::Ok;
+            }
+            if (c != ',') {
+                return DeserializationError::InvalidInput;
+            }
+        }
+    }
+
+    char* base;
+    char* p;
+    char* end;
+    Slot* slots;
+    size_t capacity;
+    size_t count = 0;
+
+public:
+    bool top_object = false;
+};
+
+} // namespace host_json
+
+/**
+ * Read-only view of one member; null if the member is missing or has another type.
+ */
+class JsonVariantConst {
+public:
+    JsonVariantConst(const host_json::Slot* slot, const char* base) : slot(slot), base(base) {}
+
+    operator const char*() const {
+        return slot != nullptr && slot->kind == host_json::KIND_STRING ? base + slot->str : nullptr;
+    }
+    int operator|(int fallback) const {
+        return slot != nullptr && slot->kind == host_json::KIND_NUMBER ? slot->num : fallback;
+    }
+    const char* operator|(const char* fallback) const {
+        const char* s = *this;
+        return s != nullptr ? s : fallback;
+    }
+    bool isNull() const { return slot == nullptr; }
+
+private:
+    const host_json::Slot* slot;
+    const char* base;
+};
+
+template <typename TAllocator>
+class BasicJsonDocument {
+public:
+    explicit BasicJsonDocument(size_t capacity) {
+        pool = (host_json::Slot*)allocator.allocate(capacity);
+        slotCapacity = pool != nullptr ? capacity / sizeof(host_json::Slot) : 0;
+    }
+    ~BasicJsonDocument() { allocator.deallocate(pool); }
+    BasicJsonDocument(const BasicJsonDocument&) = delete;
+    BasicJsonDocument& operator=(const BasicJsonDocument&) = delete;
+
+    JsonVariantConst operator[](const char* key) const {
+        for (size_t i = 0; isObject && i < used; i++) {
+            if (pool[i].depth == 1 && strcmp(input + pool[i].key, key) == 0) {
+                return JsonVariantConst(&pool[i], input);
+            }
+        }
+        return JsonVariantConst(nullptr, input);
+    }
+
+    size_t memoryUsage() const { return used * sizeof(host_json::Slot); }
+
+    DeserializationError parse(char* data, size_t length) {
+        input = data;
+        used = 0;
+        isObject = false;
+        host_json::Parser parser(data, length, pool, slotCapacity);
+        DeserializationError::Code err = parser.parse_document(used);
+        isObject = err == DeserializationError::Ok && parser.top_object;
+        if (err != DeserializationError::Ok) {
+            used = 0;
+        }
+        return err;
+    }
+
+private:
+    TAllocator allocator;
+    host_json::Slot* pool = nullptr;
+    size_t slotCapacity = 0;
+    size_t used = 0;
+    char* input = nullptr;
+    bool isObject = false;
+};
+
+template <typename TAllocator>
+DeserializationError deserializeJson(BasicJsonDocument<TAllocator>& doc, uint8_t* input, size_t length) {
+    return doc.parse((char*)input, length);
+}
+
+template <typename TAllocator>
+DeserializationError deserializeJson(BasicJsonDocument<TAllocator>& doc, char* input, size_t length) {
+    return doc.parse(input, length);
+}
+
+#endif // HOST_ARDUINOJSON_SHIM_H
@@ -0,0 +1,18 @@
+/**
+ * FS shim for the host unit: there is no filesystem, so every File is closed and
+ * AssetStore (stubbed in host_unit.cpp) never has an asset to draw.
+ */
+#ifndef HOST_FS_SHIM_H
+#define HOST_FS_SHIM_H
+
+#include <Arduino.h>
+
+class File : public Stream {
+public:
+    explicit operator bool() const { return false; }
+    size_t readBytes(uint8_t*, size_t) override { return 0; }
+    size_t write(const uint8_t*, size_t) { return 0; }
+    void close() {}
+};
+
+#endif // HOST_FS_SHIM_H
@@ -0,0 +1,6 @@
+#ifndef HOST_LITTLEFS_SHIM_H
+#define HOST_LITTLEFS_SHIM_H
+
+#include <FS.h> // See FS.h: no filesystem on the host
+
+#endif // HOST_LITTLEFS_SHIM_H
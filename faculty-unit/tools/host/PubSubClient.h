@@ -0,0 +1,310 @@
+/**
+ * PubSubClient shim for the host unit: MQTT 3.1.1 over a WiFiClient, with the API
+ * subset mqtt_handler.cpp uses and the library's behaviour where the handler relies
+ * on it. connect() waits for the CONNACK, subscribe() does not wait for the SUBACK,
+ * publish() is QoS 0 and refuses packets larger than the buffer, and loop() handles
+ * at most one packet per call: keepalive pings, PUBACK after the callback for QoS 1,
+ * and oversized packets skipped. The callback's topic and payload point into the
+ * packet buffer.
+ */
+#ifndef HOST_PUBSUBCLIENT_SHIM_H
+#define HOST_PUBSUBCLIENT_SHIM_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#define MQTT_KEEPALIVE 15
+#define MQTT_SOCKET_TIMEOUT 15
+
+#define MQTT_CONNECTION_TIMEOUT -4
+#define MQTT_CONNECTION_LOST -3
+#define MQTT_CONNECT_FAILED -2
+#define MQTT_DISCONNECTED -1
+#define MQTT_CONNECTED 0
+
+#define MQTTCONNECT 0x10
+#define MQTTCONNACK 0x20
+#define MQTTPUBLISH 0x30
+#define MQTTPUBACK 0x40
+#define MQTTSUBSCRIBE 0x80
+#define MQTTPINGREQ 0xC0
+#define MQTTPINGRESP 0xD0
+
+class PubSubClient {
+public:
+    typedef void (*Callback)(char* topic, uint8_t* payload, unsigned int length);
+
+    explicit PubSubClient(WiFiClient& client) : net(&client) {
+        setBufferSize(256); // The library default
+    }
+
+    PubSubClient& setServer(const char* domain, uint16_t port) {
+        this->domain = domain;
+        this->port = port;
+        return *this;
+    }
+
+    PubSubClient& setCallback(Callback callback) {
+        this->callback = callback;
+        return *this;
+    }
+
+    bool setBufferSize(uint16_t size) {
+        uint8_t* grown = (uint8_t*)realloc(buffer, size);
+        if (grown == nullptr) {
+            return false;
+        }
+        buffer = grown;
+        bufferSize = size;
+        return true;
+    }
+
+    bool connect(const char* id, const char* user, const char* pass, const char* willTopic, uint8_t willQos,
+                 bool willRetain, const char* willMessage, bool cleanSession) {
+        if (connected()) {
+            return true;
+        }
+        if (!net->connect(domain, port)) {
+            _state = MQTT_CONNECT_FAILED;
+            return false;
+        }
+        size_t len = 0;
+        static const uint8_t header[] = {0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04};
+        memcpy(buffer + 5, header, sizeof(header));
+        len = 5 + sizeof(header);
+        uint8_t flags = cleanSession ? 0x02 : 0x00;
+        if (willTopic != nullptr) {
+            flags |= 0x04 | (willQos << 3) | (willRetain ? 0x20 : 0x00);
+        }
+        flags |= user != nullptr ? 0x80 : 0x00;
+        flags |= user != nullptr && pass != nullptr ? 0x40 : 0x00;
+        buffer[len++] = flags;
+        buffer[len++] = MQTT_KEEPALIVE >> 8;
+        buffer[len++] = MQTT_KEEPALIVE & 0xFF;
+        if (!write_string(id, len) || (willTopic != nullptr && !(write_string(willTopic, len) &&
+                                                                 write_string(willMessage, len))) ||
+            (user != nullptr && !write_string(user, len)) ||
+            (user != nullptr && pass != nullptr && !write_string(pass, len))) {
+            net->stop();
+            _state = MQTT_CONNECT_FAILED;
+            return false;
+        }
+        if (!send_packet(MQTTCONNECT, len - 5)) {
+            _state = MQTT_CONNECT_FAILED;
+            return false;
+        }
+
+        unsigned long start = millis();
+        while (!net->available()) {
+            if (millis() - start >= MQTT_SOCKET_TIMEOUT * 1000UL || !net->connected()) {
+                _state = MQTT_CONNECTION_TIMEOUT;
+                net->stop();
+                return false;
+            }
+            delay(1);
+        }
+        uint8_t type = 0;
+        uint32_t length = read_packet(type);
+        if (length == 4 && type == MQTTCONNACK && buffer[3] == 0) {
+            lastInActivity = lastOutActivity = millis();
+            pingOutstanding = false;
+            _state = MQTT_CONNECTED;
+            return true;
+        }
+        _state = length == 4 ? buffer[3] : MQTT_CONNECT_FAILED;
+        net->stop();
+        return false;
+    }
+
+    bool connected() {
+        if (net->connected()) {
+            return true;
+        }
+        if (_state == MQTT_CONNECTED) {
+            _state = MQTT_CONNECTION_LOST;
+        }
+        return false;
+    }
+
+    int state() const { return _state; }
+
+    bool subscribe(const char* topic, uint8_t qos = 0) {
+        if (qos > 1 || !connected()) {
+            return false;
+        }
+        size_t len = 5;
+        nextMsgId = nextMsgId == 0xFFFF ? 1 : nextMsgId + 1;
+        buffer[len++] = nextMsgId >> 8;
+        buffer[len++] = nextMsgId & 0xFF;
+        if (!write_string(topic, len) || len >= bufferSize) {
+            return false;
+        }
+        buffer[len++] = qos;
+        return send_packet(MQTTSUBSCRIBE | 0x02, len - 5);
+    }
+
+    bool publish(const char* topic, const char* payload, bool retained) {
+        if (!connected()) {
+            return false;
+        }
+        size_t len = 5;
+        size_t payload_len = strlen(payload);
+        if (!write_string(topic, len) || len + payload_len > bufferSize) {
+            return false;
+        }
+        memcpy(buffer + len, payload, payload_len);
+        len += payload_len;
+        return send_packet(MQTTPUBLISH | (retained ? 0x01 : 0x00), len - 5);
+    }
+
+    bool loop() {
+        if (!connected()) {
+            return false;
+        }
+        unsigned long t = millis();
+        if (t - lastInActivity > MQTT_KEEPALIVE * 1000UL || t - lastOutActivity > MQTT_KEEPALIVE * 1000UL) {
+            if (pingOutstanding) {
+                _state = MQTT_CONNECTION_TIMEOUT;
+                net->stop();
+                return false;
+            }
+            buffer[0] = MQTTPINGREQ;
+            buffer[1] = 0;
+            net->write(buffer, 2);
+            lastOutActivity = lastInActivity = t;
+            pingOutstanding = true;
+        }
+        if (net->available()) {
+            uint8_t type = 0;
+            uint32_t length = read_packet(type);
+            lastInActivity = t;
+            if (length > 0 && length <= bufferSize) {
+                handle_packet(type, length);
+            }
+        }
+        return connected();
+    }
+
+private:
+    bool write_string(const char* s, size_t& pos) {
+        size_t n = strlen(s);
+        if (pos + 2 + n > bufferSize) {
+            return false;
+        }
+        buffer[pos++] = n >> 8;
+        buffer[pos++] = n & 0xFF;
+        memcpy(buffer + pos, s, n);
+        pos += n;
+        return true;
+    }
+
+    // The body starts at buffer + 5; the fixed header is packed in right before it
+    bool send_packet(uint8_t header, size_t length) {
+        uint8_t encoded[4];
+        uint8_t digits = 0;
+        size_t rest = length;
+        do {
+            encoded[digits] = rest % 128;
+            rest /= 128;
+            encoded[digits] |= rest > 0 ? 0x80 : 0x00;
+            digits++;
+        } while (rest > 0);
+        uint8_t* start = buffer + 4 - digits;
+        start[0] = header;
+        memcpy(start + 1, encoded, digits);
+        size_t total = 1 + digits + length;
+        lastOutActivity = millis();
+        return net->write(start, total) == total;
+    }
+
+    bool read_byte(uint8_t& b) {
+        unsigned long start = millis();
+        while (!net->available()) {
+            if (millis() - start >= MQTT_SOCKET_TIMEOUT * 1000UL || !net->connected()) {
+                return false;
+            }
+            delay(1);
+        }
+        int c = net->read();
+        b = (uint8_t)c;
+        return c >= 0;
+    }
+
+    /**
+     * @brief Reads one packet into the buffer (fixed header included); a packet too large
+     *        for it is read to the end and discarded.
+     * @return Bytes in the packet, or 0 on error; more than bufferSize if it was discarded.
+     */
+    uint32_t read_packet(uint8_t& type) {
+        uint8_t b;
+        if (!read_byte(b)) {
+            return 0;
+        }
+        buffer[0] = b;
+        type = b & 0xF0;
+        uint32_t remaining = 0, multiplier = 1, pos = 1;
+        do {
+            if (!read_byte(b) || pos > 4) {
+                return 0;
+            }
+            buffer[pos++] = b;
+            remaining += (b & 0x7F) * multiplier;
+            multiplier *= 128;
+        } while (b & 0x80);
+        for (uint32_t i = 0; i < remaining; i++, pos++) {
+            if (!read_byte(b)) {
+                return 0;
+            }
+            if (pos < bufferSize) {
+                buffer[pos] = b;
+            }
+        }
+        return pos;
+    }
+
+    void handle_packet(uint8_t type, uint32_t length) {
+        if (type == MQTTPINGREQ) {
+            buffer[0] = MQTTPINGRESP;
+            buffer[1] = 0;
+            net->write(buffer, 2);
+        } else if (type == MQTTPINGRESP) {
+            pingOutstanding = false;
+        } else if (type == MQTTPUBLISH && callback != nullptr) {
+            uint8_t qos = (buffer[0] >> 1) & 0x03;
+            uint8_t header_len = 2;
+            while (buffer[header_len - 1] & 0x80) {
+                header_len++;
+            }
+            uint16_t topic_len = (buffer[header_len] << 8) | buffer[header_len + 1];
+            // Move the topic down a byte so it can be null-terminated in place
+            memmove(buffer + header_len, buffer + header_len + 2, topic_len);
+            buffer[header_len + topic_len] = '\0';
+            char* topic = (char*)buffer + header_len;
+            uint32_t payload_at = header_len + topic_len + 2;
+            if (qos > 0) {
+                uint16_t msg_id = (buffer[payload_at] << 8) | buffer[payload_at + 1];
+                payload_at += 2;
+                callback(topic, buffer + payload_at, length - payload_at);
+                uint8_t ack[4] = {MQTTPUBACK, 2, (uint8_t)(msg_id >> 8), (uint8_t)(msg_id & 0xFF)};
+                net->write(ack, sizeof(ack));
+                lastOutActivity = millis();
+            } else {
+                callback(topic, buffer + payload_at, length - payload_at);
+            }
+        }
+    }
+
+    WiFiClient* net;
+    const char* domain = nullptr;
+    uint16_t port = 1883;
+    Callback callback = nullptr;
+    uint8_t* buffer = nullptr;
+    uint16_t bufferSize = 0;
+    int _state = MQTT_DISCONNECTED;
+    uint16_t nextMsgId = 0;
+    unsigned long lastInActivity = 0;
+    unsigned long lastOutActivity = 0;
+    bool pingOutstanding = false;
+};
+
+#endif // HOST_PUBSUBCLIENT_SHIM_H
@@ -0,0 +1,6 @@
+#ifndef HOST_SPI_SHIM_H
+#define HOST_SPI_SHIM_H
+
+// Adafruit_ILI9341.h here draws into a framebuffer, so there is no bus
+
+#endif // HOST_SPI_SHIM_H
@@ -0,0 +1,149 @@
+/**
+ * WiFi shim for the host unit: the station is always connected, and WiFiClient is a
+ * TCP socket. config.h's MQTT_BROKER is a placeholder, so connect() goes to
+ * host_network_broker:host_network_port when those are set, whatever name it is given.
+ * The MAC address is host_wifi_mac, so units started side by side get their own client IDs.
+ */
+#ifndef HOST_WIFI_SHIM_H
+#define HOST_WIFI_SHIM_H
+
+#include <Arduino.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <string>
+
+inline const char* host_network_broker = nullptr;
+inline uint16_t host_network_port = 0;
+inline uint8_t host_wifi_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+
+#define WL_CONNECTED 3
+
+struct IPAddress {
+    std::string toString() const { return "127.0.0.1"; }
+};
+
+struct HostWiFi {
+    void begin(const char*, const char*) {}
+    int status() const { return WL_CONNECTED; }
+    IPAddress localIP() const { return {}; }
+    void macAddress(uint8_t* mac) const { memcpy(mac, host_wifi_mac, 6); }
+};
+inline HostWiFi WiFi;
+
+/**
+ * Arduino Client over a blocking TCP socket; reads and writes time out after
+ * timeout_ms, as the ESP32 WiFiClient's do.
+ */
+class WiFiClient {
+public:
+    ~WiFiClient() { stop(); }
+
+    int connect(const char* host, uint16_t port) {
+        stop();
+        char service[8];
+        snprintf(service, sizeof(service), "%u", host_network_port != 0 ? host_network_port : port);
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* found = nullptr;
+        if (getaddrinfo(host_network_broker != nullptr ? host_network_broker : host, service, &hints, &found) != 0) {
+            return 0;
+        }
+        for (addrinfo* ai = found; ai != nullptr && fd < 0; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd >= 0 && ::connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(found);
+        if (fd < 0) {
+            return 0;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // lwIP's default on the board
+        timeval tv = {(time_t)(timeout_ms / 1000), (suseconds_t)(timeout_ms % 1000) * 1000};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        return 1;
+    }
+
+    size_t write(const uint8_t* buf, size_t size) {
+        size_t sent = 0;
+        while (fd >= 0 && sent < size) {
+            ssize_t n = send(fd, buf + sent, size - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                stop();
+                break;
+            }
+            sent += n;
+        }
+        return sent;
+    }
+
+    int available() {
+        int pending = 0;
+        if (fd < 0 || ioctl(fd, FIONREAD, &pending) != 0) {
+            return 0;
+        }
+        if (pending == 0 && peer_closed()) {
+            stop();
+        }
+        return pending;
+    }
+
+    int read() {
+        uint8_t b;
+        return read(&b, 1) == 1 ? b : -1;
+    }
+
+    int read(uint8_t* buf, size_t size) {
+        if (fd < 0) {
+            return -1;
+        }
+        ssize_t n = recv(fd, buf, size, 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            stop();
+        }
+        return n > 0 ? (int)n : -1;
+    }
+
+    uint8_t connected() {
+        if (fd >= 0 && peer_closed()) {
+            stop();
+        }
+        return fd >= 0;
+    }
+
+    void stop() {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    void setTimeout(uint32_t ms) { timeout_ms = ms; }
+
+private:
+    // Readable with nothing to read means the broker closed the connection
+    bool peer_closed() {
+        pollfd p = {fd, POLLIN, 0};
+        if (poll(&p, 1, 0) <= 0) {
+            return false;
+        }
+        uint8_t b;
+        return (p.revents & (POLLHUP | POLLERR)) != 0 || recv(fd, &b, 1, MSG_PEEK | MSG_DONTWAIT) == 0;
+    }
+
+    int fd = -1;
+    uint32_t timeout_ms = 3000;
+};
+
+#endif // HOST_WIFI_SHIM_H
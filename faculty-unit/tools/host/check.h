@@ -0,0 +1,33 @@
+/**
+ * Shared scaffolding for the host tests, simulations and benchmarks in tools/.
+ *
+ * Each tool wraps its body in `#ifndef ARDUINO`, so an embedded build that globs the
+ * sketch tree compiles tools/ to nothing, and includes this header inside the guard.
+ * CHECK() records a failure and carries on, so one run reports every broken case;
+ * check_summary() prints "<name>: OK" or the failure count and returns main()'s exit status.
+ */
+#ifndef HOST_CHECK_H
+#define HOST_CHECK_H
+
+#include <cstdio>
+
+inline int failures = 0;
+
+#define CHECK(cond)                                                        \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);         \
+            failures++;                                                    \
+        }                                                                  \
+    } while (0)
+
+inline int check_summary(const char* name) {
+    if (failures == 0) {
+        printf("%s: OK\n", name);
+    } else {
+        printf("%s: %d failure(s)\n", name, failures);
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+#endif // HOST_CHECK_H
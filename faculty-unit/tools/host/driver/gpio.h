@@ -0,0 +1,10 @@
+#ifndef HOST_GPIO_SHIM_H
+#define HOST_GPIO_SHIM_H
+
+// Pin holds only matter across deep sleep, which the host unit never enters
+typedef int gpio_num_t;
+inline void gpio_hold_en(gpio_num_t) {}
+inline void gpio_hold_dis(gpio_num_t) {}
+inline void gpio_deep_sleep_hold_en() {}
+
+#endif // HOST_GPIO_SHIM_H
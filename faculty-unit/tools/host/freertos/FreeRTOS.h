@@ -0,0 +1,29 @@
+/**
+ * Minimal FreeRTOS shim for the host tests in tools/: one task, so critical sections
+ * are no-ops and nothing ever blocks.
+ */
+#ifndef HOST_FREERTOS_SHIM_H
+#define HOST_FREERTOS_SHIM_H
+
+#include <cstdint>
+
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS 1
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+struct portMUX_TYPE {
+    int unused;
+};
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define taskENTER_CRITICAL(mux) ((void)(mux))
+#define taskEXIT_CRITICAL(mux) ((void)(mux))
+
+#endif // HOST_FREERTOS_SHIM_H
@@ -0,0 +1,47 @@
+#ifndef HOST_FREERTOS_QUEUE_SHIM_H
+#define HOST_FREERTOS_QUEUE_SHIM_H
+
+#include "FreeRTOS.h"
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * Fixed-size copy queue. Storage is allocated once by xQueueCreate(), as on the device.
+ */
+struct HostQueue {
+    uint8_t* items;
+    UBaseType_t item_size;
+    UBaseType_t length;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+typedef HostQueue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    HostQueue* queue = (HostQueue*)calloc(1, sizeof(HostQueue));
+    queue->items = (uint8_t*)calloc(length, item_size);
+    queue->item_size = item_size;
+    queue->length = length;
+    return queue;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t) {
+    if (queue->count == queue->length) {
+        return pdFALSE;
+    }
+    memcpy(queue->items + ((queue->head + queue->count) % queue->length) * queue->item_size, item, queue->item_size);
+    queue->count++;
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t) {
+    if (queue->count == 0) {
+        return pdFALSE;
+    }
+    memcpy(item, queue->items + queue->head * queue->item_size, queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    return pdTRUE;
+}
+
+#endif // HOST_FREERTOS_QUEUE_SHIM_H
@@ -0,0 +1,29 @@
+#ifndef HOST_FREERTOS_TASK_SHIM_H
+#define HOST_FREERTOS_TASK_SHIM_H
+
+#include "FreeRTOS.h"
+#include <chrono>
+#include <thread>
+
+typedef void* TaskHandle_t;
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+    static int loopTask;
+    return &loopTask;
+}
+
+inline void xTaskNotifyGive(TaskHandle_t) {
+}
+
+// Tests advance the host clock themselves, so a sleep returns at once unless a
+// program on the real clock (host_unit.cpp) sets host_task_sleeps
+inline bool host_task_sleeps = false;
+
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t ticks) {
+    if (host_task_sleeps) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+    }
+    return 0;
+}
+
+#endif // HOST_FREERTOS_TASK_SHIM_H
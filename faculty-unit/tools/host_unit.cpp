@@ -0,0 +1,196 @@
+/**
+ * Host build of a faculty unit's request pipeline, for the latency harness
+ * (central-system/utils/latency_harness.py --host-units N).
+ *
+ * Runs the firmware's own comms/mqtt_handler.cpp and display/display_manager.cpp with
+ * the loop of faculty_unit.ino: TimerWheel, the MQTT reconnect coroutine, the request
+ * inbox and rate limiter, the message arena, EventBus dispatch to the same
+ * EVENT_REQUEST_SHOW handler, and the trace record it publishes. The loop sleeps until
+ * the next timer, as loop() does, so requests wait for the MQTT_POLL_MS poll as on the board.
+ *
+ * The board libraries are replaced by the stand-ins in tools/host/. PubSubClient speaks
+ * MQTT 3.1.1 over a TCP socket (WiFi.h), ArduinoJson parses requests in place, and
+ * Adafruit_ILI9341 draws into a framebuffer. There is no filesystem (no assets), no
+ * RTC memory (every start is cold), no BLE and no command batches. Timings are the
+ * host's: parse_us and draw_us show the firmware code's cost on this CPU, not the
+ * ESP32's or the SPI bus's.
+ *
+ * Build and run from faculty-unit/ (config.h's MQTT_BROKER is replaced by --broker/--port):
+ *   g++ -std=c++20 -O2 -Wall -Wextra -Itools/host -Iconfig -Icomms -Icore -Idisplay tools/host_unit.cpp \
+ *       comms/mqtt_handler.cpp comms/rate_limiter.cpp comms/request_inbox.cpp comms/compressed_text.cpp \
+ *       comms/request_bitmaps.cpp core/event_bus.cpp core/timer_wheel.cpp core/coro_scheduler.cpp \
+ *       core/message_arena.cpp display/display_manager.cpp display/qoi_decoder.cpp \
+ *       display/text_bitmap.cpp display/pixel_kernels.cpp -o host_unit
+ *   ./host_unit <faculty_id> [--broker localhost] [--port 1883] [--seconds 0] [--frame out.ppm] [--verbose]
+ *
+ * Runs until SIGINT/SIGTERM (or --seconds), then prints its MQTT counters and fails
+ * unless it connected and every publish went out.
+ */
+#ifndef ARDUINO // See host/check.h
+
+#include "host/check.h"
+#include "../comms/mqtt_handler.h"
+#include "../comms/request_bitmaps.h"
+#include "../core/event_bus.h"
+#include "../core/timer_wheel.h"
+#include "../core/warm_restart.h"
+#include "../core/unit_log.h"
+#include "../display/asset_store.h"
+#include "../display/display_manager.h"
+#include <freertos/task.h> // host_task_sleeps
+#include <csignal>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+extern Adafruit_ILI9341 display;
+
+static volatile std::sig_atomic_t stopRequested = 0;
+static bool verbose = false;
+
+// --- Board services the pipeline calls but the host does not have ------------------
+
+void UnitLog::write(LogSite&, LogLevel level, const char* format, ...) {
+    if (level < ULOG_WARN && !verbose) {
+        return;
+    }
+    static const char* const names[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+    printf("[%s] ", names[level]);
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    putchar('\n');
+}
+
+void WarmRestart::mark_dirty() {
+}
+
+bool AssetStore::begin() {
+    return false;
+}
+
+bool AssetStore::write_chunk(const char*, const byte*, unsigned int) {
+    return false;
+}
+
+File AssetStore::open(const char*) {
+    return File();
+}
+
+// --- faculty_unit.ino's request handler --------------------------------------------
+
+static void onRequestDisplay(const Event& event) {
+    size_t bitmap_len = 0;
+    const uint8_t* bitmap = RequestBitmaps::data(event.request.bitmap, &bitmap_len);
+    unsigned long drawStartMs = millis();
+    unsigned long drawStartUs = micros();
+    DisplayManager::show_request(event.request.student_id, event.request.request_text, bitmap, bitmap_len);
+    publish_request_trace(event.request, drawStartMs, micros() - drawStartUs);
+}
+
+/**
+ * @brief Locally administered MAC from the faculty ID, so each unit has its own client ID.
+ */
+static void derive_mac(const char* faculty_id) {
+    uint32_t hash = 2166136261u; // FNV-1a
+    for (const char* c = faculty_id; *c != '\0'; c++) {
+        hash = (hash ^ (uint8_t)*c) * 16777619u;
+    }
+    for (int i = 0; i < 4; i++) {
+        host_wifi_mac[2 + i] = hash >> (24 - 8 * i);
+    }
+}
+
+static bool write_frame(const char* path) {
+    FILE* out = fopen(path, "wb");
+    if (out == nullptr) {
+        return false;
+    }
+    fprintf(out, "P6\n%d %d\n255\n", SCREEN_WIDTH, SCREEN_HEIGHT);
+    const uint16_t* frame = display.framebuffer();
+    for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++) {
+        uint8_t rgb[3] = {(uint8_t)((frame[i] >> 11) * 255 / 31), (uint8_t)(((frame[i] >> 5) & 0x3F) * 255 / 63),
+                          (uint8_t)((frame[i] & 0x1F) * 255 / 31)};
+        fwrite(rgb, 1, sizeof(rgb), out);
+    }
+    return fclose(out) == 0;
+}
+
+static void on_signal(int) {
+    stopRequested = 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argv[1][0] == '-') {
+        fprintf(stderr, "usage: %s <faculty_id> [--broker host] [--port n] [--seconds s] [--frame out.ppm] "
+                        "[--verbose]\n", argv[0]);
+        return 2;
+    }
+    const char* faculty_id = argv[1];
+    const char* frame_path = nullptr;
+    unsigned long run_ms = 0;
+    host_network_broker = "localhost";
+    host_network_port = MQTT_PORT;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--broker") == 0 && i + 1 < argc) {
+            host_network_broker = argv[++i];
+        } else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            host_network_port = (uint16_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            run_ms = (unsigned long)(atof(argv[++i]) * 1000);
+        } else if (strcmp(argv[i], "--frame") == 0 && i + 1 < argc) {
+            frame_path = argv[++i];
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else {
+            fprintf(stderr, "unknown argument: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    setvbuf(stdout, nullptr, _IOLBF, 0); // Lines reach the harness as they are logged
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    // setup(), faculty role, mains power, no warm state
+    TimerWheel::init();
+    EventBus::setup_bus();
+    EventBus::subscribe(EVENT_REQUEST_SHOW, EVENT_TASK_LOOP, onRequestDisplay);
+    derive_mac(faculty_id);
+    set_faculty_id(faculty_id);
+    setup_wifi();
+    setup_mqtt(nullptr); // No command batches on the host
+    CoScheduler::spawn(mqtt_reconnect_flow());
+    DisplayManager::setup_display();
+    DisplayManager::show_status("Present");
+    host_task_sleeps = true;
+
+    // loop()
+    unsigned long start = millis();
+    while (!stopRequested && (run_ms == 0 || millis() - start < run_ms)) {
+        TimerWheel::advance();
+        mqtt_handler_loop();
+        CoScheduler::run_ready();
+        EventBus::dispatch(EVENT_TASK_LOOP);
+        TimerWheel::sleep_until_next_deadline();
+    }
+
+    // A board never shuts down cleanly; a host unit clears its retained capacity record
+    // so a later harness run on the same broker does not count it
+    char topic[100];
+    snprintf(topic, sizeof(topic), MQTT_CAPACITY_TOPIC_TEMPLATE, faculty_id);
+    publish_message(topic, "", true);
+
+    const MqttStats& stats = mqtt_stats();
+    printf("%s: received %lu, published %lu, publish failures %lu, connects %lu, connect failures %lu, "
+           "last draw %lu us\n", faculty_id, stats.received, stats.published, stats.publish_failures, stats.connects,
+           stats.connect_failures, DisplayManager::last_request_draw_us(false));
+    if (frame_path != nullptr) {
+        CHECK(write_frame(frame_path));
+    }
+    CHECK(stats.connects > 0);
+    CHECK(stats.publish_failures == 0);
+    return check_summary("host_unit");
+}
+
+#endif // ARDUINO
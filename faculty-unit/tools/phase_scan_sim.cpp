@@ -0,0 +1,222 @@
+/**
+ * Host simulation of phase-locked BLE scanning (BLE_PHASE_LOCK, see ble/README.md).
+ *
+ * Runs the real PresenceEstimator against simulated beacons and schedules scan windows
+ * the way bleScanFlow() and BLEScanner::plan_window() do: once the interval is learned,
+ * short windows are centred on predicted adverts. Otherwise, and after
+ * BLE_PHASE_MAX_MISSES missed windows, it falls back to blind BLE_SCAN_DURATION scans.
+ * Every advert gets 0..BLE_ADV_DELAY_MAX_MS of advDelay and is lost with the trace's loss
+ * rate. For each beacon it reports, blind vs phase-locked:
+ *   - radio duty cycle (time listening / time elapsed),
+ *   - detection probability per window (windows that heard the beacon),
+ *   - false departures per day (presence timeouts while the beacon was in range).
+ * A second pass reboots each phase-locked run the way a warm restart does: the estimator
+ * is restored with the learned interval and loss but no phase, and presence is restored
+ * with its remaining timeout.
+ * It exits nonzero unless phase locking cuts radio time at least tenfold for beacons of
+ * 1 s or faster on links losing up to 30%, or if false departures exceed
+ * PRESENCE_FALSE_ABSENCE_TARGET per window, in either mode, or if a restored run opens an
+ * aligned window before its first sighting or departs falsely.
+ *
+ * Build and run from faculty-unit/:
+ *   g++ -std=c++20 -O2 -Wall -Wextra -I.. -Itools/host tools/phase_scan_sim.cpp \
+ *       ble/presence_estimator.cpp -o phase_scan_sim && ./phase_scan_sim [--hours 24]
+ */
+#ifndef ARDUINO // See host/check.h
+
+#include "host/check.h"
+#include "../ble/presence_estimator.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+struct Trace {
+    unsigned long interval_ms;
+    float loss;
+};
+
+struct SimResult {
+    double duty = 0;             // Fraction of time the radio listened
+    double detection = 0;        // Fraction of windows that heard the beacon
+    double false_departures = 0; // Per day
+    unsigned long aligned_windows = 0;
+    unsigned long windows = 0;
+    unsigned long aligned_unanchored = 0; // Aligned windows opened with no advert seen since boot
+    float loss = 0;                       // Estimator loss rate at the end of the run
+};
+
+/**
+ * Same arithmetic as BLEScanner::plan_window(); keep the two in step.
+ */
+static bool plan_window(const PresenceEstimator& estimator, unsigned phase_misses, unsigned long earliest_ms,
+                        unsigned long* open_ms, unsigned long* window_ms) {
+    float interval = estimator.interval_ms();
+    if (interval == 0 || estimator.last_advert() == 0 || phase_misses >= BLE_PHASE_MAX_MISSES) {
+        return false;
+    }
+    unsigned long intervals_ahead = 0;
+    unsigned long predicted = estimator.predict_arrival(earliest_ms, &intervals_ahead);
+    unsigned long half = (unsigned long)(BLE_PHASE_HALF_WINDOW_MS + sqrtf(intervals_ahead) * BLE_ADV_DELAY_MAX_MS)
+                         << phase_misses;
+    if (half > BLE_SCAN_DURATION * 1000UL / 2) {
+        return false;
+    }
+    if (2 * half >= interval + BLE_ADV_DELAY_MAX_MS) {
+        *open_ms = earliest_ms;
+        *window_ms = (unsigned long)interval + BLE_ADV_DELAY_MAX_MS;
+    } else {
+        *open_ms = predicted - half;
+        *window_ms = 2 * half;
+    }
+    return true;
+}
+
+/**
+ * Same choice as BLEScanner::presence_timeout_ms().
+ */
+static unsigned long presence_timeout_ms(const PresenceEstimator& estimator, bool phase_lock, unsigned long window_ms,
+                                         unsigned long period_ms) {
+    if (phase_lock && estimator.interval_ms() > 0) {
+        return estimator.timeout_ms((unsigned long)estimator.interval_ms(), period_ms, true);
+    }
+    return estimator.timeout_ms(window_ms, period_ms, false);
+}
+
+/**
+ * @param warm If set, starts as BLEScanner::restore_presence() leaves a warm restart:
+ *             interval and loss restored from warm, present, with a fresh timeout.
+ * @param learned If set, receives the estimator as the run ends.
+ */
+static SimResult simulate(const Trace& trace, bool phase_lock, double hours, uint32_t seed,
+                          const PresenceEstimator* warm = nullptr, PresenceEstimator* learned = nullptr) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0, 1);
+    PresenceEstimator estimator;
+    SimResult result;
+
+    const unsigned long end_ms = 1000 + (unsigned long)(hours * 3600 * 1000);
+    unsigned long next_advert = 1000 + rng() % trace.interval_ms;
+    unsigned long next_scan_ms = 1000;
+    unsigned long previous_open_ms = 0;
+    unsigned long radio_ms = 0, heard = 0, false_departures = 0;
+    unsigned phase_misses = 0;
+    bool present = false;
+    unsigned long deadline = 0;
+    if (warm) {
+        estimator.restore(warm->interval_ms(), warm->loss_rate());
+        present = true;
+        deadline = 1000 + presence_timeout_ms(*warm, phase_lock, BLE_SCAN_DURATION * 1000UL, BLE_SCAN_INTERVAL_MS);
+    }
+
+    while (next_scan_ms < end_ms) {
+        unsigned long open_ms = next_scan_ms;
+        unsigned long window_ms = BLE_SCAN_DURATION * 1000UL;
+        bool anchored = estimator.last_advert() != 0;
+        bool aligned = phase_lock && plan_window(estimator, phase_misses, next_scan_ms, &open_ms, &window_ms);
+        if (!aligned) {
+            open_ms = next_scan_ms;
+            window_ms = BLE_SCAN_DURATION * 1000UL;
+        }
+        unsigned long close_ms = open_ms + window_ms;
+        unsigned long period_ms = previous_open_ms != 0 ? open_ms - previous_open_ms : BLE_SCAN_INTERVAL_MS;
+        previous_open_ms = open_ms;
+
+        if (present && deadline <= close_ms) {
+            false_departures++; // The beacon never leaves in this simulation
+            present = false;
+        }
+
+        while (next_advert < open_ms) {
+            next_advert += trace.interval_ms + rng() % (BLE_ADV_DELAY_MAX_MS + 1);
+        }
+        bool found = false;
+        while (next_advert < close_ms) {
+            if (unit(rng) >= trace.loss) {
+                estimator.on_advert(next_advert);
+                found = true;
+            }
+            next_advert += trace.interval_ms + rng() % (BLE_ADV_DELAY_MAX_MS + 1);
+        }
+        estimator.end_window(window_ms, present, aligned);
+        radio_ms += window_ms;
+        result.windows++;
+        result.aligned_windows += aligned;
+        result.aligned_unanchored += aligned && !anchored;
+        heard += found;
+
+        if (aligned) {
+            phase_misses = found ? 0 : phase_misses + 1;
+        } else if (found) {
+            phase_misses = 0;
+        }
+        if (found) {
+            present = true;
+            deadline = close_ms + presence_timeout_ms(estimator, phase_lock, window_ms, period_ms);
+        }
+        next_scan_ms = open_ms + BLE_SCAN_INTERVAL_MS;
+    }
+
+    result.duty = (double)radio_ms / (end_ms - 1000);
+    result.detection = (double)heard / result.windows;
+    result.false_departures = false_departures * 24 / hours;
+    result.loss = estimator.loss_rate();
+    if (learned) {
+        *learned = estimator;
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    double hours = 24;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--hours") == 0 && i + 1 < argc) {
+            hours = atof(argv[++i]);
+        }
+    }
+
+    const Trace traces[] = {{100, 0}, {100, 0.3f}, {250, 0.1f}, {500, 0.2f}, {1000, 0},
+                            {1000, 0.3f}, {1000, 0.5f}, {2000, 0.2f}, {4000, 0.2f}};
+    printf("%-16s | %-34s | %-34s | %s\n", "beacon", "blind: duty, detect, false dep/day",
+           "phase-locked: duty, detect, false dep/day", "radio saving");
+    for (const Trace& trace : traces) {
+        SimResult blind = simulate(trace, false, hours, 1);
+        PresenceEstimator learned;
+        SimResult locked = simulate(trace, true, hours, 1, nullptr, &learned);
+        double saving = blind.duty / locked.duty;
+        printf("%5lu ms, %3.0f%% loss | %6.2f%%, %5.1f%%, %6.1f          | %6.2f%%, %5.1f%%, %6.1f (%3.0f%% aligned) | %5.1fx\n",
+               trace.interval_ms, trace.loss * 100, blind.duty * 100, blind.detection * 100, blind.false_departures,
+               locked.duty * 100, locked.detection * 100, locked.false_departures,
+               100.0 * locked.aligned_windows / locked.windows, saving);
+        if (trace.interval_ms <= 1000 && trace.loss <= 0.3f && saving < 10) {
+            printf("FAIL: %lu ms beacon saves only %.1fx radio time\n", trace.interval_ms, saving);
+            failures++;
+        }
+        for (const SimResult* result : {&blind, &locked}) {
+            double allowed = PRESENCE_FALSE_ABSENCE_TARGET * result->windows * 24 / hours + 2; // Slack for short runs
+            if (result->false_departures > allowed) {
+                printf("FAIL: %lu ms beacon departs falsely %.1f times a day (%s)\n", trace.interval_ms,
+                       result->false_departures, result == &blind ? "blind" : "phase-locked");
+                failures++;
+            }
+        }
+    }
+
+    // Warm restart: the restored interval has no phase, so windows stay blind until the
+    // beacon is heard, and the restored presence outlives that first blind scan.
+    printf("\n%-16s | %-12s | %-10s | %s\n", "restored beacon", "unanchored", "false dep", "loss before -> after");
+    for (const Trace& trace : traces) {
+        PresenceEstimator learned;
+        simulate(trace, true, hours, 1, nullptr, &learned);
+        SimResult restored = simulate(trace, true, 1, 2, &learned);
+        printf("%5lu ms, %3.0f%% loss | %12lu | %10.1f | %4.2f -> %4.2f\n", trace.interval_ms, trace.loss * 100,
+               restored.aligned_unanchored, restored.false_departures / 24, learned.loss_rate(), restored.loss);
+        CHECK(restored.aligned_unanchored == 0);
+        CHECK(restored.false_departures == 0);
+        CHECK(restored.loss <= learned.loss_rate() + 0.15f);
+    }
+    return check_summary("phase_scan_sim");
+}
+
+#endif // ARDUINO
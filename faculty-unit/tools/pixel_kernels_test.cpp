@@ -0,0 +1,100 @@
+/**
+ * Host test for the portable PixelKernels (display/pixel_kernels.h).
+ *
+ * Compares fill_span() and swap_bytes() with plain per-pixel loops on 20,000 random
+ * spans: random lengths and odd start offsets on both sides, so the unaligned head,
+ * word-at-a-time middle and tail paths all run, including swap_bytes() in place and
+ * with source and destination misaligned relative to each other. Pixels outside each
+ * span must stay untouched. build_ramp() is checked per channel for random colours.
+ * The ESP32-S3 PIE path cannot run here; PIXEL_KERNELS_BENCH checks it on the board.
+ *
+ * Build and run from faculty-unit/:
+ *   g++ -std=c++20 -O2 -Wall -Wextra -Itools/host tools/pixel_kernels_test.cpp \
+ *       display/pixel_kernels.cpp -o pixel_kernels_test && ./pixel_kernels_test
+ */
+#ifndef ARDUINO // See host/check.h
+
+#include "host/check.h"
+#include "../display/pixel_kernels.h"
+#include <cstdio>
+#include <random>
+
+static const size_t SPAN_MAX = SCREEN_WIDTH + 8;
+static const size_t GUARD = 16; // Sentinel pixels on each side of a span
+
+static uint16_t swapped(uint16_t v) {
+    return (uint16_t)((v << 8) | (v >> 8));
+}
+
+// Per channel, as the ramp is documented: weight round(c * 32 / 15) out of 32, floored
+static uint16_t reference_mix(uint16_t fg, uint16_t bg, uint8_t c) {
+    uint32_t w = (c * 32 + 7) / 15;
+    uint16_t r = (((fg >> 11) & 0x1f) * w + ((bg >> 11) & 0x1f) * (32 - w)) >> 5;
+    uint16_t g = (((fg >> 5) & 0x3f) * w + ((bg >> 5) & 0x3f) * (32 - w)) >> 5;
+    uint16_t b = ((fg & 0x1f) * w + (bg & 0x1f) * (32 - w)) >> 5;
+    return (r << 11) | (g << 5) | b;
+}
+
+static void test_spans(int cases) {
+    std::mt19937 rng(91);
+    alignas(16) static uint16_t src[SPAN_MAX + 2 * GUARD];
+    alignas(16) static uint16_t dst[SPAN_MAX + 2 * GUARD];
+    alignas(16) static uint16_t want[SPAN_MAX + 2 * GUARD];
+
+    for (int n = 0; n < cases && failures < 20; n++) {
+        size_t count = rng() % (SPAN_MAX + 1);
+        size_t src_off = GUARD - 8 + rng() % 8; // Odd and even offsets, 16-byte aligned or not
+        size_t dst_off = GUARD - 8 + rng() % 8;
+        for (size_t i = 0; i < sizeof(src) / sizeof(src[0]); i++) {
+            src[i] = (uint16_t)rng();
+            dst[i] = want[i] = (uint16_t)rng();
+        }
+
+        uint16_t color = (uint16_t)rng();
+        for (size_t i = 0; i < count; i++) {
+            want[dst_off + i] = color;
+        }
+        PixelKernels::fill_span(dst + dst_off, color, count);
+        CHECK(memcmp(dst, want, sizeof(dst)) == 0);
+
+        for (size_t i = 0; i < count; i++) {
+            want[dst_off + i] = swapped(src[src_off + i]);
+        }
+        PixelKernels::swap_bytes(dst + dst_off, src + src_off, count);
+        CHECK(memcmp(dst, want, sizeof(dst)) == 0);
+
+        // In place, as draw_asset() uses it
+        memcpy(want, src, sizeof(src));
+        for (size_t i = 0; i < count; i++) {
+            want[src_off + i] = swapped(src[src_off + i]);
+        }
+        PixelKernels::swap_bytes(src + src_off, src + src_off, count);
+        CHECK(memcmp(src, want, sizeof(src)) == 0);
+    }
+}
+
+static void test_ramp(int cases) {
+    std::mt19937 rng(15);
+    uint16_t ramp[16];
+    PixelKernels::build_ramp(ramp, 0xFFFF, 0x0000);
+    CHECK(ramp[0] == 0x0000 && ramp[15] == 0xFFFF);
+    for (int n = 0; n < cases; n++) {
+        uint16_t fg = (uint16_t)rng(), bg = (uint16_t)rng();
+        PixelKernels::build_ramp(ramp, fg, bg);
+        CHECK(ramp[0] == bg && ramp[15] == fg);
+        for (uint8_t c = 0; c < 16; c++) {
+            CHECK(ramp[c] == reference_mix(fg, bg, c));
+        }
+        if (failures > 20) {
+            return;
+        }
+    }
+}
+
+int main() {
+    test_spans(20000);
+    test_ramp(20000);
+    return check_summary("pixel_kernels_test");
+}
+
+#endif // ARDUINO
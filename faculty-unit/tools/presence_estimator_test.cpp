@@ -0,0 +1,190 @@
+/**
+ * Host test for PresenceEstimator (ble/presence_estimator.h).
+ *
+ * Simulates blind scanning as BLEScanner does it (BLE_SCAN_DURATION windows every
+ * BLE_SCAN_INTERVAL_MS) against beacons with different advertising intervals and loss
+ * rates. Each advertising event gets 0..BLE_ADV_DELAY_MAX_MS of advDelay and, half the
+ * time, a scan response a few ms later. For each trace the test checks the learned
+ * interval and loss, that the timeout stays within its bounds, and that the false-absence
+ * target holds. It then compares false departures (timeouts while the beacon is present)
+ * and departure latency with the fixed PRESENCE_TIMEOUT_MS.
+ *
+ * Build and run from faculty-unit/:
+ *   g++ -std=c++20 -O2 -Wall -Wextra -I.. -Itools/host tools/presence_estimator_test.cpp \
+ *       ble/presence_estimator.cpp -o presence_estimator_test && ./presence_estimator_test
+ */
+#ifndef ARDUINO // See host/check.h
+
+#include "host/check.h"
+#include "../ble/presence_estimator.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+static const unsigned long WINDOW_MS = BLE_SCAN_DURATION * 1000UL;
+static const unsigned long PERIOD_MS = BLE_SCAN_INTERVAL_MS;
+
+struct Trace {
+    unsigned long interval_ms;
+    float loss;
+};
+
+struct RunResult {
+    unsigned long windows = 0;
+    unsigned long false_departures = 0; // Timed out while the beacon was in range
+    double departure_latency_ms = 0;    // From leaving to being declared absent
+    unsigned long timeout_ms = 0;       // Last timeout used
+};
+
+/**
+ * Beacon in range from the start until `depart_ms`, scanned blind. With `learned` false the
+ * fixed PRESENCE_TIMEOUT_MS is used, as before the estimator existed.
+ */
+static RunResult run(const Trace& trace, unsigned long depart_ms, bool learned, uint32_t seed,
+                     PresenceEstimator* out_estimator = nullptr) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0, 1);
+    PresenceEstimator estimator;
+    RunResult result;
+
+    unsigned long next_advert = 1000 + rng() % trace.interval_ms;
+    bool present = false;
+    unsigned long deadline = 0;
+
+    for (unsigned long start = 1000;; start += PERIOD_MS) {
+        unsigned long end = start + WINDOW_MS;
+        if (present && deadline <= end) {
+            // The presence timer fires before this window's sightings are processed
+            if (deadline < depart_ms) {
+                result.false_departures++;
+            } else {
+                result.departure_latency_ms = deadline - depart_ms;
+                break;
+            }
+            present = false;
+        }
+
+        // Adverts that fell before the window were not heard
+        while (next_advert < start) {
+            next_advert += trace.interval_ms + rng() % (BLE_ADV_DELAY_MAX_MS + 1);
+        }
+        bool found = false;
+        while (next_advert < end) {
+            if (next_advert < depart_ms && unit(rng) >= trace.loss) {
+                estimator.on_advert(next_advert);
+                if (rng() % 2) {
+                    estimator.on_advert(next_advert + 3); // Scan response
+                }
+                found = true;
+            }
+            next_advert += trace.interval_ms + rng() % (BLE_ADV_DELAY_MAX_MS + 1);
+        }
+        estimator.end_window(WINDOW_MS, present, false);
+        result.windows++;
+        if (out_estimator != nullptr && end <= depart_ms) {
+            *out_estimator = estimator; // Empty windows after leaving rightly count as loss; keep what came before
+        }
+
+        if (found) {
+            unsigned long timeout = learned ? estimator.timeout_ms(WINDOW_MS, PERIOD_MS) : PRESENCE_TIMEOUT_MS;
+            CHECK(timeout >= PRESENCE_TIMEOUT_MIN_MS && timeout <= PRESENCE_TIMEOUT_MAX_MS);
+            result.timeout_ms = timeout;
+            present = true;
+            deadline = end + timeout;
+        } else if (!present && start > depart_ms) {
+            break; // Never seen at all, or seen again only before leaving
+        }
+    }
+    return result;
+}
+
+static void test_learning() {
+    const Trace traces[] = {{100, 0}, {250, 0.3f}, {1000, 0}, {1000, 0.5f}, {2000, 0.2f}, {10000, 0.1f}};
+    for (const Trace& trace : traces) {
+        PresenceEstimator estimator;
+        run(trace, 3600000, true, 1, &estimator);
+        // Every gap carries on average half of the advDelay
+        float expected = trace.interval_ms + BLE_ADV_DELAY_MAX_MS / 2.0f;
+        CHECK(fabsf(estimator.interval_ms() - expected) < 0.03f * expected + 5);
+        if (WINDOW_MS / trace.interval_ms >= 2) {
+            CHECK(fabsf(estimator.loss_rate() - trace.loss) < 0.1f); // Slower beacons: too few per window
+        }
+    }
+}
+
+static void test_timeout_bounds() {
+    PresenceEstimator estimator;
+    CHECK(estimator.timeout_ms(WINDOW_MS, PERIOD_MS) == PRESENCE_TIMEOUT_MS); // Nothing learned yet
+
+    // Reliable fast beacon: one missed window is already implausible, so the floor applies
+    estimator.restore(100, 0.01f);
+    CHECK(estimator.timeout_ms(50, 1000, true) == PRESENCE_TIMEOUT_MIN_MS);
+    CHECK(estimator.timeout_ms(WINDOW_MS, PERIOD_MS) == 2 * PERIOD_MS);
+
+    // Hopeless link: capped
+    estimator.restore(1000, 0.99f);
+    CHECK(estimator.timeout_ms(WINDOW_MS, PERIOD_MS) == PRESENCE_TIMEOUT_MAX_MS);
+
+    // Aligned windows get one chance each: 0.2^5 < 0.001 < 0.2^4, so five windows plus one period
+    estimator.restore(1000, 0.2f);
+    CHECK(fabsf(estimator.window_miss_probability(50, true) - 0.2f) < 1e-6f);
+    CHECK(estimator.timeout_ms(50, 1000, true) == 6000);
+
+    // Below the cap, the missed windows a timeout allows meet the false-absence target
+    for (float loss = 0.05f; loss < 0.95f; loss += 0.05f) {
+        for (unsigned long interval : {100UL, 500UL, 1000UL, 2500UL}) {
+            estimator.restore(interval, loss);
+            unsigned long timeout = estimator.timeout_ms(WINDOW_MS, PERIOD_MS);
+            CHECK(timeout >= PRESENCE_TIMEOUT_MIN_MS && timeout <= PRESENCE_TIMEOUT_MAX_MS);
+            if (timeout < PRESENCE_TIMEOUT_MAX_MS) {
+                float windows = timeout / PERIOD_MS - 1.0f;
+                CHECK(powf(estimator.window_miss_probability(WINDOW_MS), windows) <= PRESENCE_FALSE_ABSENCE_TARGET);
+            }
+        }
+    }
+}
+
+static void test_against_fixed_timeout() {
+    const unsigned long day_ms = 24UL * 3600 * 1000;
+    const Trace traces[] = {{100, 0.05f}, {500, 0.2f}, {1000, 0.5f}, {1000, 0.7f}, {2000, 0.5f}};
+    for (const Trace& trace : traces) {
+        RunResult fixed, adaptive;
+        double fixed_latency = 0, adaptive_latency = 0;
+        const int departures = 20;
+        for (int i = 0; i < departures; i++) {
+            unsigned long depart = (i == 0 ? day_ms : 600000) + i * 777;
+            RunResult f = run(trace, depart, false, 100 + i);
+            RunResult a = run(trace, depart, true, 100 + i);
+            if (i == 0) {
+                fixed = f;
+                adaptive = a;
+            }
+            fixed_latency += f.departure_latency_ms / departures;
+            adaptive_latency += a.departure_latency_ms / departures;
+        }
+
+        // A day of presence: at most the target rate of false departures, plus some slack
+        CHECK(adaptive.false_departures <= 2 * PRESENCE_FALSE_ABSENCE_TARGET * adaptive.windows + 2);
+        CHECK(adaptive.false_departures <= fixed.false_departures);
+        // Leaving is noticed within the timeout plus the scan that missed it
+        CHECK(adaptive_latency <= PRESENCE_TIMEOUT_MAX_MS + PERIOD_MS);
+        // Reliable beacons are declared absent sooner than with the fixed timeout
+        if (trace.loss <= 0.2f) {
+            CHECK(adaptive_latency < fixed_latency);
+        }
+
+        printf("interval %5lu ms, loss %.2f: false departures/day fixed %4lu, learned %2lu (timeout %5lu ms); "
+               "departure noticed after fixed %5.0f ms, learned %5.0f ms\n",
+               trace.interval_ms, trace.loss, fixed.false_departures, adaptive.false_departures, adaptive.timeout_ms,
+               fixed_latency, adaptive_latency);
+    }
+}
+
+int main() {
+    test_learning();
+    test_timeout_bounds();
+    test_against_fixed_timeout();
+    return check_summary("presence_estimator_test");
+}
+
+#endif // ARDUINO
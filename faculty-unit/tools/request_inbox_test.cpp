@@ -0,0 +1,190 @@
+/**
+ * Host test and benchmark for RequestInbox (comms/request_inbox.h).
+ *
+ * The test drives the inbox with random pushes (priorities 0-2 and 0-255, so both
+ * heavy ties and distinct ranks occur) and pops, and checks every result, overflow
+ * count and snapshot() against a plain sorted-vector model of the documented rules.
+ * The benchmark then times push into a non-full inbox, push that evicts, push that is
+ * rejected, and pop. INBOX_CAPACITY is a build flag, so each size is its own build:
+ *
+ * Build and run from faculty-unit/:
+ *   for n in 8 16 32 64 128 256; do
+ *     g++ -std=c++20 -O2 -Wall -Wextra -DINBOX_CAPACITY=$n -Itools/host -Iconfig -Icomms \
+ *         tools/request_inbox_test.cpp comms/request_inbox.cpp -o request_inbox_test && ./request_inbox_test
+ *   done
+ */
+#ifndef ARDUINO // See host/check.h
+
+#include "host/check.h"
+#include "request_inbox.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+struct ModelEntry {
+    uint8_t priority;
+    uint32_t seq;
+    uint32_t trace_id;
+    uint8_t bitmap;
+};
+
+// Rank order: higher priority first, then older first
+static bool model_outranks(const ModelEntry& a, const ModelEntry& b) {
+    return a.priority != b.priority ? a.priority > b.priority : a.seq < b.seq;
+}
+
+struct Model {
+    std::vector<ModelEntry> entries;
+    uint32_t next_seq = 0;
+    unsigned long overflows = 0;
+
+    bool push(uint8_t priority, uint32_t trace_id, uint8_t bitmap) {
+        if (entries.size() == INBOX_CAPACITY) {
+            auto lowest = std::min_element(entries.begin(), entries.end(),
+                                           [](const ModelEntry& a, const ModelEntry& b) { return model_outranks(b, a); });
+            overflows++;
+            if (priority <= lowest->priority) {
+                return false;
+            }
+            entries.erase(lowest);
+        }
+        entries.push_back({priority, next_seq++, trace_id, bitmap});
+        return true;
+    }
+
+    bool pop(ModelEntry& out) {
+        if (entries.empty()) {
+            return false;
+        }
+        auto best = std::min_element(entries.begin(), entries.end(), model_outranks);
+        out = *best;
+        entries.erase(best);
+        return true;
+    }
+};
+
+static InboxRequest snapshotBuffer[INBOX_CAPACITY];
+
+static void test_against_model(uint32_t seed, int priorities, int operations) {
+    std::mt19937 rng(seed);
+    static RequestInbox inbox; // Large at INBOX_CAPACITY 256; keep it off the stack
+    inbox = RequestInbox();
+    Model model;
+    uint32_t trace_id = 1;
+
+    for (int op = 0; op < operations; op++) {
+        // Bias towards pushes so the inbox spends most of its time full
+        if (rng() % 100 < 60) {
+            uint8_t priority = rng() % priorities;
+            uint8_t bitmap = rng() % 16;
+            char student[16];
+            snprintf(student, sizeof(student), "S%u", (unsigned)trace_id);
+            bool stored = inbox.push(student, "text", priority, op, bitmap, trace_id);
+            CHECK(stored == model.push(priority, trace_id, bitmap));
+            trace_id++;
+        } else {
+            InboxRequest got;
+            ModelEntry want;
+            bool popped = inbox.pop(got);
+            CHECK(popped == model.pop(want));
+            if (popped) {
+                CHECK(got.trace_id == want.trace_id);
+                CHECK(got.priority == want.priority);
+            }
+        }
+        CHECK(inbox.depth() == model.entries.size());
+        CHECK(inbox.free_slots() == INBOX_CAPACITY - model.entries.size());
+        CHECK(inbox.overflow_count() == model.overflows);
+
+        if (op % 97 == 0) {
+            std::vector<ModelEntry> ranked = model.entries;
+            std::sort(ranked.begin(), ranked.end(), model_outranks);
+            uint16_t n = inbox.snapshot(snapshotBuffer, INBOX_CAPACITY);
+            CHECK(n == ranked.size());
+            for (uint16_t i = 0; i < n && i < ranked.size(); i++) {
+                CHECK(snapshotBuffer[i].trace_id == ranked[i].trace_id);
+            }
+            uint8_t bitmap = rng() % 16;
+            bool held = std::any_of(ranked.begin(), ranked.end(), [&](const ModelEntry& e) { return e.bitmap == bitmap; });
+            CHECK(inbox.holds_bitmap(bitmap) == held);
+        }
+        if (failures > 20) {
+            return; // The first failures say enough
+        }
+    }
+}
+
+static void test_truncation() {
+    static RequestInbox inbox;
+    inbox = RequestInbox();
+    char long_text[INBOX_TEXT_LEN * 2];
+    memset(long_text, 'x', sizeof(long_text) - 1);
+    long_text[sizeof(long_text) - 1] = '\0';
+    CHECK(inbox.push("student", long_text, 0, 0));
+    InboxRequest out;
+    CHECK(inbox.pop(out));
+    CHECK(strlen(out.request_text) == INBOX_TEXT_LEN - 1);
+}
+
+template <typename Op>
+static double ns_per_op(int reps, Op op) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; i++) {
+        op(i);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / reps;
+}
+
+static void bench() {
+    static RequestInbox inbox;
+    InboxRequest out;
+    const int reps = 2000000;
+    std::mt19937 rng(7);
+    std::vector<uint8_t> priorities(reps);
+    for (auto& p : priorities) {
+        p = rng() % 3;
+    }
+
+    // Push into a non-full inbox, each followed by a pop to keep it half full
+    inbox = RequestInbox();
+    for (int i = 0; i < INBOX_CAPACITY / 2; i++) {
+        inbox.push("S", "text", priorities[i], 0);
+    }
+    double push_pop = ns_per_op(reps, [&](int i) {
+        inbox.push("S", "text", priorities[i], i);
+        inbox.pop(out);
+    });
+
+    // Full inbox of priority-0 requests: priority-1 pushes evict (then a pop and a refill keep it full)
+    inbox = RequestInbox();
+    for (int i = 0; i < INBOX_CAPACITY; i++) {
+        inbox.push("S", "text", 0, 0);
+    }
+    double evict = ns_per_op(reps, [&](int i) {
+        inbox.push("S", "text", 1, i); // Evicts the newest priority-0 request
+        inbox.pop(out);                // Removes it again
+        inbox.push("S", "text", 0, i); // Refill
+    });
+
+    // Full inbox: equal-priority pushes are rejected after one comparison with the lowest entry
+    double reject = ns_per_op(reps, [&](int i) { inbox.push("S", "text", 0, i); });
+
+    printf("INBOX_CAPACITY %3d: push+pop %6.1f ns, evict+pop+push %6.1f ns, rejected push %5.1f ns\n",
+           INBOX_CAPACITY, push_pop, evict, reject);
+}
+
+int main() {
+    for (uint32_t seed = 1; seed <= 20; seed++) {
+        test_against_model(seed, 3, 20000);
+        test_against_model(seed + 1000, 256, 20000);
+    }
+    test_truncation();
+    if (failures == 0) {
+        bench();
+    }
+    return check_summary("request_inbox_test");
+}
+
+#endif // ARDUINO
@@ -0,0 +1,179 @@
+/**
+ * Host benchmark for the LAN status multicast channel.
+ *
+ * A sender thread encodes StatusDatagrams for a number of simulated units with the
+ * unit's codec and sends them to the multicast group; the main thread receives them
+ * through StatusReceiver, the same library a directory board uses. Reports datagrams
+ * per second, loss/staleness as seen by the receiver and send-to-receive latency
+ * (both ends share one clock here, so latency is exact).
+ *
+ * Build and run from faculty-unit/ (Linux or macOS):
+ *   g++ -std=c++17 -O2 -pthread -Iconfig -Icomms tools/status_multicast_bench.cpp \
+ *       comms/status_datagram.cpp comms/status_receiver.cpp -o status_multicast_bench
+ *   ./status_multicast_bench --count 200000 --units 50 [--rate 5000] [--iface 192.168.1.20]
+ *
+ * Run a second copy with --receive-only on another host to measure across the LAN.
+ */
+#ifndef ARDUINO // See host/check.h
+
+#include "status_datagram.h"
+#include "status_receiver.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static uint32_t now_us() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct Options {
+    unsigned long count = 100000;
+    unsigned units = 20;
+    unsigned long rate = 0; // Datagrams per second, 0 = as fast as possible
+    const char* iface = nullptr;
+    bool receive_only = false;
+    double idle_s = 1.0;    // Stop receiving after this long without traffic
+};
+
+static void send_datagrams(const Options& opt, std::atomic<bool>& done, double& elapsed_s) {
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    uint8_t ttl = STATUS_MULTICAST_TTL;
+    uint8_t loop = 1;
+    setsockopt(sock, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    if (opt.iface != nullptr) {
+        in_addr iface = {};
+        iface.s_addr = inet_addr(opt.iface);
+        setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF, &iface, sizeof(iface));
+    }
+    sockaddr_in group = {};
+    group.sin_family = AF_INET;
+    group.sin_port = htons(STATUS_MULTICAST_PORT);
+    group.sin_addr.s_addr = inet_addr(STATUS_MULTICAST_GROUP);
+
+    std::vector<StatusDatagram> units(opt.units);
+    for (unsigned i = 0; i < opt.units; i++) {
+        units[i] = {};
+        snprintf(units[i].faculty_id, sizeof(units[i].faculty_id), "bench_unit_%03u", i);
+        units[i].epoch = (uint16_t)rand();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint8_t buf[STATUS_DATAGRAM_MAX_LEN];
+    for (unsigned long n = 0; n < opt.count; n++) {
+        if (opt.rate > 0) {
+            auto due = start + std::chrono::microseconds(n * 1000000 / opt.rate);
+            std::this_thread::sleep_until(due);
+        }
+        StatusDatagram& unit = units[n % opt.units];
+        unit.seq++;
+        unit.present = (n / opt.units) % 2;
+        unit.status = (uint8_t)((n / opt.units) % 4);
+        unit.depth = (uint8_t)(n % 9);
+        unit.sent_us = now_us();
+        size_t len = status_datagram_encode(unit, buf, sizeof(buf));
+        while (sendto(sock, buf, len, 0, (sockaddr*)&group, sizeof(group)) < 0) {
+            std::this_thread::yield(); // Socket buffer full: back off rather than drop at the sender
+        }
+    }
+    elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    close(sock);
+    done = true;
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--count") && i + 1 < argc) opt.count = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--units") && i + 1 < argc) opt.units = (unsigned)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--rate") && i + 1 < argc) opt.rate = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--iface") && i + 1 < argc) opt.iface = argv[++i];
+        else if (!strcmp(argv[i], "--receive-only")) opt.receive_only = true;
+        else {
+            fprintf(stderr, "Usage: %s [--count N] [--units N] [--rate N] [--iface IP] [--receive-only]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (opt.units == 0) {
+        opt.units = 1;
+    }
+
+    StatusReceiver receiver;
+    if (!receiver.begin(STATUS_MULTICAST_GROUP, STATUS_MULTICAST_PORT, opt.iface)) {
+        perror("Joining " STATUS_MULTICAST_GROUP);
+        return 1;
+    }
+    // Room for bursts while the receiver is descheduled
+    int rcvbuf = 4 << 20;
+    setsockopt(receiver.fd(), SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    std::atomic<bool> done(opt.receive_only);
+    double send_s = 0;
+    std::thread sender;
+    if (!opt.receive_only) {
+        sender = std::thread(send_datagrams, std::cref(opt), std::ref(done), std::ref(send_s));
+    }
+
+    std::vector<uint32_t> latencies;
+    latencies.reserve(opt.count);
+    auto first = std::chrono::steady_clock::time_point();
+    auto last = first;
+    auto idle_since = std::chrono::steady_clock::now();
+    StatusDatagram datagram;
+    for (;;) {
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(receiver.fd(), &fds);
+        timeval tv = {0, 100000};
+        select(receiver.fd() + 1, &fds, nullptr, nullptr, &tv);
+        bool got = false;
+        while (receiver.poll(datagram)) {
+            uint32_t t = now_us();
+            latencies.push_back(t - datagram.sent_us);
+            last = std::chrono::steady_clock::now();
+            if (first == std::chrono::steady_clock::time_point()) {
+                first = last;
+            }
+            got = true;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (got) {
+            idle_since = now;
+        } else if (done && std::chrono::duration<double>(now - idle_since).count() > opt.idle_s) {
+            break;
+        }
+    }
+    if (sender.joinable()) {
+        sender.join();
+    }
+
+    const StatusReceiverStats& stats = receiver.stats();
+    if (!opt.receive_only) {
+        printf("sent:     %lu datagrams in %.3f s (%.0f/s)\n", opt.count, send_s, opt.count / send_s);
+    }
+    double recv_s = std::chrono::duration<double>(last - first).count();
+    printf("received: %lu (accepted %lu, lost %lu, stale %lu, malformed %lu)", stats.received, stats.accepted,
+           stats.lost, stats.stale, stats.malformed);
+    printf(recv_s > 0 ? ", %.0f/s\n" : "\n", stats.accepted / recv_s);
+    if (!latencies.empty() && !opt.receive_only) {
+        std::sort(latencies.begin(), latencies.end());
+        auto pct = [&](double p) { return latencies[std::min(latencies.size() - 1, (size_t)(p * latencies.size()))]; };
+        printf("latency:  p50 %u us, p99 %u us, p99.9 %u us, max %u us\n", pct(0.50), pct(0.99), pct(0.999),
+               latencies.back());
+    }
+    receiver.end();
+    return 0;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,210 @@
+/**
+ * Host test and benchmark for TextBitmapDecoder (display/text_bitmap.h).
+ *
+ * The vectors were produced by central-system/comms/text_raster.py (encode()), so they
+ * also check that both ends agree on the format: 1 and 2 bits per pixel, runs that
+ * continue onto the next row, and runs of the maximum length. A local mirror of
+ * encode() must reproduce them byte for byte before it is used for random round trips.
+ * Bitmaps whose runs cover too few or too many pixels, bad headers and bitmaps larger
+ * than the panel must be rejected by begin(), before any row is drawn.
+ * The benchmark decodes a text-like 2-bit bitmap row by row, as draw_text_bitmap() does;
+ * the SPI transfer to the panel is not part of it.
+ *
+ * Build and run from faculty-unit/:
+ *   g++ -std=c++20 -O2 -Wall -Wextra -Itools/host tools/text_bitmap_test.cpp \
+ *       display/text_bitmap.cpp display/pixel_kernels.cpp -o text_bitmap_test && ./text_bitmap_test
+ */
+#ifndef ARDUINO // See host/check.h
+
+#include "host/check.h"
+#include "../display/text_bitmap.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// text_raster.encode(p, 10, 3, 1), p[i] = 1 for 5 <= i < 30: one run spans all three rows
+static const uint8_t ROWS_1BPP[] = {0x01, 0x0A, 0x00, 0x03, 0x00, 0x04, 0x98};
+static int rows_1bpp(int i) { return i >= 5 && i < 30; }
+
+// text_raster.encode(p, 240, 2, 2): a 72-pixel run (split at 64), short runs, a run
+// from 170 across the row boundary to 300, then alternating runs to the end
+static const uint8_t ROWS_2BPP[] = {
+    0x02, 0xF0, 0x00, 0x02, 0x00, 0xFF, 0xC7, 0x02, 0x42, 0x82, 0xC2, 0x02, 0x42, 0x82, 0xC2, 0x02, 0x42,
+    0x82, 0xC2, 0x02, 0x42, 0x82, 0xC2, 0x02, 0x42, 0x82, 0xC2, 0x02, 0x42, 0x82, 0xC2, 0x02, 0x42, 0x82,
+    0xC2, 0x02, 0x42, 0x82, 0xC2, 0x3F, 0x3F, 0x03, 0x40, 0x82, 0x43, 0x82, 0x43, 0x82, 0x43, 0x82, 0x43,
+    0x82, 0x43, 0x82, 0x43, 0x82, 0x43, 0x82, 0x43, 0x82, 0x43, 0x82, 0x43, 0x82, 0x43, 0x82, 0x43, 0x82,
+    0x43, 0x82, 0x43, 0x82, 0x43, 0x82, 0x43, 0x82, 0x43, 0x82, 0x43, 0x82, 0x43, 0x82, 0x43, 0x82, 0x43,
+    0x82, 0x43, 0x82, 0x43, 0x82, 0x43, 0x82, 0x43, 0x82, 0x40};
+static int rows_2bpp(int i) {
+    if (i < 70) return 3;
+    if (i < 170) return (i / 3) % 4;
+    if (i < 300) return 0;
+    return i % 7 < 3 ? 2 : 1;
+}
+
+// text_raster.encode([0] * 240, 240, 1, 1): runs of 128 and 112
+static const uint8_t MAX_RUN_1BPP[] = {0x01, 0xF0, 0x00, 0x01, 0x00, 0x7F, 0x6F};
+static int max_run_1bpp(int) { return 0; }
+
+/**
+ * Same runs as text_raster.encode(); keep the two in step.
+ */
+static std::vector<uint8_t> encode(const std::vector<int>& pixels, uint16_t width, uint16_t height, uint8_t bpp) {
+    const int shift = 8 - bpp;
+    const size_t max_run = 1u << shift;
+    std::vector<uint8_t> out = {bpp, (uint8_t)width, (uint8_t)(width >> 8), (uint8_t)height, (uint8_t)(height >> 8)};
+    for (size_t i = 0; i < pixels.size();) {
+        size_t n = 1;
+        while (i + n < pixels.size() && n < max_run && pixels[i + n] == pixels[i]) {
+            n++;
+        }
+        out.push_back((uint8_t)((pixels[i] << shift) | (n - 1)));
+        i += n;
+    }
+    return out;
+}
+
+// Level i in the low bits, so a decoded row reads back as levels
+static const uint16_t PALETTE[4] = {0xA000, 0xA001, 0xA002, 0xA003};
+
+/**
+ * Decodes every row and compares it with `expected`; checks that the decoder stops after
+ * the last row and leaves pixels past the width alone.
+ */
+static bool decodes_to(const uint8_t* data, size_t len, const std::vector<int>& expected) {
+    TextBitmapDecoder bmp;
+    if (!bmp.begin(data, len)) {
+        return false;
+    }
+    uint16_t row[SCREEN_WIDTH + 1];
+    bool ok = (size_t)bmp.width() * bmp.height() == expected.size();
+    for (uint16_t y = 0; ok && y < bmp.height(); y++) {
+        row[bmp.width()] = 0x5555;
+        ok = bmp.read_row(row, PALETTE) && row[bmp.width()] == 0x5555;
+        for (uint16_t x = 0; ok && x < bmp.width(); x++) {
+            ok = row[x] == PALETTE[expected[(size_t)y * bmp.width() + x]];
+        }
+    }
+    return ok && !bmp.read_row(row, PALETTE);
+}
+
+static std::vector<int> pattern(int (*level)(int), size_t count) {
+    std::vector<int> pixels(count);
+    for (size_t i = 0; i < count; i++) {
+        pixels[i] = level((int)i);
+    }
+    return pixels;
+}
+
+static void test_vectors() {
+    struct Vector {
+        const uint8_t* data;
+        size_t len;
+        int (*level)(int);
+    };
+    const Vector vectors[] = {{ROWS_1BPP, sizeof(ROWS_1BPP), rows_1bpp},
+                              {ROWS_2BPP, sizeof(ROWS_2BPP), rows_2bpp},
+                              {MAX_RUN_1BPP, sizeof(MAX_RUN_1BPP), max_run_1bpp}};
+    for (const Vector& v : vectors) {
+        uint16_t width = v.data[1] | (v.data[2] << 8);
+        uint16_t height = v.data[3] | (v.data[4] << 8);
+        std::vector<int> pixels = pattern(v.level, (size_t)width * height);
+        CHECK(decodes_to(v.data, v.len, pixels));
+        CHECK(encode(pixels, width, height, v.data[0]) == std::vector<uint8_t>(v.data, v.data + v.len));
+    }
+}
+
+static void test_rejects() {
+    TextBitmapDecoder bmp;
+    std::vector<uint8_t> data(ROWS_2BPP, ROWS_2BPP + sizeof(ROWS_2BPP));
+
+    // Run totals one pixel short and one pixel long, and one run missing or extra
+    std::vector<uint8_t> bad = data;
+    bad.back()--;
+    CHECK(!bmp.begin(bad.data(), bad.size()));
+    bad = data;
+    bad.back()++;
+    CHECK(!bmp.begin(bad.data(), bad.size()));
+    CHECK(!bmp.begin(data.data(), data.size() - 1));
+    bad = data;
+    bad.push_back(0x00);
+    CHECK(!bmp.begin(bad.data(), bad.size()));
+
+    // Headers: bits per pixel, empty and oversized dimensions, truncated header
+    const uint8_t bad_bpp[] = {0x03, 0x01, 0x00, 0x01, 0x00, 0x00};
+    const uint8_t zero_width[] = {0x01, 0x00, 0x00, 0x01, 0x00};
+    const uint8_t too_wide[] = {0x01, (SCREEN_WIDTH + 1) & 0xFF, (SCREEN_WIDTH + 1) >> 8, 0x01, 0x00, 0x7F, 0x7F};
+    const uint8_t too_tall[] = {0x01, 0x01, 0x00, (SCREEN_HEIGHT + 1) & 0xFF, (SCREEN_HEIGHT + 1) >> 8};
+    CHECK(!bmp.begin(bad_bpp, sizeof(bad_bpp)));
+    CHECK(!bmp.begin(zero_width, sizeof(zero_width)));
+    CHECK(!bmp.begin(too_wide, sizeof(too_wide)));
+    CHECK(!bmp.begin(too_tall, sizeof(too_tall)));
+    CHECK(!bmp.begin(ROWS_1BPP, 4));
+    CHECK(!bmp.begin(nullptr, 0));
+
+    // A rejected bitmap leaves nothing to draw
+    uint16_t row[SCREEN_WIDTH];
+    TextBitmapDecoder fresh;
+    CHECK(!fresh.begin(bad.data(), bad.size()));
+    CHECK(!fresh.read_row(row, PALETTE));
+}
+
+static void test_random_round_trips() {
+    std::mt19937 rng(7);
+    for (int trial = 0; trial < 2000; trial++) {
+        uint8_t bpp = 1 + rng() % 2;
+        uint16_t width = 1 + rng() % SCREEN_WIDTH;
+        uint16_t height = 1 + rng() % 12;
+        // Mostly background with short strokes, like rendered text, plus some long runs
+        std::vector<int> pixels((size_t)width * height);
+        int level = 0;
+        for (int& p : pixels) {
+            if (rng() % 8 == 0) {
+                level = rng() % (1 << bpp);
+            }
+            p = level;
+        }
+        std::vector<uint8_t> data = encode(pixels, width, height, bpp);
+        CHECK(decodes_to(data.data(), data.size(), pixels));
+    }
+}
+
+static void bench_decode() {
+    // Two lines of 2-bit "glyph" strokes on a 240 x 32 area, within REQUEST_BITMAP_MAX_BYTES
+    const uint16_t width = SCREEN_WIDTH, height = 32;
+    std::vector<int> pixels((size_t)width * height);
+    for (uint16_t y = 0; y < height; y++) {
+        for (uint16_t x = 0; x < width; x++) {
+            int band = y % 16, col = x % 24;
+            pixels[(size_t)y * width + x] = band >= 4 && band < 12 ? (col < 2 ? 3 : col == 2 ? 1 : 0) : 0;
+        }
+    }
+    std::vector<uint8_t> data = encode(pixels, width, height, 2);
+    CHECK(data.size() <= REQUEST_BITMAP_MAX_BYTES);
+
+    uint16_t row[SCREEN_WIDTH];
+    const int rounds = 20000;
+    unsigned checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        TextBitmapDecoder bmp;
+        bmp.begin(data.data(), data.size());
+        while (bmp.read_row(row, PALETTE)) {
+            checksum += row[i % width];
+        }
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+    printf("decode %ux%u 2-bit bitmap (%zu bytes): %.2f us per bitmap, %.1f ns per row (checksum %u)\n", width,
+           height, data.size(), us, us * 1000 / height, checksum);
+}
+
+int main() {
+    test_vectors();
+    test_rejects();
+    test_random_round_trips();
+    bench_decode();
+    return check_summary("text_bitmap_test");
+}
+
+#endif // ARDUINO